@@ -106,6 +106,16 @@ public:
      */
     virtual void markHostUnreachable(const HostAndPort& host, const Status& status) = 0;
 
+    /**
+     * Reports to the targeter that a request was sent to 'host', or that a response to one has
+     * been received, so that it can prefer less loaded hosts when several are eligible. Each call
+     * to markHostRequestStarted must be paired with one call to markHostRequestFinished.
+     *
+     * Targeters with a single host to choose from don't need to track this.
+     */
+    virtual void markHostRequestStarted(const HostAndPort& host) {}
+    virtual void markHostRequestFinished(const HostAndPort& host) {}
+
 protected:
     RemoteCommandTargeter() = default;
 };
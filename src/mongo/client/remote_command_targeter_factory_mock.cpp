@@ -65,6 +65,14 @@ public:
         _mock->markHostUnreachable(host, status);
     }
 
+    void markHostRequestStarted(const HostAndPort& host) override {
+        _mock->markHostRequestStarted(host);
+    }
+
+    void markHostRequestFinished(const HostAndPort& host) override {
+        _mock->markHostRequestFinished(host);
+    }
+
 private:
     const std::shared_ptr<RemoteCommandTargeter> _mock;
 };
@@ -54,11 +54,14 @@ ConnectionString RemoteCommandTargeterMock::connectionString() {
 
 StatusWith<HostAndPort> RemoteCommandTargeterMock::findHost(OperationContext* opCtx,
                                                             const ReadPreferenceSetting& readPref) {
-    return _findHostReturnValue;
+    return findHostWithMaxWait(readPref, Milliseconds::zero());
 }
 
 StatusWith<HostAndPort> RemoteCommandTargeterMock::findHostWithMaxWait(
     const ReadPreferenceSetting& readPref, Milliseconds maxTime) {
+    if (!_findHostsReturnValue.empty()) {
+        return _findHostsReturnValue[_nextFindHostsReturnValue++ % _findHostsReturnValue.size()];
+    }
 
     return _findHostReturnValue;
 }
@@ -68,12 +71,34 @@ void RemoteCommandTargeterMock::markHostNotMaster(const HostAndPort& host, const
 void RemoteCommandTargeterMock::markHostUnreachable(const HostAndPort& host, const Status& status) {
 }
 
+void RemoteCommandTargeterMock::markHostRequestStarted(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_numOutstandingRequests[host];
+}
+
+void RemoteCommandTargeterMock::markHostRequestFinished(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    --_numOutstandingRequests[host];
+}
+
+int RemoteCommandTargeterMock::getNumOutstandingRequests(const HostAndPort& host) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _numOutstandingRequests.find(host);
+    return it == _numOutstandingRequests.end() ? 0 : it->second;
+}
+
 void RemoteCommandTargeterMock::setConnectionStringReturnValue(const ConnectionString returnValue) {
     _connectionStringReturnValue = std::move(returnValue);
 }
 
 void RemoteCommandTargeterMock::setFindHostReturnValue(StatusWith<HostAndPort> returnValue) {
     _findHostReturnValue = std::move(returnValue);
+    _findHostsReturnValue.clear();
+}
+
+void RemoteCommandTargeterMock::setFindHostsReturnValue(std::vector<HostAndPort> returnValue) {
+    _findHostsReturnValue = std::move(returnValue);
+    _nextFindHostsReturnValue = 0;
 }
 
 }  // namespace mongo
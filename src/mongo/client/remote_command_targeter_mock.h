@@ -28,8 +28,12 @@
 
 #pragma once
 
+#include <map>
+#include <vector>
+
 #include "mongo/client/connection_string.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -51,8 +55,9 @@ public:
     ConnectionString connectionString() override;
 
     /**
-     * Returns the return value last set by setFindHostReturnValue.
-     * Returns ErrorCodes::InternalError if setFindHostReturnValue was never called.
+     * Returns the return value last set by setFindHostReturnValue, or the next of the hosts last
+     * set by setFindHostsReturnValue.
+     * Returns ErrorCodes::InternalError if neither was ever called.
      */
     StatusWith<HostAndPort> findHostWithMaxWait(const ReadPreferenceSetting& readPref,
                                                 Milliseconds maxWait) override;
@@ -70,6 +75,12 @@ public:
      */
     void markHostUnreachable(const HostAndPort& host, const Status& status) override;
 
+    /**
+     * Counts the requests outstanding to each host, see getNumOutstandingRequests.
+     */
+    void markHostRequestStarted(const HostAndPort& host) override;
+    void markHostRequestFinished(const HostAndPort& host) override;
+
     /**
      * Sets the return value for the next call to connectionString.
      */
@@ -80,9 +91,28 @@ public:
      */
     void setFindHostReturnValue(StatusWith<HostAndPort> returnValue);
 
+    /**
+     * Sets the hosts, which the next calls to findHost return in turn, starting over after the
+     * last one.
+     */
+    void setFindHostsReturnValue(std::vector<HostAndPort> returnValue);
+
+    /**
+     * Returns the number of requests to 'host', which were marked as started but not yet as
+     * finished.
+     */
+    int getNumOutstandingRequests(const HostAndPort& host) const;
+
 private:
     ConnectionString _connectionStringReturnValue;
     StatusWith<HostAndPort> _findHostReturnValue;
+
+    std::vector<HostAndPort> _findHostsReturnValue;
+    size_t _nextFindHostsReturnValue = 0;
+
+    // Request counts may be updated from the threads of a task executor.
+    mutable stdx::mutex _mutex;
+    std::map<HostAndPort, int> _numOutstandingRequests;
 };
 
 }  // namespace mongo
@@ -100,4 +100,16 @@ void RemoteCommandTargeterRS::markHostUnreachable(const HostAndPort& host, const
     _rsMonitor->failedHost(host, status);
 }
 
+void RemoteCommandTargeterRS::markHostRequestStarted(const HostAndPort& host) {
+    invariant(_rsMonitor);
+
+    _rsMonitor->markRequestStarted(host);
+}
+
+void RemoteCommandTargeterRS::markHostRequestFinished(const HostAndPort& host) {
+    invariant(_rsMonitor);
+
+    _rsMonitor->markRequestFinished(host);
+}
+
 }  // namespace mongo
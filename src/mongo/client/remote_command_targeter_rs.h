@@ -62,6 +62,10 @@ public:
 
     void markHostUnreachable(const HostAndPort& host, const Status& status) override;
 
+    void markHostRequestStarted(const HostAndPort& host) override;
+
+    void markHostRequestFinished(const HostAndPort& host) override;
+
 private:
     // Name of the replica set which this targeter maintains
     const std::string _rsName;
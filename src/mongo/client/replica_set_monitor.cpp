@@ -89,6 +89,16 @@ const int64_t unknownLatency = numeric_limits<int64_t>::max();
 const ReadPreferenceSetting kPrimaryOnlyReadPreference(ReadPreference::PrimaryOnly, TagSet());
 const Milliseconds kFindHostMaxBackOffTime(500);
 
+// An isMaster round trip which took longer than both kLatencyOutlierFactor times the smoothed
+// latency and the smoothed latency plus kLatencyOutlierMinMicros is treated as an outlier and
+// clamped to that bound before being folded into the moving average.
+const int64_t kLatencyOutlierFactor = 4;
+const int64_t kLatencyOutlierMinMicros = 5 * 1000;
+
+// Upper bound on the number of extra threads contacting the hosts of a single set during a
+// periodic refresh.
+const size_t kMaxConcurrentRefreshParticipants = 7;
+
 // TODO: Move to ReplicaSetMonitorManager
 ReplicaSetMonitor::ConfigChangeHook asyncConfigChangeHook;
 ReplicaSetMonitor::ConfigChangeHook syncConfigChangeHook;
@@ -173,10 +183,13 @@ bool ReplicaSetMonitor::useDeterministicHostSelection = false;
 
 ReplicaSetMonitor::ReplicaSetMonitor(StringData name, const std::set<HostAndPort>& seeds)
     : _state(std::make_shared<SetState>(name, seeds)),
-      _executor(globalRSMonitorManager.getExecutor()) {}
+      _executor(globalRSMonitorManager.getExecutor()),
+      _refreshPool(globalRSMonitorManager.getRefreshThreadPool()) {}
 
 ReplicaSetMonitor::ReplicaSetMonitor(const MongoURI& uri)
-    : _state(std::make_shared<SetState>(uri)), _executor(globalRSMonitorManager.getExecutor()) {}
+    : _state(std::make_shared<SetState>(uri)),
+      _executor(globalRSMonitorManager.getExecutor()),
+      _refreshPool(globalRSMonitorManager.getRefreshThreadPool()) {}
 
 void ReplicaSetMonitor::init() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
@@ -225,7 +238,23 @@ void ReplicaSetMonitor::_refresh(const CallbackArgs& cbArgs) {
     }
 
     Timer t;
-    startOrContinueRefresh().refreshAll();
+    {
+        Refresher refresher(startOrContinueRefresh());
+
+        ScanStatePtr scan;
+        size_t numParticipants = 0;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+            scan = _state->currentScan;
+            if (scan && !scan->hostsToScan.empty()) {
+                numParticipants = std::min(scan->hostsToScan.size() - 1,
+                                           kMaxConcurrentRefreshParticipants);
+            }
+        }
+        _scheduleConcurrentRefresh(scan, numParticipants);
+
+        refresher.refreshAll();
+    }
     LOG(1) << "Refreshing replica set " << getName() << " took " << t.millis() << " msec";
     {
         // reschedule itself
@@ -309,6 +338,40 @@ HostAndPort ReplicaSetMonitor::getMasterOrUassert() {
     return uassertStatusOK(getHostOrRefresh(kPrimaryOnlyReadPreference));
 }
 
+void ReplicaSetMonitor::_scheduleConcurrentRefresh(const ScanStatePtr& scan,
+                                                   size_t numParticipants) {
+    if (!_refreshPool) {
+        return;
+    }
+
+    std::weak_ptr<ReplicaSetMonitor> that(shared_from_this());
+    for (size_t i = 0; i < numParticipants; ++i) {
+        auto status = _refreshPool->schedule([that, scan] {
+            auto ptr = that.lock();
+            if (!ptr) {
+                return;
+            }
+
+            stdx::unique_lock<stdx::mutex> lk(ptr->_state->mutex);
+            // Don't start a new scan if this one has already finished.
+            if (ptr->_state->currentScan != scan) {
+                return;
+            }
+            Refresher refresher(ptr->_state);
+            lk.unlock();
+
+            refresher.refreshAll();
+        });
+
+        if (!status.isOK()) {
+            // The remaining hosts are still contacted by the participant running on the executor.
+            LOG(1) << "Couldn't schedule concurrent refresh of replica set " << getName()
+                   << causedBy(redact(status));
+            return;
+        }
+    }
+}
+
 Refresher ReplicaSetMonitor::startOrContinueRefresh() {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
 
@@ -325,6 +388,20 @@ void ReplicaSetMonitor::failedHost(const HostAndPort& host, const Status& status
     DEV _state->checkInvariants();
 }
 
+void ReplicaSetMonitor::markRequestStarted(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    ++_state->outstandingRequests[host];
+}
+
+void ReplicaSetMonitor::markRequestFinished(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    auto it = _state->outstandingRequests.find(host);
+    invariant(it != _state->outstandingRequests.end());
+    if (--it->second == 0) {
+        _state->outstandingRequests.erase(it);
+    }
+}
+
 bool ReplicaSetMonitor::isPrimary(const HostAndPort& host) const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     Node* node = _state->findNode(host);
@@ -971,8 +1048,14 @@ void Node::update(const IsMasterReply& reply) {
         if (latencyMicros == unknownLatency) {
             latencyMicros = reply.latencyMicros;
         } else {
+            // Clamp outliers so that a single stalled ping doesn't push the node out of the
+            // latency window. A sustained increase still gets through over a few rounds.
+            const int64_t maxSampleMicros = std::max(latencyMicros * kLatencyOutlierFactor,
+                                                     latencyMicros + kLatencyOutlierMinMicros);
+            const int64_t sampleMicros = std::min(reply.latencyMicros, maxSampleMicros);
+
             // update latency with smoothed moving average (1/4th the delta)
-            latencyMicros += (reply.latencyMicros - latencyMicros) / 4;
+            latencyMicros += (sampleMicros - latencyMicros) / 4;
         }
     }
 
@@ -1143,6 +1226,24 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                     }
                 }
 
+                // Of those, prefer the nodes with the fewest operations in flight, so that a
+                // member which has become slow to respond stops accumulating work.
+                const auto outstandingOn = [this](const Node* node) {
+                    auto it = outstandingRequests.find(node->host);
+                    return it == outstandingRequests.end() ? 0 : it->second;
+                };
+                int fewestOutstanding = outstandingOn(matchingNodes.front());
+                for (const Node* node : matchingNodes) {
+                    fewestOutstanding = std::min(fewestOutstanding, outstandingOn(node));
+                }
+                matchingNodes.erase(std::remove_if(matchingNodes.begin(),
+                                                   matchingNodes.end(),
+                                                   [&](const Node* node) {
+                                                       return outstandingOn(node) >
+                                                           fewestOutstanding;
+                                                   }),
+                                    matchingNodes.end());
+
                 // of the remaining nodes, pick one at random (or use round-robin)
                 if (ReplicaSetMonitor::useDeterministicHostSelection) {
                     // only in tests
@@ -39,6 +39,7 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
 
@@ -119,6 +120,16 @@ public:
      */
     void failedHost(const HostAndPort& host, const Status& status);
 
+    /**
+     * Notifies this Monitor that an operation was dispatched to, or has completed on, 'host'.
+     *
+     * Among the members that are within the latency window for a read preference, host selection
+     * prefers the ones with the fewest operations in flight. Every call to markRequestStarted
+     * must be paired with exactly one call to markRequestFinished for the same host.
+     */
+    void markRequestStarted(const HostAndPort& host);
+    void markRequestFinished(const HostAndPort& host);
+
     /**
      * Returns true if this node is the master based ONLY on local data. Be careful, return may
      * be stale.
@@ -267,12 +278,20 @@ private:
      */
     void _refresh(const executor::TaskExecutor::CallbackArgs&);
 
+    /**
+     * Schedules additional participants in 'scan' on the refresh thread pool, one per host which
+     * is still to be contacted beyond the first, so that the hosts are probed concurrently and a
+     * slow or unreachable host only holds up its own probe.
+     */
+    void _scheduleConcurrentRefresh(const ScanStatePtr& scan, size_t numParticipants);
+
     // Serializes refresh and protects _refresherHandle
     stdx::mutex _mutex;
     executor::TaskExecutor::CallbackHandle _refresherHandle;
 
     const SetStatePtr _state;
     executor::TaskExecutor* _executor;
+    ThreadPoolInterface* _refreshPool{nullptr};
     AtomicBool _isRemovedFromManager{false};
 };
 
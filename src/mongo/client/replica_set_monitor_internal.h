@@ -35,6 +35,7 @@
 
 #include <cstdint>
 #include <deque>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -206,6 +207,11 @@ public:
     mutable PseudoRandom rand;  // only used for host selection to balance load
     mutable int roundRobin;     // used when useDeterministicHostSelection is true
     MongoURI setUri;            // URI that may have constructed this
+
+    // Operations in flight per host, as reported through ReplicaSetMonitor::markRequestStarted
+    // and markRequestFinished. Hosts without operations in flight have no entry. Kept separately
+    // from the nodes so that the counts survive nodes being removed and re-added to the set.
+    std::map<HostAndPort, int> outstandingRequests;
 };
 
 struct ReplicaSetMonitor::ScanState {
@@ -45,6 +45,7 @@
 #include "mongo/rpc/metadata/egress_metadata_hook_list.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/map_util.h"
 
@@ -92,6 +93,13 @@ void ReplicaSetMonitorManager::_setupTaskExecutorInLock(const std::string& name)
                   "monitor set: "
                << redact(name);
         _taskExecutor->startup();
+
+        ThreadPool::Options options;
+        options.poolName = "ReplicaSetMonitor-RefreshPool";
+        options.minThreads = 0;
+        options.maxThreads = 32;
+        _refreshThreadPool = stdx::make_unique<ThreadPool>(options);
+        _refreshThreadPool->startup();
     }
 }
 
@@ -173,6 +181,8 @@ void ReplicaSetMonitorManager::shutdown() {
     LOG(1) << "Shutting down task executor used for monitoring replica sets";
     _taskExecutor->shutdown();
     _taskExecutor->join();
+    _refreshThreadPool->shutdown();
+    _refreshThreadPool->join();
 }
 
 void ReplicaSetMonitorManager::removeAllMonitors() {
@@ -189,6 +199,9 @@ void ReplicaSetMonitorManager::removeAllMonitors() {
     _taskExecutor->shutdown();
     _taskExecutor->join();
     _taskExecutor.reset();
+    _refreshThreadPool->shutdown();
+    _refreshThreadPool->join();
+    _refreshThreadPool.reset();
 
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
@@ -217,4 +230,9 @@ TaskExecutor* ReplicaSetMonitorManager::getExecutor() {
     return _taskExecutor.get();
 }
 
+ThreadPoolInterface* ReplicaSetMonitorManager::getRefreshThreadPool() {
+    invariant(_refreshThreadPool);
+    return _refreshThreadPool.get();
+}
+
 }  // namespace mongo
@@ -34,6 +34,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
 #include "mongo/util/string_map.h"
 
 namespace mongo {
@@ -79,7 +80,7 @@ public:
     void removeAllMonitors();
 
     /**
-     * Shuts down _taskExecutor.
+     * Shuts down _taskExecutor and _refreshThreadPool.
      */
     void shutdown();
 
@@ -93,6 +94,12 @@ public:
      */
     executor::TaskExecutor* getExecutor();
 
+    /**
+     * Returns a thread pool on which the hosts of a set can be contacted concurrently during a
+     * refresh. The isMaster probes are blocking, so they don't run on getExecutor().
+     */
+    ThreadPoolInterface* getRefreshThreadPool();
+
 private:
     using ReplicaSetMonitorsMap = StringMap<std::weak_ptr<ReplicaSetMonitor>>;
 
@@ -103,6 +110,10 @@ private:
     // Executor for monitoring replica sets.
     std::unique_ptr<executor::TaskExecutor> _taskExecutor;
 
+    // Thread pool for contacting the hosts of a set concurrently. Created and shut down along with
+    // _taskExecutor.
+    std::unique_ptr<ThreadPoolInterface> _refreshThreadPool;
+
     void _setupTaskExecutorInLock(const std::string& name);
 
     // set to true when shutdown has been called.
@@ -38,6 +38,7 @@ using namespace mongo;
 using std::set;
 
 // Pull nested types to top-level scope
+typedef ReplicaSetMonitor::IsMasterReply IsMasterReply;
 typedef ReplicaSetMonitor::SetState SetState;
 typedef SetState::Node Node;
 typedef SetState::Nodes Nodes;
@@ -337,4 +338,30 @@ TEST(ReplSetMonitorNode, SecNodeNotCompatibleMultiTag) {
     ASSERT(!isCompatible(node, mongo::ReadPreference::Nearest, tags));
 }
 
+TEST(ReplSetMonitorNode, LatencyOutlierIsClamped) {
+    const HostAndPort host("dummy", 3);
+    const BSONObj isMasterDoc = BSON("setName"
+                                     << "name"
+                                     << "ismaster"
+                                     << false
+                                     << "secondary"
+                                     << true
+                                     << "ok"
+                                     << true);
+
+    Node node(host);
+    node.update(IsMasterReply(host, 1000, isMasterDoc));
+    ASSERT_EQUALS(1000, node.latencyMicros);
+
+    // A single slow ping is clamped to the smoothed latency plus 5ms before being averaged in.
+    node.update(IsMasterReply(host, 1000 * 1000, isMasterDoc));
+    ASSERT_EQUALS(1000 + (6000 - 1000) / 4, node.latencyMicros);
+
+    // A host which stays slow is eventually reported as such.
+    for (int i = 0; i < 30; ++i) {
+        node.update(IsMasterReply(host, 1000 * 1000, isMasterDoc));
+    }
+    ASSERT_GREATER_THAN(node.latencyMicros, 900 * 1000);
+}
+
 }  // namespace
@@ -298,6 +298,33 @@ TEST(ReplSetMonitorReadPref, NearestOneLocal) {
     ASSERT(!isPrimarySelected);
 }
 
+TEST(ReplSetMonitorReadPref, NearestPrefersFewestOutstandingRequests) {
+    vector<Node> nodes = getThreeMemberWithTags();
+
+    nodes[0].latencyMicros = 1 * 1000;
+    nodes[1].latencyMicros = 2 * 1000;
+    nodes[2].latencyMicros = 3 * 1000;
+
+    set<HostAndPort> seeds;
+    seeds.insert(nodes.front().host);
+
+    SetState set("name", seeds);
+    set.nodes = nodes;
+    set.latencyThresholdMicros = 15 * 1000;
+    set.outstandingRequests[HostAndPort("a")] = 2;
+    set.outstandingRequests[HostAndPort("b")] = 1;
+
+    ReadPreferenceSetting criteria(ReadPreference::Nearest, TagSet());
+    ASSERT_EQUALS(HostAndPort("c"), set.getMatchingHost(criteria));
+
+    set.outstandingRequests[HostAndPort("c")] = 3;
+    ASSERT_EQUALS(HostAndPort("b"), set.getMatchingHost(criteria));
+
+    // Nodes outside of the latency window are not considered, however idle they are.
+    set.latencyThresholdMicros = 1;
+    ASSERT_EQUALS(HostAndPort("a"), set.getMatchingHost(criteria));
+}
+
 TEST(ReplSetMonitorReadPref, PriOnlyWithTagsNoMatch) {
     vector<Node> nodes = getThreeMemberWithTags();
     TagSet tags(getP2TagSet());
@@ -1207,6 +1207,22 @@ TEST(ReplicaSetMonitor, PrimaryIsUpCheck) {
     ASSERT_TRUE(rsm.isKnownToHaveGoodPrimary());
 }
 
+TEST(ReplicaSetMonitor, OutstandingRequestsAreCountedPerHost) {
+    SetStatePtr state = std::make_shared<SetState>("name", basicSeedsSet);
+    ReplicaSetMonitor rsm(state);
+    const HostAndPort host = state->nodes.front().host;
+
+    rsm.markRequestStarted(host);
+    rsm.markRequestStarted(host);
+    ASSERT_EQUALS(2, state->outstandingRequests[host]);
+
+    rsm.markRequestFinished(host);
+    ASSERT_EQUALS(1, state->outstandingRequests[host]);
+
+    rsm.markRequestFinished(host);
+    ASSERT_EQUALS(0U, state->outstandingRequests.count(host));
+}
+
 /**
  * Repl protocol verion 0 and 1 compatibility checking.
  */
@@ -99,12 +99,14 @@ struct CompactStats {
 struct InsertStatement {
 public:
     InsertStatement() = default;
-    explicit InsertStatement(BSONObj toInsert) : doc(toInsert) {}
+    explicit InsertStatement(BSONObj toInsert) : doc(std::move(toInsert)) {}
 
-    InsertStatement(StmtId statementId, BSONObj toInsert) : stmtId(statementId), doc(toInsert) {}
+    InsertStatement(StmtId statementId, BSONObj toInsert)
+        : stmtId(statementId), doc(std::move(toInsert)) {}
     InsertStatement(StmtId statementId, BSONObj toInsert, SnapshotName ts)
-        : stmtId(statementId), timestamp(ts), doc(toInsert) {}
-    InsertStatement(BSONObj toInsert, SnapshotName ts) : timestamp(ts), doc(toInsert) {}
+        : stmtId(statementId), timestamp(ts), doc(std::move(toInsert)) {}
+    InsertStatement(BSONObj toInsert, SnapshotName ts)
+        : timestamp(ts), doc(std::move(toInsert)) {}
 
     StmtId stmtId = kUninitializedStmtId;
     SnapshotName timestamp = SnapshotName();
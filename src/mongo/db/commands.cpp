@@ -340,6 +340,7 @@ bool Command::isHelpRequest(const BSONElement& helpElem) {
 }
 
 const char Command::kHelpFieldName[] = "help";
+const char Command::kPriorityFieldName[] = "priority";
 
 void Command::generateHelpResponse(OperationContext* opCtx,
                                    rpc::ReplyBuilderInterface* replyBuilder,
@@ -419,6 +419,12 @@ public:
 
     static const char kHelpFieldName[];
 
+    /**
+     * Generic argument naming the AdmissionPriority ("low", "normal" or "high") with which the
+     * operation queues for storage engine tickets.
+     */
+    static const char kPriorityFieldName[];
+
     /**
      * Generates a reply from the 'help' information associated with a command. The state of
      * the passed ReplyBuilder will be in kOutputDocs after calling this method.
@@ -469,6 +475,7 @@ public:
             arg == "$replData" ||           //
             arg == "$clusterTime" ||        //
             arg == "maxTimeMS" ||           //
+            arg == "priority" ||            //
             arg == "readConcern" ||         //
             arg == "shardVersion" ||        //
             arg == "tracking_info" ||       //
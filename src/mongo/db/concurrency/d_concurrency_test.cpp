@@ -42,7 +42,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
-#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/concurrency/priority_ticketholder.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
@@ -56,7 +56,7 @@ const int kMaxStressThreads = 32;  // max number of threads to use for lock stre
 const int kMinPerfMillis = 30;     // min duration for reliable timing
 
 /**
- * A RAII object that instantiates a TicketHolder that limits number of allowed global lock
+ * A RAII object that instantiates a PriorityTicketHolder that limits number of allowed global lock
  * acquisitions to numTickets. The opCtx must live as long as the UseGlobalThrottling instance.
  */
 class UseGlobalThrottling {
@@ -72,7 +72,7 @@ public:
 
 private:
     OperationContext* _opCtx;
-    TicketHolder _holder;
+    PriorityTicketHolder _holder;
 };
 
 
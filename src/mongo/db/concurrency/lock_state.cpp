@@ -39,7 +39,7 @@
 #include "mongo/platform/compiler.h"
 #include "mongo/stdx/new.h"
 #include "mongo/util/background.h"
-#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/concurrency/priority_ticketholder.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -238,7 +238,7 @@ void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
 }
 
 namespace {
-TicketHolder* ticketHolders[LockModesCount] = {};
+PriorityTicketHolder* ticketHolders[LockModesCount] = {};
 }  // namespace
 
 
@@ -247,7 +247,7 @@ TicketHolder* ticketHolders[LockModesCount] = {};
 //
 
 /* static */
-void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder* writing) {
+void Locker::setGlobalThrottling(PriorityTicketHolder* reading, PriorityTicketHolder* writing) {
     ticketHolders[MODE_S] = reading;
     ticketHolders[MODE_IS] = reading;
     ticketHolders[MODE_IX] = writing;
@@ -311,8 +311,9 @@ LockResult LockerImpl<IsForMMAPV1>::_lockGlobalBegin(LockMode mode, Milliseconds
         if (holder) {
             _clientState.store(reader ? kQueuedReader : kQueuedWriter);
             if (timeout == Milliseconds::max()) {
-                holder->waitForTicket();
-            } else if (!holder->waitForTicketUntil(Date_t::now() + timeout)) {
+                holder->waitForTicket(getAdmissionPriority());
+            } else if (!holder->waitForTicketUntil(Date_t::now() + timeout,
+                                                   getAdmissionPriority())) {
                 _clientState.store(kInactive);
                 return LOCK_TIMEOUT;
             }
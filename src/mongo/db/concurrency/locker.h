@@ -34,6 +34,7 @@
 #include "mongo/db/concurrency/lock_manager.h"
 #include "mongo/db/concurrency/lock_stats.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/priority_ticketholder.h"
 
 namespace mongo {
 
@@ -68,7 +69,7 @@ public:
      * intended to defend against arge drops in throughput under high load due to too much
      * concurrency.
      */
-    static void setGlobalThrottling(class TicketHolder* reading, class TicketHolder* writing);
+    static void setGlobalThrottling(PriorityTicketHolder* reading, PriorityTicketHolder* writing);
 
     /**
      * State for reporting the number of active and queued reader and writer clients.
@@ -327,11 +328,23 @@ public:
         return _shouldConflictWithSecondaryBatchApplication;
     }
 
+    /**
+     * The priority with which this locker queues for a ticket when acquiring the global lock.
+     * Only takes effect for the next ticket acquisition.
+     */
+    void setAdmissionPriority(AdmissionPriority priority) {
+        _admissionPriority = priority;
+    }
+    AdmissionPriority getAdmissionPriority() const {
+        return _admissionPriority;
+    }
+
 protected:
     Locker() {}
 
 private:
     bool _shouldConflictWithSecondaryBatchApplication = true;
+    AdmissionPriority _admissionPriority = AdmissionPriority::kNormal;
 };
 
 }  // namespace mongo
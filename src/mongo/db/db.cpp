@@ -970,6 +970,9 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(CreateReplicationManager,
 
     repl::TopologyCoordinatorImpl::Options topoCoordOptions;
     topoCoordOptions.maxSyncSourceLagSecs = Seconds(repl::maxSyncSourceLagSecs);
+    topoCoordOptions.useMeasuredSyncSourceThroughput = repl::syncSourceSelectionUsesThroughput;
+    topoCoordOptions.syncSourceReselectionMinInterval =
+        Seconds(repl::syncSourceReselectionMinIntervalSecs);
     topoCoordOptions.clusterRole = serverGlobalParams.clusterRole;
 
     auto logicalClock = stdx::make_unique<LogicalClock>(serviceContext);
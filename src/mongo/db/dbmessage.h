@@ -446,6 +446,11 @@ Message makeGetMoreMessage(StringData ns, long long cursorId, int nToReturn, int
 struct DbResponse {
     Message response;       // If empty, nothing will be returned to the client.
     std::string exhaustNS;  // Namespace of cursor if exhaust mode, else "".
+
+    // OP_MSG exhaust: if set, 'response' has the moreToCome flag and 'nextInvocation' is the
+    // command to run next to produce the following reply, without sourcing a new request.
+    bool shouldRunAgainForExhaust = false;
+    BSONObj nextInvocation;
 };
 
 /**
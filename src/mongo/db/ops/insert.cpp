@@ -94,6 +94,7 @@ StatusWith<BSONObj> fixDocumentForInsert(ServiceContext* service, const BSONObj&
     bool firstElementIsId = false;
     bool hasTimestampToFix = false;
     bool hadId = false;
+    BSONElement idElement;
     {
         BSONObjIterator i(doc);
         for (bool isFirstElement = true; i.more(); isFirstElement = false) {
@@ -138,12 +139,15 @@ StatusWith<BSONObj> fixDocumentForInsert(ServiceContext* service, const BSONObj&
                                                "can't have multiple _id fields in one document");
                 } else {
                     hadId = true;
+                    idElement = e;
                     firstElementIsId = isFirstElement;
                 }
             }
         }
     }
 
+    // The common case needs no rewrite: the caller inserts 'doc' itself, which for write commands
+    // is a view into the received message, so no bytes are copied before they reach storage.
     if (firstElementIsId && !hasTimestampToFix)
         return StatusWith<BSONObj>(BSONObj());
 
@@ -154,9 +158,8 @@ StatusWith<BSONObj> fixDocumentForInsert(ServiceContext* service, const BSONObj&
         b.append(doc.firstElement());
         i.next();
     } else {
-        BSONElement e = doc["_id"];
-        if (e.type()) {
-            b.append(e);
+        if (hadId) {
+            b.append(idElement);
         } else {
             b.appendOID("_id", NULL, true);
         }
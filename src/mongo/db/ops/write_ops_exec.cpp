@@ -470,8 +470,13 @@ WriteResult performInserts(OperationContext* opCtx, const write_ops::Insert& who
                 }
             }
 
-            BSONObj toInsert = fixedDoc.getValue().isEmpty() ? doc : std::move(fixedDoc.getValue());
-            batch.emplace_back(stmtId, toInsert);
+            // Unless it had to be rewritten, 'doc' still points into the request message, which
+            // outlives this operation, so the batch references it in place rather than owning it.
+            if (fixedDoc.getValue().isEmpty()) {
+                batch.emplace_back(stmtId, doc);
+            } else {
+                batch.emplace_back(stmtId, std::move(fixedDoc.getValue()));
+            }
             bytesInBatch += batch.back().doc.objsize();
             if (!isLastDoc && batch.size() < maxBatchSize && bytesInBatch < insertVectorMaxBytes)
                 continue;  // Add more to batch before inserting.
@@ -240,6 +240,23 @@ TEST(CommandWriteOpsParsers, RealMultiInsert) {
     }
 }
 
+TEST(CommandWriteOpsParsers, InsertDocumentsReferenceMessageBuffer) {
+    const auto ns = NamespaceString("test", "foo");
+    const BSONObj obj0 = BSON("x" << 0);
+    const BSONObj obj1 = BSON("x" << 1);
+    auto cmd = BSON("insert" << ns.coll() << "documents" << BSON_ARRAY(obj0 << obj1));
+    for (bool seq : {false, true}) {
+        const auto message = toOpMsg(ns.db(), cmd, seq).serialize();
+        const auto op = InsertOp::parse(OpMsgRequest::parse(message));
+        ASSERT_EQ(op.getDocuments().size(), 2u);
+        for (auto&& doc : op.getDocuments()) {
+            // The parsed documents must be views into the received message, not copies.
+            ASSERT(doc.objdata() >= message.buf());
+            ASSERT(doc.objdata() + doc.objsize() <= message.buf() + message.size());
+        }
+    }
+}
+
 TEST(CommandWriteOpsParsers, Update) {
     const auto ns = NamespaceString("test", "foo");
     const BSONObj query = BSON("x" << 1);
@@ -362,6 +379,18 @@ TEST(LegacyWriteOpsParsers, RealMultiInsert) {
     }
 }
 
+TEST(LegacyWriteOpsParsers, InsertDocumentsReferenceMessageBuffer) {
+    const std::string ns = "test.foo";
+    auto objs = std::vector<BSONObj>{BSON("x" << 0), BSON("x" << 1)};
+    auto message = makeInsertMessage(ns, objs.data(), objs.size(), 0);
+    const auto op = InsertOp::parseLegacy(message);
+    ASSERT_EQ(op.getDocuments().size(), 2u);
+    for (auto&& doc : op.getDocuments()) {
+        ASSERT(doc.objdata() >= message.buf());
+        ASSERT(doc.objdata() + doc.objsize() <= message.buf() + message.size());
+    }
+}
+
 TEST(LegacyWriteOpsParsers, Update) {
     const std::string ns = "test.foo";
     const BSONObj query = BSON("x" << 1);
@@ -637,6 +637,22 @@ public:
             const std::vector<BSONObj>& rawPipeline,
             const boost::intrusive_ptr<ExpressionContext>& expCtx) = 0;
 
+        /**
+         * Returns true if 'nss' is a sharded collection according to the routing information
+         * cached on this node. Unlike isSharded(), this does not depend on this node owning any
+         * chunks of 'nss', and is always false if this node is not part of a sharded cluster.
+         */
+        virtual bool isShardedInCluster(const NamespaceString& nss) = 0;
+
+        /**
+         * Runs a query with the given 'filter' against the collection 'expCtx->ns' on every shard
+         * which may own a matching document, using the collation of 'expCtx', and returns all of
+         * the matching documents. Intended for stages which read from a foreign collection for
+         * which isShardedInCluster() returned true.
+         */
+        virtual std::vector<Document> queryShardedCollection(
+            const boost::intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& filter) = 0;
+
         /**
          * Returns a vector of owned BSONObjs, each of which contains details of an in-progress
          * operation or, optionally, an idle connection. If userMode is kIncludeAllUsers, report
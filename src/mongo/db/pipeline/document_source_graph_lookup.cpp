@@ -48,7 +48,7 @@ using boost::intrusive_ptr;
 
 namespace dps = ::mongo::dotted_path_support;
 
-std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceGraphLookUp::liteParse(
+std::unique_ptr<DocumentSourceGraphLookUp::LiteParsed> DocumentSourceGraphLookUp::liteParse(
     const AggregationRequest& request, const BSONElement& spec) {
     uassert(ErrorCodes::FailedToParse,
             str::stream() << "the $graphLookup stage specification must be an object, but found "
@@ -74,8 +74,7 @@ std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceGraphL
     PrivilegeVector privileges{
         Privilege(ResourcePattern::forExactNamespace(nss), ActionType::find)};
 
-    return stdx::make_unique<LiteParsedDocumentSourceForeignCollections>(std::move(nss),
-                                                                         std::move(privileges));
+    return stdx::make_unique<LiteParsed>(std::move(nss), std::move(privileges));
 }
 
 REGISTER_DOCUMENT_SOURCE(graphLookup,
@@ -203,20 +202,34 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
             // Query for all keys that were in the frontier and not in the cache, populating
             // '_frontier' for the next iteration of search.
 
-            // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-            _fromPipeline.back() = *matchStage;
-            auto pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
-            while (auto next = pipeline->getNext()) {
+            auto processResult = [&](Document next) {
                 uassert(40271,
                         str::stream()
                             << "Documents in the '"
                             << _from.ns()
                             << "' namespace must contain an _id for de-duplication in $graphLookup",
-                        !(*next)["_id"].missing());
+                        !next["_id"].missing());
 
                 shouldPerformAnotherQuery =
-                    addToVisitedAndFrontier(*next, depth) || shouldPerformAnotherQuery;
-                addToCache(std::move(*next), queried);
+                    addToVisitedAndFrontier(next, depth) || shouldPerformAnotherQuery;
+                addToCache(std::move(next), queried);
+            };
+
+            if (foreignCollectionIsSharded()) {
+                // The frontier is sent to the shards as a single query, unwrapped from its $match.
+                auto results = _mongod->queryShardedCollection(
+                    _fromExpCtx, matchStage->firstElement().embeddedObject());
+                for (auto&& next : results) {
+                    processResult(std::move(next));
+                }
+            } else {
+                // We've already allocated space for the trailing $match stage in '_fromPipeline'.
+                _fromPipeline.back() = *matchStage;
+                auto pipeline =
+                    uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
+                while (auto next = pipeline->getNext()) {
+                    processResult(std::move(*next));
+                }
             }
             checkMemoryUsage();
         }
@@ -229,6 +242,16 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
     _frontierUsageBytes = 0;
 }
 
+bool DocumentSourceGraphLookUp::foreignCollectionIsSharded() {
+    if (!_foreignIsSharded) {
+        // A view pipeline cannot be expressed as a query, so a view on a sharded collection still
+        // goes through makePipeline(), which rejects it.
+        _foreignIsSharded =
+            _fromPipeline.size() == 1 && _mongod->isShardedInCluster(_fromExpCtx->ns);
+    }
+    return *_foreignIsSharded;
+}
+
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
@@ -38,8 +38,22 @@ namespace mongo {
 
 class DocumentSourceGraphLookUp final : public DocumentSourceNeedsMongod {
 public:
-    static std::unique_ptr<LiteParsedDocumentSourceForeignCollections> liteParse(
-        const AggregationRequest& request, const BSONElement& spec);
+    class LiteParsed final : public LiteParsedDocumentSourceForeignCollections {
+    public:
+        using LiteParsedDocumentSourceForeignCollections::
+            LiteParsedDocumentSourceForeignCollections;
+
+        /**
+         * Each round of the search is a single query on the connectToField, which can be sent to
+         * the shards when the 'from' collection is sharded.
+         */
+        bool allowShardedForeignCollection(const NamespaceString& nss) const final {
+            return true;
+        }
+    };
+
+    static std::unique_ptr<LiteParsed> liteParse(const AggregationRequest& request,
+                                                 const BSONElement& spec);
 
     GetNextResult getNext() final;
     const char* getSourceName() const final;
@@ -138,6 +152,12 @@ private:
      */
     void doBreadthFirstSearch();
 
+    /**
+     * Returns true if the 'from' collection is sharded, in which case each round of the search is
+     * sent to the shards rather than executed as a local pipeline. Determined on first use.
+     */
+    bool foreignCollectionIsSharded();
+
     /**
      * Populates '_frontier' with the '_startWith' value(s) from '_input' and then performs a
      * breadth-first search. Caller should check that _input is not boost::none.
@@ -181,6 +201,8 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
+    boost::optional<bool> _foreignIsSharded;
+
     size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
@@ -61,6 +61,10 @@ public:
     MockMongodImplementation(std::deque<DocumentSource::GetNextResult> results)
         : _results(std::move(results)) {}
 
+    bool isShardedInCluster(const NamespaceString& nss) final {
+        return false;
+    }
+
     StatusWith<std::unique_ptr<Pipeline, Pipeline::Deleter>> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx) final {
@@ -34,10 +34,12 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_comparator.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -71,7 +73,8 @@ DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
       _fromNs(std::move(fromNs)),
       _as(std::move(as)),
       _variables(pExpCtx->variables),
-      _variablesParseState(pExpCtx->variablesParseState.copyWith(_variables.useIdGenerator())) {
+      _variablesParseState(pExpCtx->variablesParseState.copyWith(_variables.useIdGenerator())),
+      _cache(pExpCtx->getValueComparator()) {
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_fromNs);
     _resolvedNs = resolvedNamespace.ns;
     _resolvedPipeline = resolvedNamespace.pipeline;
@@ -188,11 +191,26 @@ BSONObj buildEqualityOrQuery(const std::string& fieldName, const BSONArray& valu
     return orBuilder.obj();
 }
 
+/**
+ * Returns true if the foreign documents matching 'key' can be fetched together with those of other
+ * keys using $in, and then be told apart again by the values at the foreign field. That is not the
+ * case for arrays, which are matched both as a whole and element-wise, for regular expressions,
+ * which $in treats as patterns, and for null, which also matches missing fields.
+ */
+bool canBatchLookupKey(const Value& key) {
+    return !key.nullish() && key.getType() != BSONType::Array &&
+        key.getType() != BSONType::RegEx;
+}
+
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     pExpCtx->checkForInterrupt();
 
+    if (foreignCollectionIsSharded()) {
+        return getNextFromShardedForeignCollection();
+    }
+
     if (_unwindSrc) {
         return unwindResult();
     }
@@ -376,6 +394,8 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _shardedLookupBatch.clear();
+    _cache.clear();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -530,6 +550,207 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     return output.freeze();
 }
 
+bool DocumentSourceLookUp::foreignCollectionIsSharded() {
+    if (!_foreignIsSharded) {
+        // Only the localField/foreignField syntax can be answered with plain queries, and only if
+        // there is no view pipeline to apply to the foreign documents first.
+        _foreignIsSharded = !wasConstructedWithPipelineSyntax() && _resolvedPipeline.size() == 1 &&
+            _mongod->isShardedInCluster(_resolvedNs);
+    }
+    return *_foreignIsSharded;
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextFromShardedForeignCollection() {
+    while (true) {
+        if (_shardedLookupBatch.empty() && !fillShardedLookupBatch()) {
+            auto result = std::move(*_shardedLookupPendingResult);
+            _shardedLookupPendingResult = boost::none;
+            return result;
+        }
+
+        auto& current = _shardedLookupBatch.front();
+
+        if (!_unwindSrc) {
+            MutableDocument output(std::move(current.input));
+            output.setNestedField(_as, Value(std::move(current.matches)));
+            _shardedLookupBatch.pop_front();
+            return output.freeze();
+        }
+
+        const boost::optional<FieldPath> indexPath(_unwindSrc->indexPath());
+
+        if (current.matches.empty()) {
+            if (!_unwindSrc->preserveNullAndEmptyArrays()) {
+                _shardedLookupBatch.pop_front();
+                continue;
+            }
+
+            // There were no results for this input document, but the $unwind was asked to preserve
+            // empty arrays, so we should return a document without the array.
+            MutableDocument output(std::move(current.input));
+            output.setNestedField(_as, Value());
+            if (indexPath) {
+                output.setNestedField(*indexPath, Value(BSONNULL));
+            }
+            _shardedLookupBatch.pop_front();
+            return output.freeze();
+        }
+
+        const bool isLastMatch = static_cast<size_t>(_cursorIndex + 1) == current.matches.size();
+
+        // Move input document into output if this is the last or only result, otherwise perform a
+        // copy.
+        MutableDocument output(isLastMatch ? std::move(current.input) : current.input);
+        output.setNestedField(_as, current.matches[_cursorIndex]);
+        if (indexPath) {
+            output.setNestedField(*indexPath, Value(_cursorIndex));
+        }
+
+        if (isLastMatch) {
+            _shardedLookupBatch.pop_front();
+            _cursorIndex = 0;
+        } else {
+            ++_cursorIndex;
+        }
+        return output.freeze();
+    }
+}
+
+bool DocumentSourceLookUp::fillShardedLookupBatch() {
+    invariant(_shardedLookupBatch.empty());
+
+    const size_t batchSize = std::max(1, internalDocumentSourceLookupShardedBatchSize.load());
+    std::vector<Document> inputs;
+    while (inputs.size() < batchSize) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            _shardedLookupPendingResult = std::move(nextInput);
+            break;
+        }
+        inputs.push_back(nextInput.releaseDocument());
+    }
+
+    if (inputs.empty()) {
+        return false;
+    }
+
+    // Entries are only evicted between batches, so that every key of the current batch remains in
+    // the cache until its matches have been copied out below.
+    _cache.evictDownTo(internalDocumentSourceLookupCacheSizeBytes.load());
+
+    const auto& valueCmp = pExpCtx->getValueComparator();
+    ValueUnorderedSet batchedKeys = valueCmp.makeUnorderedValueSet();
+    ValueUnorderedSet individualKeys = valueCmp.makeUnorderedValueSet();
+
+    // Determine the values each input document joins on, and which of them are not yet cached.
+    std::vector<std::vector<Value>> inputKeys;
+    inputKeys.reserve(inputs.size());
+    for (auto&& input : inputs) {
+        std::vector<Value> keys;
+        document_path_support::visitAllValuesAtPath(
+            input, *_localField, [&keys](const Value& key) { keys.push_back(key); });
+        if (keys.empty()) {
+            // Missing values are treated as null.
+            keys.push_back(Value(BSONNULL));
+        }
+
+        for (auto&& key : keys) {
+            if (!_cache[key]) {
+                (canBatchLookupKey(key) ? batchedKeys : individualKeys).insert(key);
+            }
+        }
+        inputKeys.push_back(std::move(keys));
+    }
+
+    const auto foreignFieldName = _foreignField->fullPath();
+
+    if (!batchedKeys.empty()) {
+        BSONArrayBuilder inBuilder;
+        for (auto&& key : batchedKeys) {
+            inBuilder << key;
+        }
+
+        auto matches = queryShardedForeignCollection(
+            BSON(foreignFieldName << BSON("$in" << inBuilder.arr())));
+        for (auto&& match : matches) {
+            // Cache the document under each queried value it holds at the foreign field. As in
+            // $graphLookup, a value which was not queried for cannot be cached under, since other
+            // documents holding it were not fetched.
+            ValueUnorderedSet cachedUnder = valueCmp.makeUnorderedValueSet();
+            document_path_support::visitAllValuesAtPath(
+                match, *_foreignField, [&](const Value& foreignValue) {
+                    if (batchedKeys.count(foreignValue) &&
+                        cachedUnder.insert(foreignValue).second) {
+                        _cache.insert(foreignValue, match);
+                    }
+                });
+        }
+
+        for (auto&& key : batchedKeys) {
+            _cache.insertEmpty(key);
+        }
+    }
+
+    for (auto&& key : individualKeys) {
+        auto matches = queryShardedForeignCollection(BSON(foreignFieldName << BSON("$eq" << key)));
+        _cache.insertEmpty(key);
+        for (auto&& match : matches) {
+            _cache.insert(key, std::move(match));
+        }
+    }
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        const auto& keys = inputKeys[i];
+
+        std::vector<Value> results;
+        int objsize = 0;
+        auto addResult = [&](const Document& match) {
+            objsize += match.getApproximateSize();
+            uassert(4568,
+                    str::stream() << "Total size of documents in " << _fromNs.coll()
+                                  << " matching "
+                                  << foreignFieldName
+                                  << " exceeds maximum document size",
+                    _unwindSrc || objsize <= BSONObjMaxInternalSize);
+            results.emplace_back(match);
+        };
+
+        if (keys.size() == 1) {
+            auto cached = _cache[keys.front()];
+            invariant(cached);
+            for (auto&& match : *cached) {
+                addResult(match);
+            }
+        } else {
+            // A foreign document matching several of the values of an array-valued local field is
+            // only joined once.
+            const DocumentComparator simpleDocumentComparator;
+            DocumentUnorderedSet seen = simpleDocumentComparator.makeUnorderedDocumentSet();
+            for (auto&& key : keys) {
+                auto cached = _cache[key];
+                invariant(cached);
+                for (auto&& match : *cached) {
+                    if (seen.insert(match).second) {
+                        addResult(match);
+                    }
+                }
+            }
+        }
+
+        _shardedLookupBatch.push_back({std::move(inputs[i]), std::move(results)});
+    }
+
+    return true;
+}
+
+std::vector<Document> DocumentSourceLookUp::queryShardedForeignCollection(BSONObj joinPredicate) {
+    if (!_additionalFilter) {
+        return _mongod->queryShardedCollection(_fromExpCtx, joinPredicate);
+    }
+    return _mongod->queryShardedCollection(
+        _fromExpCtx, BSON("$and" << BSON_ARRAY(joinPredicate << *_additionalFilter)));
+}
+
 void DocumentSourceLookUp::copyVariablesToExpCtx(const Variables& vars,
                                                  const VariablesParseState& vps,
                                                  ExpressionContext* expCtx) {
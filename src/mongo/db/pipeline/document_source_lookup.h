@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -77,6 +78,14 @@ public:
             return requiredPrivileges;
         }
 
+        /**
+         * A sharded foreign collection is supported for the localField/foreignField syntax, where
+         * the join can be answered with plain queries against the shards.
+         */
+        bool allowShardedForeignCollection(const NamespaceString& nss) const final {
+            return !_liteParsedPipeline;
+        }
+
     private:
         const NamespaceString _fromNss;
         const stdx::unordered_set<NamespaceString> _foreignNssSet;
@@ -215,6 +224,33 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Returns true if this stage joins on localField/foreignField against a sharded collection,
+     * in which case foreign documents are fetched from the shards for batches of input documents
+     * rather than through a local pipeline per input document. Determined on first use.
+     */
+    bool foreignCollectionIsSharded();
+
+    /**
+     * getNext() dispatches to this function when the foreign collection is sharded. Handles an
+     * absorbed $unwind as well.
+     */
+    GetNextResult getNextFromShardedForeignCollection();
+
+    /**
+     * Pulls up to 'internalDocumentSourceLookupShardedBatchSize' documents from 'pSource', fetches
+     * the foreign documents they join with from the shards and queues both in
+     * '_shardedLookupBatch'. Returns false if no input document was available, in which case the
+     * result that ended the batch is stored in '_shardedLookupPendingResult'.
+     */
+    bool fillShardedLookupBatch();
+
+    /**
+     * Fetches the foreign documents matching 'joinPredicate' (and '_additionalFilter', if any)
+     * from the shards.
+     */
+    std::vector<Document> queryShardedForeignCollection(BSONObj joinPredicate);
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -271,6 +307,25 @@ private:
     std::unique_ptr<Pipeline, Pipeline::Deleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    // The following members are only used when the foreign collection is sharded.
+    struct ShardedLookupResult {
+        Document input;
+        std::vector<Value> matches;
+    };
+
+    boost::optional<bool> _foreignIsSharded;
+
+    // Input documents whose foreign matches have been fetched but which have not been returned.
+    std::deque<ShardedLookupResult> _shardedLookupBatch;
+
+    // A non-advanced result from 'pSource' which ended the previous batch, to be returned once the
+    // batch has been drained.
+    boost::optional<GetNextResult> _shardedLookupPendingResult;
+
+    // Foreign documents keyed by the local field value they join with. Maintained across batches
+    // so that values repeated in the input are only fetched from the shards once.
+    LookupSetCache _cache;
 };
 
 }  // namespace mongo
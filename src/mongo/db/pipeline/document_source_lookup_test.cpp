@@ -35,6 +35,7 @@
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_lookup.h"
@@ -43,6 +44,8 @@
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/stub_mongod_interface.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -418,6 +421,10 @@ public:
         return false;
     }
 
+    bool isShardedInCluster(const NamespaceString& nss) final {
+        return false;
+    }
+
     StatusWith<std::unique_ptr<Pipeline, Pipeline::Deleter>> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx) final {
@@ -436,6 +443,112 @@ private:
     deque<DocumentSource::GetNextResult> _mockResults;
 };
 
+/**
+ * A mock MongodInterface which treats the foreign collection as sharded, answering queries against
+ * it by matching the filter against a fixed set of documents.
+ */
+class MockShardedMongodInterface final : public StubMongodInterface {
+public:
+    MockShardedMongodInterface(std::vector<Document> foreignContents)
+        : _foreignContents(std::move(foreignContents)) {}
+
+    bool isShardedInCluster(const NamespaceString& nss) final {
+        return true;
+    }
+
+    std::vector<Document> queryShardedCollection(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& filter) final {
+        ++numQueries;
+
+        auto matcher =
+            uassertStatusOK(MatchExpressionParser::parse(filter, expCtx->getCollator(), expCtx));
+        std::vector<Document> results;
+        for (auto&& doc : _foreignContents) {
+            if (matcher->matchesBSON(doc.toBson())) {
+                results.push_back(doc);
+            }
+        }
+        return results;
+    }
+
+    int numQueries = 0;
+
+private:
+    std::vector<Document> _foreignContents;
+};
+
+TEST_F(DocumentSourceLookUpTest, ShouldBatchAndCacheQueriesAgainstShardedForeignCollection) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    const auto originalBatchSize = internalDocumentSourceLookupShardedBatchSize.load();
+    internalDocumentSourceLookupShardedBatchSize.store(2);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupShardedBatchSize.store(originalBatchSize); });
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "fid"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    const Value oneAndTwo{vector<Value>{Value(1), Value(2)}};
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"_id", 0}, {"foreignId", 1}},
+                                    Document{{"_id", 1}, {"foreignId", oneAndTwo}},
+                                    Document{{"_id", 2}},
+                                    Document{{"_id", 3}, {"foreignId", 2}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document foreignOne{{"_id", 0}, {"fid", 1}};
+    const Document foreignTwoAndThree{{"_id", 1},
+                                      {"fid", Value{vector<Value>{Value(2), Value(3)}}}};
+    const Document foreignMissing{{"_id", 2}};
+    auto mongod = std::make_shared<MockShardedMongodInterface>(
+        std::vector<Document>{foreignOne, foreignTwoAndThree, foreignMissing});
+    lookup->injectMongodInterface(mongod);
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", 0},
+                                 {"foreignId", 1},
+                                 {"foreignDocs", vector<Value>{Value(foreignOne)}}}));
+
+    // The first batch looked up both 1 and 2 with a single query.
+    ASSERT_EQ(1, mongod->numQueries);
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"_id", 1},
+                  {"foreignId", oneAndTwo},
+                  {"foreignDocs", vector<Value>{Value(foreignOne), Value(foreignTwoAndThree)}}}));
+
+    // A missing local field is joined with documents missing the foreign field.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"_id", 2}, {"foreignDocs", vector<Value>{Value(foreignMissing)}}}));
+
+    // Only null had to be queried for in the second batch; 2 was served from the cache.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", 3},
+                                 {"foreignId", 2},
+                                 {"foreignDocs", vector<Value>{Value(foreignTwoAndThree)}}}));
+    ASSERT_EQ(2, mongod->numQueries);
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    lookup->dispose();
+}
+
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
     auto expCtx = getExpCtx();
     NamespaceString fromNs("test", "foreign");
@@ -125,6 +125,14 @@ public:
     virtual bool allowedToPassthroughFromMongos() const {
         return true;
     }
+
+    /**
+     * Returns true if this stage is able to read from the foreign collection 'nss' when it is
+     * sharded. Only meaningful for namespaces returned by getInvolvedNamespaces().
+     */
+    virtual bool allowShardedForeignCollection(const NamespaceString& nss) const {
+        return false;
+    }
 };
 
 class LiteParsedDocumentSourceDefault final : public LiteParsedDocumentSource {
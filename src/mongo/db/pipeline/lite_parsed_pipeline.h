@@ -120,6 +120,18 @@ public:
         });
     }
 
+    /**
+     * Returns true if every stage which references the foreign namespace 'nss' is able to read
+     * from it when it is sharded.
+     */
+    bool allowShardedForeignCollection(const NamespaceString& nss) const {
+        return std::all_of(_stageSpecs.cbegin(), _stageSpecs.cend(), [&nss](const auto& spec) {
+            const auto involvedNamespaces = spec->getInvolvedNamespaces();
+            return involvedNamespaces.find(nss) == involvedNamespaces.end() ||
+                spec->allowShardedForeignCollection(nss);
+        });
+    }
+
 private:
     std::vector<std::unique_ptr<LiteParsedDocumentSource>> _stageSpecs;
 };
@@ -121,6 +121,22 @@ public:
         _memoryUsage += docSize;
     }
 
+    /**
+     * Insert "key" with no values if it is not already present in the cache, so that a key known
+     * to have no matching documents does not have to be looked up again. An existing entry for
+     * "key" is left untouched.
+     */
+    void insertEmpty(Value key) {
+        size_t middle = size() / 2;
+        auto it = _container.begin();
+        std::advance(it, middle);
+
+        const auto keySize = key.getApproximateSize();
+        if (_container.insert(it, {std::move(key), {}}).second) {
+            _memoryUsage += keySize;
+        }
+    }
+
     /**
      * Evict the least-recently-used item.
      */
@@ -61,6 +61,7 @@
 #include "mongo/db/pipeline/document_source_single_document_transformation.h"
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/collation/collation_spec.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
@@ -73,11 +74,17 @@
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/executor/task_executor_pool.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
+#include "mongo/s/catalog_cache.h"
 #include "mongo/s/chunk_version.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/query/async_results_merger.h"
+#include "mongo/s/query/establish_cursors.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/sock.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -88,6 +95,71 @@ using std::string;
 using std::unique_ptr;
 
 namespace {
+
+// Maximum number of times a query against a sharded foreign collection is retried after a stale
+// shard version error.
+const int kMaxNumStaleVersionRetries = 10;
+
+/**
+ * Opens a cursor for the query 'filter' on every shard which may own a matching document of 'nss'
+ * according to 'routingInfo', and drains all of them.
+ */
+std::vector<Document> queryTargetedShards(OperationContext* opCtx,
+                                          const CachedCollectionRoutingInfo& routingInfo,
+                                          const NamespaceString& nss,
+                                          const BSONObj& filter,
+                                          const BSONObj& collation) {
+    std::set<ShardId> shardIds;
+    if (auto cm = routingInfo.cm()) {
+        cm->getShardIdsForQuery(opCtx, filter, collation, &shardIds);
+    } else {
+        shardIds.insert(routingInfo.primaryId());
+    }
+
+    std::vector<std::pair<ShardId, BSONObj>> requests;
+    for (auto&& shardId : shardIds) {
+        BSONObjBuilder cmdBuilder;
+        cmdBuilder.append("find", nss.coll());
+        cmdBuilder.append("filter", filter);
+        cmdBuilder.append("collation", collation);
+        const auto version =
+            routingInfo.cm() ? routingInfo.cm()->getVersion(shardId) : ChunkVersion::UNSHARDED();
+        version.appendForCommands(&cmdBuilder);
+        requests.emplace_back(shardId, cmdBuilder.obj());
+    }
+
+    auto executor = Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor();
+    const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly);
+
+    ClusterClientCursorParams params(nss, UserNameIterator(), readPref);
+    params.remotes = uassertStatusOK(establishCursors(
+        opCtx, executor, nss, readPref, requests, false /* allowPartialResults */, nullptr));
+
+    AsyncResultsMerger arm(opCtx, executor, &params);
+    auto killGuard = MakeGuard([&] {
+        auto killEvent = arm.kill(opCtx);
+        if (killEvent) {
+            executor->waitForEvent(killEvent);
+        }
+    });
+
+    std::vector<Document> results;
+    while (true) {
+        while (!arm.ready()) {
+            executor->waitForEvent(uassertStatusOK(arm.nextEvent()));
+        }
+
+        auto next = uassertStatusOK(arm.nextReady());
+        if (next.isEOF()) {
+            break;
+        }
+        results.emplace_back(*next.getResult());
+    }
+
+    killGuard.Dismiss();
+    return results;
+}
+
 class MongodImplementation final : public DocumentSourceNeedsMongod::MongodInterface {
 public:
     MongodImplementation(const intrusive_ptr<ExpressionContext>& ctx)
@@ -222,6 +294,49 @@ public:
         return pipeline;
     }
 
+    bool isShardedInCluster(const NamespaceString& nss) final {
+        if (!ShardingState::get(_ctx->opCtx)->enabled()) {
+            return false;
+        }
+
+        auto swRoutingInfo =
+            Grid::get(_ctx->opCtx)->catalogCache()->getCollectionRoutingInfo(_ctx->opCtx, nss);
+        if (swRoutingInfo == ErrorCodes::NamespaceNotFound) {
+            return false;
+        }
+        return bool(uassertStatusOK(std::move(swRoutingInfo)).cm());
+    }
+
+    std::vector<Document> queryShardedCollection(const intrusive_ptr<ExpressionContext>& expCtx,
+                                                 const BSONObj& filter) final {
+        invariant(_ctx->opCtx == expCtx->opCtx);
+
+        // The query must be evaluated with the collation of the aggregation, not the default
+        // collation of the foreign collection.
+        const BSONObj collation = expCtx->getCollator()
+            ? expCtx->getCollator()->getSpec().toBSON()
+            : CollationSpec::kSimpleSpec;
+
+        auto catalogCache = Grid::get(expCtx->opCtx)->catalogCache();
+        for (int numRetries = 0;; ++numRetries) {
+            auto routingInfo =
+                uassertStatusOK(catalogCache->getCollectionRoutingInfo(expCtx->opCtx, expCtx->ns));
+            try {
+                return queryTargetedShards(
+                    expCtx->opCtx, routingInfo, expCtx->ns, filter, collation);
+            } catch (const DBException& ex) {
+                if (!ErrorCodes::isStaleShardingError(ex.code()) ||
+                    numRetries >= kMaxNumStaleVersionRetries) {
+                    throw;
+                }
+
+                LOG(1) << "Retrying query on sharded collection " << expCtx->ns.ns()
+                       << " after stale shard version error: " << redact(ex);
+                catalogCache->onStaleConfigError(std::move(routingInfo));
+            }
+        }
+    }
+
     std::vector<BSONObj> getCurrentOps(CurrentOpConnectionsMode connMode,
                                        CurrentOpUserMode userMode,
                                        CurrentOpTruncateMode truncateMode) const {
@@ -97,6 +97,15 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    bool isShardedInCluster(const NamespaceString& nss) override {
+        MONGO_UNREACHABLE;
+    }
+
+    std::vector<Document> queryShardedCollection(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx, const BSONObj& filter) override {
+        MONGO_UNREACHABLE;
+    }
+
     std::vector<BSONObj> getCurrentOps(CurrentOpConnectionsMode connMode,
                                        CurrentOpUserMode userMode,
                                        CurrentOpTruncateMode truncateMode) const override {
@@ -46,6 +46,19 @@ const char kNsField[] = "ns";
 const char kBatchField[] = "nextBatch";
 const char kBatchFieldInitial[] = "firstBatch";
 
+// Upper bound on the bytes an array element adds beyond the document itself: the type byte and a
+// NUL-terminated decimal index.
+const std::size_t kPerDocumentOverhead = 12;
+
+void reserveBatchBytes(const std::vector<BSONObj>& batch, BufBuilder* bb) {
+    std::size_t bytes = 0;
+    for (const BSONObj& obj : batch) {
+        bytes += obj.objsize() + kPerDocumentOverhead;
+    }
+    bb->reserveBytes(bytes);
+    bb->claimReservedBytes(bytes);
+}
+
 }  // namespace
 
 CursorResponseBuilder::CursorResponseBuilder(bool isInitialResponse,
@@ -55,6 +68,11 @@ CursorResponseBuilder::CursorResponseBuilder(bool isInitialResponse,
       _cursorObject(commandResponse->subobjStart(kCursorField)),
       _batch(_cursorObject.subarrayStart(isInitialResponse ? kBatchFieldInitial : kBatchField)) {}
 
+void CursorResponseBuilder::reserveForBatch(const std::vector<BSONObj>& batch) {
+    invariant(_active);
+    reserveBatchBytes(batch, &_batch.bb());
+}
+
 void CursorResponseBuilder::done(CursorId cursorId, StringData cursorNamespace) {
     invariant(_active);
     _batch.doneFast();
@@ -200,6 +218,7 @@ void CursorResponse::addToBSON(CursorResponse::ResponseType responseType,
     const char* batchFieldName =
         (responseType == ResponseType::InitialResponse) ? kBatchFieldInitial : kBatchField;
     BSONArrayBuilder batchBuilder(cursorBuilder.subarrayStart(batchFieldName));
+    reserveBatchBytes(_batch, &batchBuilder.bb());
     for (const BSONObj& obj : _batch) {
         batchBuilder.append(obj);
     }
@@ -70,6 +70,12 @@ public:
         _batch.append(obj);
     }
 
+    /**
+     * Grows the response buffer once so that every document in 'batch' can then be appended
+     * without the buffer being reallocated and copied as it fills up.
+     */
+    void reserveForBatch(const std::vector<BSONObj>& batch);
+
     /**
      * Call this after successfully appending all fields that will be part of this response.
      * After calling, you may not call any more methods on this object.
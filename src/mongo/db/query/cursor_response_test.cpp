@@ -272,6 +272,27 @@ TEST(CursorResponseTest, addToBSONSubsequentResponse) {
     ASSERT_BSONOBJ_EQ(responseObj, expectedResponse);
 }
 
+TEST(CursorResponseTest, builderReserveForBatchAvoidsReallocation) {
+    std::vector<BSONObj> batch;
+    for (int i = 0; i < 1000; ++i) {
+        batch.push_back(BSON("_id" << i << "padding" << std::string(100, 'x')));
+    }
+
+    BSONObjBuilder builder;
+    CursorResponseBuilder responseBuilder(/*isInitialResponse*/ true, &builder);
+    responseBuilder.reserveForBatch(batch);
+    const void* bufferBeforeAppends = builder.bb().buf();
+    for (const auto& obj : batch) {
+        responseBuilder.append(obj);
+    }
+    ASSERT_EQ(bufferBeforeAppends, static_cast<const void*>(builder.bb().buf()));
+    responseBuilder.done(CursorId(123), "testdb.testcoll");
+
+    BSONObj responseObj = builder.obj();
+    ASSERT_EQ(responseObj["cursor"]["firstBatch"].Obj().nFields(), 1000);
+    ASSERT_EQ(responseObj["cursor"]["id"].Long(), 123);
+}
+
 }  // namespace
 
 }  // namespace mongo
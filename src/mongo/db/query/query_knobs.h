@@ -117,4 +117,11 @@ extern AtomicInt32 internalInsertMaxBatchSize;
 
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
+// The number of input documents whose foreign matches a $lookup fetches from the shards in a single
+// round of requests when its foreign collection is sharded.
+extern AtomicInt32 internalDocumentSourceLookupShardedBatchSize;
+
+// The amount of memory a $lookup may use to cache foreign documents fetched from the shards.
+extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
+
 }  // namespace mongo
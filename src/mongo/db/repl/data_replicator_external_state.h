@@ -106,6 +106,14 @@ public:
                                     const rpc::ReplSetMetadata& replMetadata,
                                     boost::optional<rpc::OplogQueryMetadata> oqMetadata) = 0;
 
+    /**
+     * Forwards the size of a batch of oplog entries fetched from "source" and the time it took to
+     * fetch it to the replication system, which uses it to rate sync sources.
+     */
+    virtual void processFetchStats(const HostAndPort& source,
+                                   std::size_t bytes,
+                                   Milliseconds elapsed) = 0;
+
     /**
      * This function creates an oplog buffer of the type specified at server startup.
      */
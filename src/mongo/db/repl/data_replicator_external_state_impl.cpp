@@ -80,6 +80,12 @@ void DataReplicatorExternalStateImpl::processMetadata(
     }
 }
 
+void DataReplicatorExternalStateImpl::processFetchStats(const HostAndPort& source,
+                                                        std::size_t bytes,
+                                                        Milliseconds elapsed) {
+    _replicationCoordinator->recordSyncSourceFetchStats(source, bytes, elapsed);
+}
+
 bool DataReplicatorExternalStateImpl::shouldStopFetching(
     const HostAndPort& source,
     const rpc::ReplSetMetadata& replMetadata,
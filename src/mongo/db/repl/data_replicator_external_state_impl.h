@@ -59,6 +59,10 @@ public:
                             const rpc::ReplSetMetadata& replMetadata,
                             boost::optional<rpc::OplogQueryMetadata> oqMetadata) override;
 
+    void processFetchStats(const HostAndPort& source,
+                           std::size_t bytes,
+                           Milliseconds elapsed) override;
+
     std::unique_ptr<OplogBuffer> makeInitialSyncOplogBuffer(OperationContext* opCtx) const override;
 
     std::unique_ptr<OplogBuffer> makeSteadyStateOplogBuffer(OperationContext* opCtx) const override;
@@ -80,6 +80,14 @@ bool DataReplicatorExternalStateMock::shouldStopFetching(
     return shouldStopFetchingResult;
 }
 
+void DataReplicatorExternalStateMock::processFetchStats(const HostAndPort& source,
+                                                        std::size_t bytes,
+                                                        Milliseconds elapsed) {
+    lastFetchStatsSource = source;
+    lastFetchStatsBytes = bytes;
+    lastFetchStatsElapsed = elapsed;
+}
+
 std::unique_ptr<OplogBuffer> DataReplicatorExternalStateMock::makeInitialSyncOplogBuffer(
     OperationContext* opCtx) const {
     return stdx::make_unique<OplogBufferBlockingQueue>();
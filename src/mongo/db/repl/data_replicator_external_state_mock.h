@@ -56,6 +56,10 @@ public:
                             const rpc::ReplSetMetadata& replMetadata,
                             boost::optional<rpc::OplogQueryMetadata> oqMetadata) override;
 
+    void processFetchStats(const HostAndPort& source,
+                           std::size_t bytes,
+                           Milliseconds elapsed) override;
+
     std::unique_ptr<OplogBuffer> makeInitialSyncOplogBuffer(OperationContext* opCtx) const override;
 
     std::unique_ptr<OplogBuffer> makeSteadyStateOplogBuffer(OperationContext* opCtx) const override;
@@ -85,6 +89,11 @@ public:
     // Returned by shouldStopFetching.
     bool shouldStopFetchingResult = false;
 
+    // Set by processFetchStats.
+    HostAndPort lastFetchStatsSource;
+    std::size_t lastFetchStatsBytes = 0;
+    Milliseconds lastFetchStatsElapsed{0};
+
     // Override to change multiApply behavior.
     MultiApplier::MultiApplyFn multiApplyFn;
 
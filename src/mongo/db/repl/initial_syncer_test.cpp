@@ -135,6 +135,11 @@ public:
     void blacklistSyncSource(const HostAndPort& host, Date_t until) override {
         _syncSourceSelector->blacklistSyncSource(host, until);
     }
+    void recordSyncSourceFetchStats(const HostAndPort& host,
+                                    std::size_t bytes,
+                                    Milliseconds elapsed) override {
+        _syncSourceSelector->recordSyncSourceFetchStats(host, bytes, elapsed);
+    }
     bool shouldChangeSyncSource(const HostAndPort& currentSource,
                                 const rpc::ReplSetMetadata& replMetadata,
                                 boost::optional<rpc::OplogQueryMetadata> oqMetadata) override {
@@ -160,6 +160,12 @@ public:
      * Returns the item most recently added to the oplog buffer or nothing if the buffer is empty.
      */
     virtual boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const = 0;
+
+    /**
+     * Releases the storage still held by operations that have already been popped. Buffers that
+     * free operations as soon as they are popped do not need to override this.
+     */
+    virtual void discardPopped(OperationContext* opCtx) {}
 };
 
 }  // namespace repl
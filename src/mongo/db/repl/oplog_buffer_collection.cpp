@@ -270,6 +270,16 @@ boost::optional<OplogBuffer::Value> OplogBufferCollection::lastObjectPushed(
     return boost::none;
 }
 
+void OplogBufferCollection::discardPopped(OperationContext* opCtx) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_lastPoppedKey.isEmpty()) {
+        return;
+    }
+    // Popped documents are skipped using '_lastPoppedKey', which stays valid after they are gone.
+    auto filter = BSON(kIdFieldName << BSON("$lte" << _lastPoppedKey.firstElement()));
+    fassertStatusOK(40622, _storageInterface->deleteByFilter(opCtx, _nss, filter));
+}
+
 boost::optional<OplogBuffer::Value> OplogBufferCollection::_lastDocumentPushed_inlock(
     OperationContext* opCtx) const {
     if (_count == 0) {
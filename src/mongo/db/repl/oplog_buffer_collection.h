@@ -132,6 +132,7 @@ public:
     bool waitForData(Seconds waitDuration) override;
     bool peek(OperationContext* opCtx, Value* value) override;
     boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+    void discardPopped(OperationContext* opCtx) override;
 
     // ---- Testing API ----
     std::size_t getSentinelCount_forTest() const;
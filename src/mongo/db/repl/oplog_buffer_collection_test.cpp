@@ -594,6 +594,37 @@ TEST_F(OplogBufferCollectionTest, PopDoesNotRemoveDocumentFromCollection) {
     _assertDocumentsInCollectionEquals(_opCtx.get(), nss, {oplog});
 }
 
+TEST_F(OplogBufferCollectionTest, DiscardPoppedRemovesOnlyPoppedDocumentsFromCollection) {
+    auto nss = makeNamespace(_agent);
+    OplogBufferCollection oplogBuffer(_storageInterface, nss);
+
+    oplogBuffer.startup(_opCtx.get());
+    const std::vector<BSONObj> oplog = {
+        makeOplogEntry(1), makeOplogEntry(2), makeOplogEntry(3),
+    };
+    oplogBuffer.pushAllNonBlocking(_opCtx.get(), oplog.begin(), oplog.end());
+
+    // Nothing popped yet.
+    oplogBuffer.discardPopped(_opCtx.get());
+    _assertDocumentsInCollectionEquals(_opCtx.get(), nss, oplog);
+
+    BSONObj doc;
+    ASSERT_TRUE(oplogBuffer.tryPop(_opCtx.get(), &doc));
+    ASSERT_TRUE(oplogBuffer.tryPop(_opCtx.get(), &doc));
+    oplogBuffer.discardPopped(_opCtx.get());
+    ASSERT_EQUALS(oplogBuffer.getCount(), 1UL);
+    _assertDocumentsInCollectionEquals(_opCtx.get(), nss, {oplog[2]});
+
+    // The buffer keeps reading and accepting documents after the popped ones are gone.
+    oplogBuffer.push(_opCtx.get(), makeOplogEntry(4));
+    ASSERT_TRUE(oplogBuffer.tryPop(_opCtx.get(), &doc));
+    ASSERT_BSONOBJ_EQ(doc, oplog[2]);
+    ASSERT_TRUE(oplogBuffer.tryPop(_opCtx.get(), &doc));
+    ASSERT_BSONOBJ_EQ(doc, makeOplogEntry(4));
+    oplogBuffer.discardPopped(_opCtx.get());
+    _assertDocumentsInCollectionEquals(_opCtx.get(), nss, {});
+}
+
 TEST_F(OplogBufferCollectionTest, PopWithNoDocumentsReturnsFalse) {
     auto nss = makeNamespace(_agent);
     OplogBufferCollection oplogBuffer(_storageInterface, nss);
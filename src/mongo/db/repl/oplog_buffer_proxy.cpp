@@ -155,6 +155,10 @@ boost::optional<OplogBuffer::Value> OplogBufferProxy::lastObjectPushed(
     return *_lastPushed;
 }
 
+void OplogBufferProxy::discardPopped(OperationContext* opCtx) {
+    _target->discardPopped(opCtx);
+}
+
 boost::optional<OplogBuffer::Value> OplogBufferProxy::getLastPeeked_forTest() const {
     stdx::lock_guard<stdx::mutex> lk(_lastPeekedMutex);
     return _lastPeeked;
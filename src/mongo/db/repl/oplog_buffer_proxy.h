@@ -72,6 +72,7 @@ public:
     bool waitForData(Seconds waitDuration) override;
     bool peek(OperationContext* opCtx, Value* value) override;
     boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+    void discardPopped(OperationContext* opCtx) override;
 
     // ---- Testing API ----
     boost::optional<Value> getLastPeeked_forTest() const;
@@ -0,0 +1,278 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_spillable.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// Number and size of the oplog entries written to the spill buffer since startup.
+Counter64 spilledCountCounter;
+ServerStatusMetricField<Counter64> displaySpilledCount("repl.buffer.spilledCount",
+                                                       &spilledCountCounter);
+Counter64 spilledSizeCounter;
+ServerStatusMetricField<Counter64> displaySpilledSize("repl.buffer.spilledSizeBytes",
+                                                      &spilledSizeCounter);
+
+std::size_t getDocumentSize(const BSONObj& o) {
+    return static_cast<std::size_t>(o.objsize());
+}
+
+}  // namespace
+
+OplogBufferSpillable::OplogBufferSpillable(std::unique_ptr<OplogBuffer> spillBuffer,
+                                           Options options)
+    : _spillBuffer(std::move(spillBuffer)), _options(std::move(options)) {
+    invariant(_spillBuffer);
+    invariant(_options.maxMemorySize > 0);
+}
+
+OplogBuffer* OplogBufferSpillable::getSpillBuffer() const {
+    return _spillBuffer.get();
+}
+
+OplogBufferSpillable::Options OplogBufferSpillable::getOptions() const {
+    return _options;
+}
+
+void OplogBufferSpillable::startup(OperationContext* opCtx) {
+    _spillBuffer->startup(opCtx);
+}
+
+void OplogBufferSpillable::shutdown(OperationContext* opCtx) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _memory.clear();
+        _memorySize = 0;
+        _spilledCount = 0;
+        _spilledSize = 0;
+        _lastPushed = boost::none;
+    }
+    _spillBuffer->shutdown(opCtx);
+}
+
+void OplogBufferSpillable::pushEvenIfFull(OperationContext* opCtx, const Value& value) {
+    Batch valueBatch = {value};
+    pushAllNonBlocking(opCtx, valueBatch.begin(), valueBatch.end());
+}
+
+void OplogBufferSpillable::push(OperationContext* opCtx, const Value& value) {
+    pushEvenIfFull(opCtx, value);
+}
+
+void OplogBufferSpillable::pushAllNonBlocking(OperationContext* opCtx,
+                                              Batch::const_iterator begin,
+                                              Batch::const_iterator end) {
+    if (begin == end) {
+        return;
+    }
+
+    auto it = begin;
+    std::size_t spilledCount = 0;
+    std::size_t spilledSize = 0;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        // Entries may only go into memory while nothing is spilled, otherwise they would be popped
+        // ahead of older spilled entries. Since there is a single pusher, nothing can be spilled
+        // concurrently with this check.
+        if (_spilledCount == 0) {
+            for (; it != end; ++it) {
+                auto size = getDocumentSize(*it);
+                if (_memorySize + size > _options.maxMemorySize && !_memory.empty()) {
+                    break;
+                }
+                _memory.push_back(*it);
+                _memorySize += size;
+            }
+        }
+
+        _lastPushed = *std::prev(end);
+        if (it == end) {
+            _cvNoLongerEmpty.notify_all();
+            return;
+        }
+
+        // Account for the entries before they reach the spill buffer, so that a concurrent refill
+        // never reads back more entries than are counted as spilled. A refill which runs before
+        // they are written reads back fewer.
+        spilledCount = std::distance(it, end);
+        for (auto spilled = it; spilled != end; ++spilled) {
+            spilledSize += getDocumentSize(*spilled);
+        }
+        _spilledCount += spilledCount;
+        _spilledSize += spilledSize;
+    }
+
+    LOG(3) << "spilling " << spilledCount << " oplog entries (" << spilledSize
+           << " bytes) out of memory";
+    _spillBuffer->pushAllNonBlocking(opCtx, it, end);
+    spilledCountCounter.increment(spilledCount);
+    spilledSizeCounter.increment(spilledSize);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _cvNoLongerEmpty.notify_all();
+}
+
+void OplogBufferSpillable::waitForSpace(OperationContext* opCtx, std::size_t size) {}
+
+bool OplogBufferSpillable::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memory.empty() && _spilledCount == 0;
+}
+
+std::size_t OplogBufferSpillable::getMaxSize() const {
+    return 0;
+}
+
+std::size_t OplogBufferSpillable::getSize() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memorySize + _spilledSize;
+}
+
+std::size_t OplogBufferSpillable::getCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memory.size() + _spilledCount;
+}
+
+void OplogBufferSpillable::clear(OperationContext* opCtx) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _memory.clear();
+        _memorySize = 0;
+        _spilledCount = 0;
+        _spilledSize = 0;
+        _lastPushed = boost::none;
+    }
+    _spillBuffer->clear(opCtx);
+}
+
+bool OplogBufferSpillable::tryPop(OperationContext* opCtx, Value* value) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_memory.empty()) {
+        _refillFromSpillBuffer(opCtx, &lk);
+        if (_memory.empty()) {
+            return false;
+        }
+    }
+    *value = std::move(_memory.front());
+    _memory.pop_front();
+    invariant(_memorySize >= getDocumentSize(*value));
+    _memorySize -= getDocumentSize(*value);
+    if (_memory.empty() && _spilledCount == 0) {
+        _lastPushed = boost::none;
+    }
+    return true;
+}
+
+bool OplogBufferSpillable::waitForData(Seconds waitDuration) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    return _cvNoLongerEmpty.wait_for(lk, waitDuration.toSystemDuration(), [&]() {
+        return !_memory.empty() || _spilledCount > 0;
+    });
+}
+
+bool OplogBufferSpillable::peek(OperationContext* opCtx, Value* value) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_memory.empty()) {
+        _refillFromSpillBuffer(opCtx, &lk);
+        if (_memory.empty()) {
+            return false;
+        }
+    }
+    *value = _memory.front();
+    return true;
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferSpillable::lastObjectPushed(
+    OperationContext* opCtx) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _lastPushed;
+}
+
+void OplogBufferSpillable::_refillFromSpillBuffer(OperationContext* opCtx,
+                                                  stdx::unique_lock<stdx::mutex>* lk) {
+    invariant(_memory.empty());
+    if (_spilledCount == 0) {
+        return;
+    }
+
+    // The pusher keeps spilling while '_spilledCount' is non-zero, so nothing can enter memory
+    // while the lock is released.
+    lk->unlock();
+    const auto refillSize = _options.refillSize > 0
+        ? _options.refillSize
+        : std::max<std::size_t>(1U, _options.maxMemorySize / 2);
+    std::deque<Value> refilled;
+    std::size_t refilledSize = 0;
+    Value value;
+    while (refilledSize < refillSize && _spillBuffer->tryPop(opCtx, &value)) {
+        refilledSize += getDocumentSize(value);
+        refilled.push_back(std::move(value));
+    }
+
+    // Release the storage of the entries that have been read back so the spill buffer does not
+    // grow without bound, while reusing it for later spills.
+    _spillBuffer->discardPopped(opCtx);
+    lk->lock();
+
+    invariant(_memory.empty());
+    invariant(_spilledCount >= refilled.size());
+    invariant(_spilledSize >= refilledSize);
+    _spilledCount -= refilled.size();
+    _spilledSize -= refilledSize;
+    _memory = std::move(refilled);
+    _memorySize = refilledSize;
+}
+
+std::size_t OplogBufferSpillable::getMemoryCount_forTest() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memory.size();
+}
+
+std::size_t OplogBufferSpillable::getMemorySize_forTest() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memorySize;
+}
+
+}  // namespace repl
+}  // namespace mongo
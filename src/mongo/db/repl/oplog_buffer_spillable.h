@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Oplog buffer that keeps the oldest oplog entries (the head of the buffer) in memory and spills
+ * newer entries to a secondary oplog buffer (typically an OplogBufferCollection) once the in-memory
+ * portion reaches its size limit. This allows the fetcher to keep pulling oplog entries from the
+ * sync source while the appliers are lagging, without blocking on buffer space.
+ *
+ * Ordering is preserved by never pushing into memory while the spill buffer is non-empty: all
+ * in-memory entries always precede all spilled entries. Once the in-memory portion is drained, a
+ * batch of entries is read back from the spill buffer into memory, and the storage held by the
+ * entries read back is released.
+ *
+ * The spill buffer is only written and read without holding '_mutex', so that the applier popping
+ * from memory never waits on spill I/O done by the fetcher.
+ *
+ * Supports one pusher and one popper.
+ */
+class OplogBufferSpillable final : public OplogBuffer {
+    MONGO_DISALLOW_COPYING(OplogBufferSpillable);
+
+public:
+    /**
+     * Structure used to configure an instance of OplogBufferSpillable.
+     */
+    struct Options {
+        // Maximum total size of the entries held in memory before spilling to the spill buffer.
+        std::size_t maxMemorySize = 256 * 1024 * 1024;
+        // Size of the entries read back into memory from the spill buffer at a time. If equal to 0,
+        // half of 'maxMemorySize' is used.
+        std::size_t refillSize = 0;
+        Options() {}
+    };
+
+    explicit OplogBufferSpillable(std::unique_ptr<OplogBuffer> spillBuffer,
+                                  Options options = Options());
+
+    /**
+     * Returns the buffer used to hold entries that do not fit in memory.
+     */
+    OplogBuffer* getSpillBuffer() const;
+
+    /**
+     * Returns the options used to configure this OplogBufferSpillable.
+     */
+    Options getOptions() const;
+
+    void startup(OperationContext* opCtx) override;
+    void shutdown(OperationContext* opCtx) override;
+    void pushEvenIfFull(OperationContext* opCtx, const Value& value) override;
+    void push(OperationContext* opCtx, const Value& value) override;
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* opCtx) override;
+    bool tryPop(OperationContext* opCtx, Value* value) override;
+    bool waitForData(Seconds waitDuration) override;
+    bool peek(OperationContext* opCtx, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+
+    // ---- Testing API ----
+    std::size_t getMemoryCount_forTest() const;
+    std::size_t getMemorySize_forTest() const;
+
+private:
+    /**
+     * Moves entries from the front of the spill buffer into memory, up to the refill size.
+     * Releases 'lk' while reading from the spill buffer.
+     * Assumes the in-memory portion of the buffer is empty.
+     */
+    void _refillFromSpillBuffer(OperationContext* opCtx, stdx::unique_lock<stdx::mutex>* lk);
+
+    // Holds entries that do not fit in memory. Not protected by _mutex: it is only written by the
+    // pusher and only read by the popper, and supports both concurrently.
+    const std::unique_ptr<OplogBuffer> _spillBuffer;
+
+    // These are the options with which the oplog buffer was configured at construction time.
+    const Options _options;
+
+    // Allows functions to wait until the buffer has data. This condition variable is used with
+    // _mutex below.
+    stdx::condition_variable _cvNoLongerEmpty;
+
+    // Protects member data below and serializes access to the spill buffer.
+    mutable stdx::mutex _mutex;
+
+    // Oldest entries in the buffer.
+    std::deque<Value> _memory;
+
+    // Total size of the entries in '_memory'.
+    std::size_t _memorySize = 0;
+
+    // Number and total size of the entries that have been written to the spill buffer and not
+    // yet read back. New entries go to memory only while '_spilledCount' is 0.
+    std::size_t _spilledCount = 0;
+    std::size_t _spilledSize = 0;
+
+    // Most recently pushed entry, regardless of where it was stored.
+    boost::optional<Value> _lastPushed;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,361 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/optional/optional_io.hpp>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/oplog_buffer_proxy.h"
+#include "mongo/db/repl/oplog_buffer_spillable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+BSONObj makeEntry(int i) {
+    return BSON("ts" << Timestamp(Seconds(i), 0) << "x" << i);
+}
+
+class OplogBufferSpillableTest : public unittest::Test {
+private:
+    void setUp() override;
+    void tearDown() override;
+
+protected:
+    /**
+     * Pops every entry in the buffer and checks that they come out in the order they were
+     * pushed, starting at 'first'. Returns the number of entries popped.
+     */
+    int popAllAndCheckOrder(int first);
+
+    OplogBuffer* _spillBuffer = nullptr;
+    std::unique_ptr<OplogBufferSpillable> _buffer;
+    OperationContext* _opCtx = nullptr;  // Not dereferenced.
+};
+
+void OplogBufferSpillableTest::setUp() {
+    auto spillBuffer = stdx::make_unique<OplogBufferBlockingQueue>();
+    _spillBuffer = spillBuffer.get();
+
+    // Room for exactly two entries in memory.
+    OplogBufferSpillable::Options options;
+    options.maxMemorySize = 2 * std::size_t(makeEntry(0).objsize());
+    options.refillSize = options.maxMemorySize;
+    _buffer = stdx::make_unique<OplogBufferSpillable>(std::move(spillBuffer), options);
+    _buffer->startup(_opCtx);
+}
+
+void OplogBufferSpillableTest::tearDown() {
+    _buffer->shutdown(_opCtx);
+    _buffer.reset();
+    _spillBuffer = nullptr;
+}
+
+int OplogBufferSpillableTest::popAllAndCheckOrder(int first) {
+    int expected = first;
+    OplogBuffer::Value value;
+    while (_buffer->tryPop(_opCtx, &value)) {
+        ASSERT_BSONOBJ_EQ(makeEntry(expected), value);
+        ++expected;
+    }
+    return expected - first;
+}
+
+DEATH_TEST(OplogBufferSpillableDeathTest,
+           NullSpillBufferAtConstructionTriggersInvariant,
+           "Invariant failure _spillBuffer") {
+    OplogBufferSpillable(nullptr);
+}
+
+TEST_F(OplogBufferSpillableTest, GetSpillBuffer) {
+    ASSERT_EQUALS(_spillBuffer, _buffer->getSpillBuffer());
+}
+
+TEST_F(OplogBufferSpillableTest, HasNoSizeConstraints) {
+    ASSERT_EQUALS(0U, _buffer->getMaxSize());
+}
+
+TEST_F(OplogBufferSpillableTest, EntriesThatFitInMemoryAreNotSpilled) {
+    OplogBuffer::Batch values = {makeEntry(1), makeEntry(2)};
+    _buffer->pushAllNonBlocking(_opCtx, values.cbegin(), values.cend());
+    ASSERT_EQUALS(2U, _buffer->getMemoryCount_forTest());
+    ASSERT_TRUE(_spillBuffer->isEmpty());
+    ASSERT_EQUALS(2U, _buffer->getCount());
+    ASSERT_EQUALS(std::size_t(values[0].objsize() + values[1].objsize()), _buffer->getSize());
+}
+
+TEST_F(OplogBufferSpillableTest, EntriesThatDoNotFitInMemoryAreSpilled) {
+    OplogBuffer::Batch values = {makeEntry(1), makeEntry(2), makeEntry(3), makeEntry(4)};
+    _buffer->pushAllNonBlocking(_opCtx, values.cbegin(), values.cend());
+    ASSERT_EQUALS(2U, _buffer->getMemoryCount_forTest());
+    ASSERT_EQUALS(2U, _spillBuffer->getCount());
+    ASSERT_EQUALS(4U, _buffer->getCount());
+    ASSERT_FALSE(_buffer->isEmpty());
+
+    auto lastObjPushed = _buffer->lastObjectPushed(_opCtx);
+    ASSERT_NOT_EQUALS(boost::none, lastObjPushed);
+    ASSERT_BSONOBJ_EQ(values.back(), *lastObjPushed);
+}
+
+TEST_F(OplogBufferSpillableTest, PushGoesToSpillBufferWhileEntriesAreSpilled) {
+    for (int i = 1; i <= 3; ++i) {
+        _buffer->push(_opCtx, makeEntry(i));
+    }
+    ASSERT_EQUALS(1U, _spillBuffer->getCount());
+
+    // Popping frees up memory, but new entries must still queue up behind the spilled one.
+    OplogBuffer::Value value;
+    ASSERT_TRUE(_buffer->tryPop(_opCtx, &value));
+    ASSERT_BSONOBJ_EQ(makeEntry(1), value);
+    _buffer->push(_opCtx, makeEntry(4));
+    ASSERT_EQUALS(1U, _buffer->getMemoryCount_forTest());
+    ASSERT_EQUALS(2U, _spillBuffer->getCount());
+
+    ASSERT_EQUALS(3, popAllAndCheckOrder(2));
+    ASSERT_TRUE(_buffer->isEmpty());
+}
+
+TEST_F(OplogBufferSpillableTest, PopReadsBackSpilledEntriesInOrder) {
+    OplogBuffer::Batch values;
+    for (int i = 1; i <= 10; ++i) {
+        values.push_back(makeEntry(i));
+    }
+    _buffer->pushAllNonBlocking(_opCtx, values.cbegin(), values.cend());
+    ASSERT_EQUALS(8U, _spillBuffer->getCount());
+
+    ASSERT_EQUALS(10, popAllAndCheckOrder(1));
+    ASSERT_TRUE(_buffer->isEmpty());
+    ASSERT_TRUE(_spillBuffer->isEmpty());
+    ASSERT_EQUALS(0U, _buffer->getSize());
+    ASSERT_EQUALS(boost::none, _buffer->lastObjectPushed(_opCtx));
+}
+
+TEST_F(OplogBufferSpillableTest, PeekReadsBackSpilledEntries) {
+    for (int i = 1; i <= 3; ++i) {
+        _buffer->push(_opCtx, makeEntry(i));
+    }
+    OplogBuffer::Value value;
+    ASSERT_TRUE(_buffer->tryPop(_opCtx, &value));
+    ASSERT_TRUE(_buffer->tryPop(_opCtx, &value));
+    ASSERT_EQUALS(0U, _buffer->getMemoryCount_forTest());
+
+    ASSERT_TRUE(_buffer->peek(_opCtx, &value));
+    ASSERT_BSONOBJ_EQ(makeEntry(3), value);
+    ASSERT_EQUALS(1U, _buffer->getMemoryCount_forTest());
+    ASSERT_TRUE(_spillBuffer->isEmpty());
+}
+
+TEST_F(OplogBufferSpillableTest, PushGoesToMemoryAgainOnceSpillBufferIsDrained) {
+    for (int i = 1; i <= 3; ++i) {
+        _buffer->push(_opCtx, makeEntry(i));
+    }
+    ASSERT_EQUALS(3, popAllAndCheckOrder(1));
+
+    _buffer->push(_opCtx, makeEntry(4));
+    ASSERT_EQUALS(1U, _buffer->getMemoryCount_forTest());
+    ASSERT_TRUE(_spillBuffer->isEmpty());
+}
+
+TEST_F(OplogBufferSpillableTest, EmptyBufferDoesNotReturnData) {
+    OplogBuffer::Value value;
+    ASSERT_FALSE(_buffer->peek(_opCtx, &value));
+    ASSERT_FALSE(_buffer->tryPop(_opCtx, &value));
+    ASSERT_FALSE(_buffer->waitForData(Seconds(0)));
+}
+
+TEST_F(OplogBufferSpillableTest, WaitForDataReturnsTrueWhenOnlySpilledEntriesRemain) {
+    for (int i = 1; i <= 3; ++i) {
+        _buffer->push(_opCtx, makeEntry(i));
+    }
+    ASSERT_TRUE(_buffer->waitForData(Seconds(0)));
+}
+
+TEST_F(OplogBufferSpillableTest, ClearDiscardsMemoryAndSpilledEntries) {
+    for (int i = 1; i <= 5; ++i) {
+        _buffer->push(_opCtx, makeEntry(i));
+    }
+    _buffer->clear(_opCtx);
+    ASSERT_TRUE(_buffer->isEmpty());
+    ASSERT_TRUE(_spillBuffer->isEmpty());
+    ASSERT_EQUALS(0U, _buffer->getMemorySize_forTest());
+    ASSERT_EQUALS(boost::none, _buffer->lastObjectPushed(_opCtx));
+}
+
+/**
+ * Spill buffer that runs a callback whenever it is written or read and another once a write has
+ * completed, and counts the calls to discardPopped().
+ */
+class InstrumentedSpillBuffer : public OplogBufferProxy {
+public:
+    using OplogBufferProxy::OplogBufferProxy;
+
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override {
+        onAccess();
+        OplogBufferProxy::pushAllNonBlocking(opCtx, begin, end);
+        onPushed();
+    }
+
+    bool tryPop(OperationContext* opCtx, Value* value) override {
+        onAccess();
+        return OplogBufferProxy::tryPop(opCtx, value);
+    }
+
+    void discardPopped(OperationContext* opCtx) override {
+        ++discardCount;
+    }
+
+    stdx::function<void()> onAccess = [] {};
+    stdx::function<void()> onPushed = [] {};
+    int discardCount = 0;
+};
+
+TEST(OplogBufferSpillableIOTest, SpillBufferIsAccessedWithoutHoldingTheBufferLock) {
+    auto spillBuffer =
+        stdx::make_unique<InstrumentedSpillBuffer>(stdx::make_unique<OplogBufferBlockingQueue>());
+    auto spillBufferPtr = spillBuffer.get();
+    OplogBufferSpillable::Options options;
+    options.maxMemorySize = std::size_t(makeEntry(0).objsize());
+    OplogBufferSpillable buffer(std::move(spillBuffer), options);
+    OperationContext* opCtx = nullptr;  // Not dereferenced.
+    buffer.startup(opCtx);
+
+    // The callback would deadlock if the spill buffer were used under the buffer's mutex.
+    int accesses = 0;
+    spillBufferPtr->onAccess = [&] {
+        buffer.getCount();
+        ++accesses;
+    };
+
+    OplogBuffer::Batch values = {makeEntry(1), makeEntry(2), makeEntry(3)};
+    buffer.pushAllNonBlocking(opCtx, values.cbegin(), values.cend());
+    ASSERT_EQUALS(1, accesses);
+    ASSERT_EQUALS(3U, buffer.getCount());
+
+    OplogBuffer::Value value;
+    for (int i = 1; i <= 3; ++i) {
+        ASSERT_TRUE(buffer.tryPop(opCtx, &value));
+        ASSERT_BSONOBJ_EQ(makeEntry(i), value);
+    }
+    ASSERT_TRUE(buffer.isEmpty());
+
+    // Every refill releases the spilled entries it read back instead of dropping the spill buffer.
+    ASSERT_EQUALS(2, spillBufferPtr->discardCount);
+    buffer.shutdown(opCtx);
+}
+
+TEST(OplogBufferSpillableIOTest, RefillWhileSpillingReadsBackOnlyCountedEntries) {
+    auto spillBuffer =
+        stdx::make_unique<InstrumentedSpillBuffer>(stdx::make_unique<OplogBufferBlockingQueue>());
+    auto spillBufferPtr = spillBuffer.get();
+    OplogBufferSpillable::Options options;
+    options.maxMemorySize = std::size_t(makeEntry(0).objsize());
+    options.refillSize = 10 * options.maxMemorySize;
+    OplogBufferSpillable buffer(std::move(spillBuffer), options);
+    OperationContext* opCtx = nullptr;  // Not dereferenced.
+    buffer.startup(opCtx);
+
+    OplogBuffer::Batch values = {makeEntry(1), makeEntry(2)};
+    buffer.pushAllNonBlocking(opCtx, values.cbegin(), values.cend());
+    OplogBuffer::Value value;
+    ASSERT_TRUE(buffer.tryPop(opCtx, &value));
+    ASSERT_BSONOBJ_EQ(makeEntry(1), value);
+
+    // Pop while the pusher is about to write the next entry to the spill buffer, and once it has
+    // written it but not returned yet. The refill reads from the spill buffer too, so the first
+    // callback must only pop once.
+    bool poppedBeforeWrite = false;
+    spillBufferPtr->onAccess = [&] {
+        if (poppedBeforeWrite) {
+            return;
+        }
+        poppedBeforeWrite = true;
+        ASSERT_TRUE(buffer.tryPop(opCtx, &value));
+        ASSERT_BSONOBJ_EQ(makeEntry(2), value);
+        ASSERT_EQUALS(1U, buffer.getCount());
+    };
+    spillBufferPtr->onPushed = [&] {
+        ASSERT_EQUALS(1U, buffer.getCount());
+        ASSERT_TRUE(buffer.tryPop(opCtx, &value));
+        ASSERT_BSONOBJ_EQ(makeEntry(3), value);
+    };
+    buffer.push(opCtx, makeEntry(3));
+    ASSERT_TRUE(poppedBeforeWrite);
+    ASSERT_TRUE(buffer.isEmpty());
+    ASSERT_EQUALS(0U, buffer.getSize());
+    buffer.shutdown(opCtx);
+}
+
+TEST(OplogBufferSpillableIOTest, ConcurrentPushAndPopAcrossSpillThreshold) {
+    OplogBufferSpillable::Options options;
+    options.maxMemorySize = 4 * std::size_t(makeEntry(0).objsize());
+    OplogBufferSpillable buffer(stdx::make_unique<OplogBufferBlockingQueue>(), options);
+    OperationContext* opCtx = nullptr;  // Not dereferenced.
+    buffer.startup(opCtx);
+
+    // Pushes in batches of varying size so that entries go back and forth between memory and the
+    // spill buffer while the other thread pops.
+    const int numEntries = 20000;
+    stdx::thread pusher([&] {
+        int next = 0;
+        while (next < numEntries) {
+            OplogBuffer::Batch values;
+            for (int i = 0; i < 1 + next % 7 && next < numEntries; ++i) {
+                values.push_back(makeEntry(next++));
+            }
+            buffer.pushAllNonBlocking(opCtx, values.cbegin(), values.cend());
+        }
+    });
+
+    int expected = 0;
+    OplogBuffer::Value value;
+    while (expected < numEntries) {
+        if (!buffer.tryPop(opCtx, &value)) {
+            buffer.waitForData(Seconds(1));
+            continue;
+        }
+        ASSERT_BSONOBJ_EQ(makeEntry(expected), value);
+        ++expected;
+    }
+    pusher.join();
+
+    ASSERT_TRUE(buffer.isEmpty());
+    ASSERT_EQUALS(0U, buffer.getSize());
+    buffer.shutdown(opCtx);
+}
+
+}  // namespace
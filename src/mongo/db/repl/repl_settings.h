@@ -39,6 +39,8 @@ namespace repl {
 
 extern int maxSyncSourceLagSecs;
 extern double replElectionTimeoutOffsetLimitFraction;
+extern bool syncSourceSelectionUsesThroughput;
+extern int syncSourceReselectionMinIntervalSecs;
 
 class ReplSettings {
 public:
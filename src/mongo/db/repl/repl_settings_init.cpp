@@ -37,6 +37,8 @@ namespace repl {
 
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(maxSyncSourceLagSecs, int, 30);
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replElectionTimeoutOffsetLimitFraction, double, 0.15);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(syncSourceSelectionUsesThroughput, bool, false);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(syncSourceReselectionMinIntervalSecs, int, 60);
 
 MONGO_INITIALIZER(replSettingsCheck)(InitializerContext*) {
     if (maxSyncSourceLagSecs < 1) {
@@ -45,6 +47,9 @@ MONGO_INITIALIZER(replSettingsCheck)(InitializerContext*) {
     if (replElectionTimeoutOffsetLimitFraction <= 0.01) {
         return Status(ErrorCodes::BadValue, "electionTimeoutOffsetLimitFraction must be > 0.01");
     }
+    if (syncSourceReselectionMinIntervalSecs < 0) {
+        return Status(ErrorCodes::BadValue, "syncSourceReselectionMinIntervalSecs must be >= 0");
+    }
     return Status::OK();
 }
 }
@@ -63,6 +63,7 @@
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 #include "mongo/db/repl/oplog_buffer_collection.h"
 #include "mongo/db/repl/oplog_buffer_proxy.h"
+#include "mongo/db/repl/oplog_buffer_spillable.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/repl/replication_process.h"
@@ -121,6 +122,13 @@ const char tsFieldName[] = "ts";
 
 const char kCollectionOplogBufferName[] = "collection";
 const char kBlockingQueueOplogBufferName[] = "inMemoryBlockingQueue";
+const char kSpillableOplogBufferName[] = "spillable";
+
+// Collection used by the steady state oplog buffer to hold entries that do not fit in memory.
+const char kSteadyStateOplogBufferSpillNamespace[] = "local.temp_oplog_buffer_steady_state";
+
+// Number of documents read ahead at a time from the steady state oplog buffer spill collection.
+const std::size_t kSteadyStateOplogBufferSpillPeekCacheSize = 10000;
 
 // Set this to true to force background creation of snapshots even if --enableMajorityReadConcern
 // isn't specified. This can be used for A-B benchmarking to find how much overhead
@@ -136,6 +144,19 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBuffer,
 // Set this to specify size of read ahead buffer in the OplogBufferCollection.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBufferPeekCacheSize, int, 10000);
 
+// Set this to specify whether the oplog buffer used during steady state replication may spill oplog
+// entries that do not fit in memory to a local collection, so that the oplog fetcher can keep
+// fetching while the appliers are lagging.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(steadyStateOplogBuffer,
+                                      std::string,
+                                      kBlockingQueueOplogBufferName);
+
+// Set this to specify the maximum size of the in-memory portion of the spillable steady state oplog
+// buffer.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(steadyStateOplogBufferMaxMemoryBytes,
+                                      long long,
+                                      256 * 1024 * 1024);
+
 // Set this to specify maximum number of times the oplog fetcher will consecutively restart the
 // oplog tailing query on non-cancellation errors.
 server_parameter_storage_type<int, ServerParameterType::kStartupAndRuntime>::value_type
@@ -172,6 +193,19 @@ MONGO_INITIALIZER(initialSyncOplogBuffer)(InitializerContext*) {
     return Status::OK();
 }
 
+MONGO_INITIALIZER(steadyStateOplogBuffer)(InitializerContext*) {
+    if ((steadyStateOplogBuffer != kSpillableOplogBufferName) &&
+        (steadyStateOplogBuffer != kBlockingQueueOplogBufferName)) {
+        return Status(ErrorCodes::BadValue,
+                      "unsupported steady state oplog buffer option: " + steadyStateOplogBuffer);
+    }
+    if (steadyStateOplogBufferMaxMemoryBytes <= 0) {
+        return Status(ErrorCodes::BadValue,
+                      "steadyStateOplogBufferMaxMemoryBytes must be greater than 0");
+    }
+    return Status::OK();
+}
+
 /**
  * Returns new thread pool for thread pool task executor.
  */
@@ -889,7 +923,20 @@ std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeInitia
 
 std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeSteadyStateOplogBuffer(
     OperationContext* opCtx) const {
-    return stdx::make_unique<OplogBufferBlockingQueue>();
+    if (steadyStateOplogBuffer == kSpillableOplogBufferName) {
+        OplogBufferCollection::Options collectionOptions;
+        collectionOptions.peekCacheSize = kSteadyStateOplogBufferSpillPeekCacheSize;
+        OplogBufferSpillable::Options options;
+        options.maxMemorySize = std::size_t(steadyStateOplogBufferMaxMemoryBytes);
+        return stdx::make_unique<OplogBufferSpillable>(
+            stdx::make_unique<OplogBufferCollection>(
+                StorageInterface::get(opCtx),
+                NamespaceString(kSteadyStateOplogBufferSpillNamespace),
+                collectionOptions),
+            options);
+    } else {
+        return stdx::make_unique<OplogBufferBlockingQueue>();
+    }
 }
 
 std::size_t ReplicationCoordinatorExternalStateImpl::getOplogFetcherMaxFetcherRestarts() const {
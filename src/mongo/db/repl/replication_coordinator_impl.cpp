@@ -35,10 +35,12 @@
 #include <algorithm>
 #include <limits>
 
+#include "mongo/base/counter.h"
 #include "mongo/base/status.h"
 #include "mongo/client/fetcher.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/logical_clock.h"
@@ -108,6 +110,23 @@ const OperationContext::Decoration<bool> alwaysAllowNonLocalWrites =
 
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncAttempts, int, 10);
 
+// Number of replSetUpdatePosition commands processed and the total time, in microseconds, that
+// _mutex was held while processing them.
+Counter64 updatePositionCount;
+ServerStatusMetricField<Counter64> displayUpdatePositionCount("repl.updatePosition.num",
+                                                              &updatePositionCount);
+Counter64 updatePositionMutexHeldMicros;
+ServerStatusMetricField<Counter64> displayUpdatePositionMutexHeldMicros(
+    "repl.updatePosition.mutexHeldMicros", &updatePositionMutexHeldMicros);
+
+/**
+ * Records how long _mutex was held while processing a replSetUpdatePosition command.
+ */
+void recordUpdatePositionMutexHeld(const Timer& mutexHeldTimer) {
+    updatePositionCount.increment();
+    updatePositionMutexHeldMicros.increment(mutexHeldTimer.micros());
+}
+
 /**
  * Allows non-local writes despite _canAcceptNonlocalWrites being false on a single OperationContext
  * while in scope.
@@ -225,51 +244,80 @@ private:
     Waiter* _waiter;
 };
 
+ReplicationCoordinatorImpl::WaiterList::WriteConcernKey
+ReplicationCoordinatorImpl::WaiterList::_makeWriteConcernKey(const Waiter& waiter) {
+    if (!waiter.writeConcern) {
+        return WriteConcernKey();
+    }
+    return WriteConcernKey(waiter.writeConcern->wNumNodes,
+                           waiter.writeConcern->wMode,
+                           static_cast<int>(waiter.writeConcern->syncMode));
+}
+
+ReplicationCoordinatorImpl::WaiterList::OpTimeKey
+ReplicationCoordinatorImpl::WaiterList::_makeOpTimeKey(const Waiter& waiter) {
+    return OpTimeKey(waiter.opTime.getTimestamp(), waiter.opTime.getTerm());
+}
+
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterType waiter) {
-    _list.push_back(waiter);
+    _waiters[_makeWriteConcernKey(*waiter)].emplace(_makeOpTimeKey(*waiter), waiter);
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalAndRemoveIf_inlock(
     stdx::function<bool(WaiterType)> func) {
-    // Only advance iterator when the element doesn't match.
-    for (auto it = _list.begin(); it != _list.end();) {
-        if (!func(*it)) {
-            ++it;
-            continue;
-        }
-
-        WaiterType waiter = std::move(*it);
-        if (it == std::prev(_list.end())) {
-            // Iterator will be invalid after erasing the last element, so set it to the
-            // next one (i.e. end()).
-            it = _list.erase(it);
+    std::vector<WaiterType> readyWaiters;
+    for (auto groupIt = _waiters.begin(); groupIt != _waiters.end();) {
+        auto& waitersByOpTime = groupIt->second;
+        // Waiters in a group become ready in opTime order, so stop at the first one that isn't.
+        auto it = waitersByOpTime.begin();
+        while (it != waitersByOpTime.end() && func(it->second)) {
+            readyWaiters.push_back(it->second);
+            it = waitersByOpTime.erase(it);
+        }
+
+        if (waitersByOpTime.empty()) {
+            groupIt = _waiters.erase(groupIt);
         } else {
-            // Iterator is still valid after pop_back().
-            std::swap(*it, _list.back());
-            _list.pop_back();
+            ++groupIt;
         }
+    }
 
-        // It's important to call notify() after the waiter has been removed from the list
-        // since notify() might remove the waiter itself.
+    // It's important to call notify() after the waiters have been removed from the list
+    // since notify() might remove the waiter itself.
+    for (auto& waiter : readyWaiters) {
         waiter->notify_inlock();
     }
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalAndRemoveAll_inlock() {
-    std::vector<WaiterType> list = std::move(_list);
+    std::map<WriteConcernKey, WaitersByOpTime> waiters = std::move(_waiters);
+    _waiters.clear();
     // Call notify() after removing the waiters from the list.
-    for (auto& waiter : list) {
-        waiter->notify_inlock();
+    for (auto& group : waiters) {
+        for (auto& entry : group.second) {
+            entry.second->notify_inlock();
+        }
     }
 }
 
 bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
-    auto it = std::find(_list.begin(), _list.end(), waiter);
-    if (it == _list.end()) {
+    auto groupIt = _waiters.find(_makeWriteConcernKey(*waiter));
+    if (groupIt == _waiters.end()) {
         return false;
     }
-    std::swap(*it, _list.back());
-    _list.pop_back();
+    auto& waitersByOpTime = groupIt->second;
+    auto range = waitersByOpTime.equal_range(_makeOpTimeKey(*waiter));
+    auto it = std::find_if(
+        range.first, range.second, [waiter](const WaitersByOpTime::value_type& entry) {
+            return entry.second == waiter;
+        });
+    if (it == range.second) {
+        return false;
+    }
+    waitersByOpTime.erase(it);
+    if (waitersByOpTime.empty()) {
+        _waiters.erase(groupIt);
+    }
     return true;
 }
 
@@ -2755,6 +2803,7 @@ void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock() {
 Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(
     const OldUpdatePositionArgs& updates, long long* configVersion) {
     stdx::unique_lock<stdx::mutex> lock(_mutex);
+    Timer mutexHeldTimer;
     Status status = Status::OK();
     bool somethingChanged = false;
     for (OldUpdatePositionArgs::UpdateIterator update = updates.updatesBegin();
@@ -2767,6 +2816,7 @@ Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(
         somethingChanged = true;
     }
 
+    recordUpdatePositionMutexHeld(mutexHeldTimer);
     if (somethingChanged && !_getMemberState_inlock().primary()) {
         lock.unlock();
         // Must do this outside _mutex
@@ -2778,6 +2828,7 @@ Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(
 Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(const UpdatePositionArgs& updates,
                                                                 long long* configVersion) {
     stdx::unique_lock<stdx::mutex> lock(_mutex);
+    Timer mutexHeldTimer;
     Status status = Status::OK();
     bool somethingChanged = false;
     for (UpdatePositionArgs::UpdateIterator update = updates.updatesBegin();
@@ -2790,6 +2841,7 @@ Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(const UpdatePosi
         somethingChanged = true;
     }
 
+    recordUpdatePositionMutexHeld(mutexHeldTimer);
     if (somethingChanged && !_getMemberState_inlock().primary()) {
         lock.unlock();
         // Must do this outside _mutex
@@ -2949,6 +3001,13 @@ void ReplicationCoordinatorImpl::blacklistSyncSource(const HostAndPort& host, Da
                                host));
 }
 
+void ReplicationCoordinatorImpl::recordSyncSourceFetchStats(const HostAndPort& host,
+                                                            std::size_t bytes,
+                                                            Milliseconds elapsed) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _topCoord->recordSyncSourceFetchStats(host, bytes, elapsed);
+}
+
 void ReplicationCoordinatorImpl::resetLastOpTimesFromOplog(OperationContext* opCtx) {
     StatusWith<OpTime> lastOpTimeStatus = _externalState->loadLastOpTime(opCtx);
     OpTime lastOpTime;
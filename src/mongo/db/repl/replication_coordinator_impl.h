@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -260,6 +263,10 @@ public:
 
     virtual void blacklistSyncSource(const HostAndPort& host, Date_t until) override;
 
+    virtual void recordSyncSourceFetchStats(const HostAndPort& host,
+                                            std::size_t bytes,
+                                            Milliseconds elapsed) override;
+
     virtual void resetLastOpTimesFromOplog(OperationContext* opCtx) override;
 
     virtual bool shouldChangeSyncSource(
@@ -508,6 +515,8 @@ private:
 
     class WaiterGuard;
 
+    // Waiters are grouped by write concern and ordered by opTime within each group, so that
+    // waking waiters only visits the ones that are ready plus at most one per group.
     class WaiterList {
     public:
         using WaiterType = Waiter*;
@@ -516,13 +525,26 @@ private:
         void add_inlock(WaiterType waiter);
         // Returns whether waiter is found and removed.
         bool remove_inlock(WaiterType waiter);
-        // Signals and removes all waiters that satisfy the condition.
+        // Signals and removes all waiters that satisfy the condition. The condition must be
+        // monotonic in the waiter's opTime among waiters with the same write concern: if it holds
+        // for a waiter, it must hold for every waiter in its group with an earlier opTime. Each
+        // group is visited in opTime order up to the first waiter that doesn't satisfy it.
         void signalAndRemoveIf_inlock(stdx::function<bool(WaiterType)> fun);
         // Signals and removes all waiters from the list.
         void signalAndRemoveAll_inlock();
 
     private:
-        std::vector<WaiterType> _list;
+        // Identifies the parts of a write concern that decide when a waiter is satisfied.
+        using WriteConcernKey = std::tuple<int, std::string, int>;
+        // Orders waiters by the timestamp and then the term of their opTime. Unlike OpTime's
+        // comparison operators, this is a strict weak ordering even across protocol versions.
+        using OpTimeKey = std::pair<Timestamp, long long>;
+        using WaitersByOpTime = std::multimap<OpTimeKey, WaiterType>;
+
+        static WriteConcernKey _makeWriteConcernKey(const Waiter& waiter);
+        static OpTimeKey _makeOpTimeKey(const Waiter& waiter);
+
+        std::map<WriteConcernKey, WaitersByOpTime> _waiters;
     };
 
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
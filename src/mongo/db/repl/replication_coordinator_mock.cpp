@@ -407,6 +407,10 @@ HostAndPort ReplicationCoordinatorMock::chooseNewSyncSource(const OpTime& lastOp
 
 void ReplicationCoordinatorMock::blacklistSyncSource(const HostAndPort& host, Date_t until) {}
 
+void ReplicationCoordinatorMock::recordSyncSourceFetchStats(const HostAndPort& host,
+                                                            std::size_t bytes,
+                                                            Milliseconds elapsed) {}
+
 void ReplicationCoordinatorMock::resetLastOpTimesFromOplog(OperationContext* opCtx) {
     invariant(false);
 }
@@ -217,6 +217,10 @@ public:
 
     virtual void blacklistSyncSource(const HostAndPort& host, Date_t until);
 
+    virtual void recordSyncSourceFetchStats(const HostAndPort& host,
+                                            std::size_t bytes,
+                                            Milliseconds elapsed);
+
     virtual void resetLastOpTimesFromOplog(OperationContext* opCtx);
 
     virtual bool shouldChangeSyncSource(const HostAndPort& currentSource,
@@ -94,11 +94,13 @@ bool _isTargetConfigNewerThanRequest(
 Reporter::Reporter(executor::TaskExecutor* executor,
                    PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
                    const HostAndPort& target,
-                   Milliseconds keepAliveInterval)
+                   Milliseconds keepAliveInterval,
+                   Milliseconds maxCoalescingDelay)
     : _executor(executor),
       _prepareReplSetUpdatePositionCommandFn(prepareReplSetUpdatePositionCommandFn),
       _target(target),
-      _keepAliveInterval(keepAliveInterval) {
+      _keepAliveInterval(keepAliveInterval),
+      _maxCoalescingDelay(maxCoalescingDelay) {
     uassert(ErrorCodes::BadValue, "null task executor", executor);
     uassert(ErrorCodes::BadValue,
             "null function to create replSetUpdatePosition command object",
@@ -107,6 +109,9 @@ Reporter::Reporter(executor::TaskExecutor* executor,
     uassert(ErrorCodes::BadValue,
             "keep alive interval must be positive",
             keepAliveInterval > Milliseconds(0));
+    uassert(ErrorCodes::BadValue,
+            "max coalescing delay cannot be negative",
+            maxCoalescingDelay >= Milliseconds(0));
 }
 
 Reporter::~Reporter() {
@@ -127,6 +132,11 @@ Milliseconds Reporter::getKeepAliveInterval() const {
     return _keepAliveInterval;
 }
 
+Milliseconds Reporter::getMaxCoalescingDelay() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _maxCoalescingDelay;
+}
+
 void Reporter::shutdown() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
@@ -165,6 +175,11 @@ Status Reporter::trigger() {
         return _status;
     }
 
+    if (_coalescedSendWhen != Date_t()) {
+        // The scheduled coalesced command will include the new information.
+        return Status::OK();
+    }
+
     if (_keepAliveTimeoutWhen != Date_t()) {
         // Reset keep alive expiration to signal handler that it was canceled internally.
         invariant(_prepareAndSendCommandCallbackHandle.isValid());
@@ -242,6 +257,25 @@ void Reporter::_sendCommand_inlock(BSONObj commandRequest) {
     }
 
     _remoteCommandCallbackHandle = scheduleResult.getValue();
+    _lastSendDate = _executor->now();
+}
+
+void Reporter::_scheduleCoalescedSend_inlock(Date_t when) {
+    LOG(3) << "Reporter coalescing updates to " << _target << " until " << when;
+
+    bool fromTrigger = true;
+    auto scheduleResult = _executor->scheduleWorkAt(
+        when,
+        stdx::bind(
+            &Reporter::_prepareAndSendCommandCallback, this, stdx::placeholders::_1, fromTrigger));
+
+    _status = scheduleResult.getStatus();
+    if (!_status.isOK()) {
+        return;
+    }
+
+    _prepareAndSendCommandCallbackHandle = scheduleResult.getValue();
+    _coalescedSendWhen = when;
 }
 
 void Reporter::_processResponseCallback(
@@ -313,6 +347,18 @@ void Reporter::_processResponseCallback(
             _remoteCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
             return;
         }
+
+        // Hold back the next command until the coalescing window of the previous one expires.
+        const auto coalescedSendWhen = _lastSendDate + _maxCoalescingDelay;
+        if (_maxCoalescingDelay > Milliseconds(0) && _executor->now() < coalescedSendWhen) {
+            _isWaitingToSendReporter = false;
+            _remoteCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
+            _scheduleCoalescedSend_inlock(coalescedSendWhen);
+            if (!_status.isOK()) {
+                _onShutdown_inlock();
+            }
+            return;
+        }
     }
 
     // Must call without holding the lock.
@@ -355,6 +401,20 @@ void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::Call
             _onShutdown_inlock();
             return;
         }
+
+        // A triggered update arriving soon after the previous command waits for the rest of the
+        // coalescing window, so that later updates in the window share a single command.
+        const auto coalescedSendWhen = _lastSendDate + _maxCoalescingDelay;
+        if (_maxCoalescingDelay > Milliseconds(0) && _lastSendDate != Date_t() &&
+            _executor->now() < coalescedSendWhen) {
+            _keepAliveTimeoutWhen = Date_t();
+            _scheduleCoalescedSend_inlock(coalescedSendWhen);
+            if (!_status.isOK()) {
+                _onShutdown_inlock();
+            }
+            return;
+        }
+        _coalescedSendWhen = Date_t();
     }
 
     // Must call without holding the lock.
@@ -382,6 +442,7 @@ void Reporter::_onShutdown_inlock() {
     _remoteCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
     _prepareAndSendCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
     _keepAliveTimeoutWhen = Date_t();
+    _coalescedSendWhen = Date_t();
     _condition.notify_all();
 }
 
@@ -404,5 +465,10 @@ Date_t Reporter::getKeepAliveTimeoutWhen_forTest() const {
     return _keepAliveTimeoutWhen;
 }
 
+Date_t Reporter::getCoalescedSendWhen_forTest() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _coalescedSendWhen;
+}
+
 }  // namespace repl
 }  // namespace mongo
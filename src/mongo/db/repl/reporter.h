@@ -60,6 +60,10 @@ namespace repl {
  *
  * Calling trigger() while it is in state 3 sends a command upstream and cancels the current
  * keep alive timeout, resetting the keep alive schedule.
+ *
+ * If "maxCoalescingDelay" is positive, the reporter sends at most one command per
+ * "maxCoalescingDelay". Updates triggered within this delay of the previous command are coalesced
+ * into a single command sent when the delay expires.
  */
 class Reporter {
     MONGO_DISALLOW_COPYING(Reporter);
@@ -77,7 +81,8 @@ public:
     Reporter(executor::TaskExecutor* executor,
              PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
              const HostAndPort& target,
-             Milliseconds keepAliveInterval);
+             Milliseconds keepAliveInterval,
+             Milliseconds maxCoalescingDelay = Milliseconds(0));
 
     virtual ~Reporter();
 
@@ -98,6 +103,12 @@ public:
      */
     Milliseconds getKeepAliveInterval() const;
 
+    /**
+     * Returns the maximum time an update may be delayed in order to coalesce it with other
+     * updates.
+     */
+    Milliseconds getMaxCoalescingDelay() const;
+
     /**
      * Returns true if a remote command has been scheduled (but not completed)
      * with the executor.
@@ -135,6 +146,11 @@ public:
      */
     Date_t getKeepAliveTimeoutWhen_forTest() const;
 
+    /**
+     * Returns scheduled time of the coalesced update command.
+     */
+    Date_t getCoalescedSendWhen_forTest() const;
+
 private:
     /**
      * Returns true if reporter is active.
@@ -151,6 +167,12 @@ private:
      */
     void _sendCommand_inlock(BSONObj commandRequest);
 
+    /**
+     * Schedules the next update command to be prepared and sent at "when", the end of the current
+     * coalescing window.
+     */
+    void _scheduleCoalescedSend_inlock(Date_t when);
+
     /**
      * Callback for processing response from remote command.
      */
@@ -180,6 +202,10 @@ private:
     // encounters an error.
     const Milliseconds _keepAliveInterval;
 
+    // Updates triggered within "_maxCoalescingDelay" ms of the previous command are sent together
+    // when the delay expires. Zero disables coalescing.
+    const Milliseconds _maxCoalescingDelay;
+
     // Protects member data of this Reporter declared below.
     mutable stdx::mutex _mutex;
 
@@ -206,6 +232,13 @@ private:
     // If this date is Date_t(), the callback is either unscheduled or canceled.
     // Used for testing only.
     Date_t _keepAliveTimeoutWhen;
+
+    // Time the most recent command was sent to the sync source.
+    Date_t _lastSendDate;
+
+    // Coalesced command will not be sent before this time.
+    // If this date is Date_t(), no coalesced command is scheduled.
+    Date_t _coalescedSendWhen;
 };
 
 }  // namespace repl
@@ -286,6 +286,15 @@ TEST_F(ReporterTestNoTriggerAtSetUp, InvalidConstruction) {
             &getExecutor(), prepareReplSetUpdatePositionCommandFn, HostAndPort("h1"), Seconds(-1)),
         AssertionException,
         "keep alive interval must be positive");
+
+    // negative max coalescing delay.
+    ASSERT_THROWS_WHAT(Reporter(&getExecutor(),
+                                prepareReplSetUpdatePositionCommandFn,
+                                HostAndPort("h1"),
+                                Milliseconds(1000),
+                                Milliseconds(-1)),
+                       AssertionException,
+                       "max coalescing delay cannot be negative");
 }
 
 TEST_F(ReporterTestNoTriggerAtSetUp, GetTarget) {
@@ -753,4 +762,91 @@ TEST_F(ReporterTest, ShutdownImmediatelyAfterTriggerWhileKeepAliveTimeoutIsSched
     assertReporterDone();
 }
 
+TEST_F(ReporterTestNoTriggerAtSetUp, TriggersWithinCoalescingDelayShouldBeSentInOneUpdate) {
+    reporter = stdx::make_unique<Reporter>(_executorProxy.get(),
+                                           prepareReplSetUpdatePositionCommandFn,
+                                           HostAndPort("h1"),
+                                           Milliseconds(1000),
+                                           Milliseconds(100));
+    ASSERT_EQUALS(Milliseconds(100), reporter->getMaxCoalescingDelay());
+
+    // The first update is sent immediately.
+    auto coalescedSendWhen = getExecutor().now() + reporter->getMaxCoalescingDelay();
+    ASSERT_OK(reporter->trigger());
+    processNetworkResponse(BSON("ok" << 1));
+    ASSERT_NOT_EQUALS(Date_t(), reporter->getKeepAliveTimeoutWhen_forTest());
+
+    // Updates triggered before the coalescing delay expires are held back.
+    ASSERT_OK(reporter->trigger());
+    runReadyScheduledTasks();
+    ASSERT_EQUALS(Date_t(), reporter->getKeepAliveTimeoutWhen_forTest());
+    ASSERT_EQUALS(coalescedSendWhen, reporter->getCoalescedSendWhen_forTest());
+    ASSERT_TRUE(reporter->isActive());
+
+    ASSERT_OK(reporter->trigger());
+    ASSERT_EQUALS(coalescedSendWhen, reporter->getCoalescedSendWhen_forTest());
+    ASSERT_FALSE(reporter->isWaitingToSendReport());
+
+    // A single update is sent when the coalescing delay expires.
+    runUntil(coalescedSendWhen, true);
+    processNetworkResponse(BSON("ok" << 1));
+    ASSERT_EQUALS(Date_t(), reporter->getCoalescedSendWhen_forTest());
+    ASSERT_EQUALS(getExecutor().now() + reporter->getKeepAliveInterval(),
+                  reporter->getKeepAliveTimeoutWhen_forTest());
+
+    reporter->shutdown();
+
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, reporter->join());
+    assertReporterDone();
+}
+
+TEST_F(ReporterTestNoTriggerAtSetUp,
+       TriggerWhileCommandIsInProgressShouldSendUpdateWhenCoalescingDelayExpires) {
+    reporter = stdx::make_unique<Reporter>(_executorProxy.get(),
+                                           prepareReplSetUpdatePositionCommandFn,
+                                           HostAndPort("h1"),
+                                           Milliseconds(1000),
+                                           Milliseconds(100));
+
+    auto coalescedSendWhen = getExecutor().now() + reporter->getMaxCoalescingDelay();
+    ASSERT_OK(reporter->trigger());
+    runReadyScheduledTasks();
+    ASSERT_OK(reporter->trigger());
+    ASSERT_TRUE(reporter->isWaitingToSendReport());
+
+    // The response does not cause an update to be sent immediately.
+    processNetworkResponse(BSON("ok" << 1));
+    ASSERT_FALSE(reporter->isWaitingToSendReport());
+    ASSERT_EQUALS(coalescedSendWhen, reporter->getCoalescedSendWhen_forTest());
+    ASSERT_TRUE(reporter->isActive());
+
+    runUntil(coalescedSendWhen, true);
+
+    processNetworkResponse({ErrorCodes::OperationFailed, "update failed", Milliseconds(0)});
+
+    ASSERT_EQUALS(ErrorCodes::OperationFailed, reporter->join());
+    assertReporterDone();
+}
+
+TEST_F(ReporterTestNoTriggerAtSetUp, ShutdownWhileCoalescedUpdateIsScheduledShouldSucceed) {
+    reporter = stdx::make_unique<Reporter>(_executorProxy.get(),
+                                           prepareReplSetUpdatePositionCommandFn,
+                                           HostAndPort("h1"),
+                                           Milliseconds(1000),
+                                           Milliseconds(100));
+
+    auto coalescedSendWhen = getExecutor().now() + reporter->getMaxCoalescingDelay();
+    ASSERT_OK(reporter->trigger());
+    processNetworkResponse(BSON("ok" << 1));
+    ASSERT_OK(reporter->trigger());
+    runReadyScheduledTasks();
+    ASSERT_EQUALS(coalescedSendWhen, reporter->getCoalescedSendWhen_forTest());
+
+    reporter->shutdown();
+
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, reporter->join());
+    assertReporterDone();
+    ASSERT_EQUALS(Date_t(), reporter->getCoalescedSendWhen_forTest());
+}
+
 }  // namespace
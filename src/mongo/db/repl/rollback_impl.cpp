@@ -42,6 +42,7 @@
 #include "mongo/db/session_catalog.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -84,16 +85,20 @@ RollbackImpl::~RollbackImpl() {
 }
 
 Status RollbackImpl::runRollback(OperationContext* opCtx) {
+    Timer phaseTimer;
     auto status = _transitionToRollback(opCtx);
     if (!status.isOK()) {
         return status;
     }
+    _recordPhaseDuration("transitionToRollback"_sd, Milliseconds(phaseTimer.millis()));
     _listener->onTransitionToRollback();
 
+    phaseTimer.reset();
     auto commonPointSW = _findCommonPoint();
     if (!commonPointSW.isOK()) {
         return commonPointSW.getStatus();
     }
+    _recordPhaseDuration("findCommonPoint"_sd, Milliseconds(phaseTimer.millis()));
 
     // Persist the common point to the 'oplogTruncateAfterPoint' document. We save this value so
     // that the replication recovery logic knows where to truncate the oplog. Note that it must be
@@ -115,25 +120,32 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     }
 
     // Recover to the stable timestamp.
+    phaseTimer.reset();
     status = _recoverToStableTimestamp(opCtx);
     if (!status.isOK()) {
         return status;
     }
+    _recordPhaseDuration("recoverToStableTimestamp"_sd, Milliseconds(phaseTimer.millis()));
     _listener->onRecoverToStableTimestamp();
 
     // Run the oplog recovery logic.
+    phaseTimer.reset();
     status = _oplogRecovery(opCtx);
     if (!status.isOK()) {
         return status;
     }
+    _recordPhaseDuration("oplogRecovery"_sd, Milliseconds(phaseTimer.millis()));
     _listener->onRecoverFromOplog();
 
     // At this point these functions need to always be called before returning, even on failure.
     // These functions fassert on failure.
     ON_BLOCK_EXIT([this, opCtx] {
+        Timer completionTimer;
         _checkShardIdentityRollback(opCtx);
         _resetSessions(opCtx);
         _transitionFromRollbackToSecondary(opCtx);
+        _recordPhaseDuration("transitionToSecondary"_sd, Milliseconds(completionTimer.millis()));
+        _logPhaseDurations();
     });
 
     return Status::OK();
@@ -146,6 +158,16 @@ void RollbackImpl::shutdown() {
     _inShutdown = true;
 }
 
+RollbackImpl::PhaseDurations RollbackImpl::getPhaseDurations() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _phaseDurations;
+}
+
+long long RollbackImpl::getRolledBackOperationCount() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _rolledBackOperationCount;
+}
+
 bool RollbackImpl::_isInShutdown() const {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     return _inShutdown;
@@ -181,7 +203,11 @@ StatusWith<Timestamp> RollbackImpl::_findCommonPoint() {
 
     log() << "finding common point";
 
-    auto onLocalOplogEntryFn = [](const BSONObj& operation) { return Status::OK(); };
+    long long rolledBackOperationCount = 0;
+    auto onLocalOplogEntryFn = [&rolledBackOperationCount](const BSONObj& operation) {
+        ++rolledBackOperationCount;
+        return Status::OK();
+    };
 
     // Calls syncRollBackLocalOperations to find the common point and run onLocalOplogEntryFn on
     // each oplog entry up until the common point. We only need the Timestamp of the common point
@@ -191,6 +217,13 @@ StatusWith<Timestamp> RollbackImpl::_findCommonPoint() {
     if (!commonPointSW.isOK()) {
         return commonPointSW.getStatus();
     }
+
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _rolledBackOperationCount = rolledBackOperationCount;
+    }
+    log() << "found common point " << commonPointSW.getValue().first << "; rolling back "
+          << rolledBackOperationCount << " local oplog entries";
     return commonPointSW.getValue().first.getTimestamp();
 }
 
@@ -259,5 +292,26 @@ void RollbackImpl::_transitionFromRollbackToSecondary(OperationContext* opCtx) {
     }
 }
 
+void RollbackImpl::_recordPhaseDuration(StringData phaseName, Milliseconds duration) {
+    LOG(1) << "rollback phase " << phaseName << " took " << duration;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _phaseDurations.emplace_back(phaseName.toString(), duration);
+    }
+    _listener->onPhaseComplete(phaseName, duration);
+}
+
+void RollbackImpl::_logPhaseDurations() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    Milliseconds total(0);
+    StringBuilder sb;
+    for (const auto& phase : _phaseDurations) {
+        sb << (sb.len() ? ", " : "") << phase.first << ": " << phase.second;
+        total += phase.second;
+    }
+    log() << "rollback of " << _rolledBackOperationCount << " oplog entries took " << total << " ("
+          << sb.str() << ")";
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -28,10 +28,16 @@
 
 #pragma once
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
 #include "mongo/db/repl/rollback.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -86,6 +92,11 @@ class ReplicationProcess;
  */
 class RollbackImpl : public Rollback {
 public:
+    /**
+     * Names and durations of the rollback phases that have completed, in the order they ran.
+     */
+    using PhaseDurations = std::vector<std::pair<std::string, Milliseconds>>;
+
     /**
      * A class with functions that get called throughout rollback. These can be overridden to
      * instrument this class for diagnostics and testing.
@@ -113,6 +124,11 @@ public:
          * Function called after we recover from the oplog.
          */
         virtual void onRecoverFromOplog() noexcept {}
+
+        /**
+         * Function called after each rollback phase completes, with the time spent in that phase.
+         */
+        virtual void onPhaseComplete(StringData phaseName, Milliseconds duration) noexcept {}
     };
 
     /**
@@ -148,6 +164,17 @@ public:
      */
     void shutdown();
 
+    /**
+     * Returns the durations of the rollback phases completed so far.
+     */
+    PhaseDurations getPhaseDurations() const;
+
+    /**
+     * Returns the number of local oplog entries that were found to be on the wrong branch of
+     * history while searching for the common point.
+     */
+    long long getRolledBackOperationCount() const;
+
 private:
     /**
      * Returns if shutdown was called on this rollback process.
@@ -204,6 +231,16 @@ private:
      */
     void _transitionFromRollbackToSecondary(OperationContext* opCtx);
 
+    /**
+     * Records the time spent in a completed rollback phase and notifies the listener.
+     */
+    void _recordPhaseDuration(StringData phaseName, Milliseconds duration);
+
+    /**
+     * Logs a summary of the time spent in each rollback phase.
+     */
+    void _logPhaseDurations() const;
+
     // All member variables are labeled with one of the following codes indicating the
     // synchronization rules for accessing them.
     //
@@ -217,6 +254,12 @@ private:
     // Set to true when RollbackImpl should shut down.
     bool _inShutdown = false;  // (M)
 
+    // Time spent in each completed rollback phase.
+    PhaseDurations _phaseDurations;  // (M)
+
+    // Number of local oplog entries rolled back. Set when the common point is found.
+    long long _rolledBackOperationCount = 0;  // (M)
+
     // This is used to read oplog entries from the local oplog that will be rolled back.
     OplogInterface* const _localOplog;  // (R)
 
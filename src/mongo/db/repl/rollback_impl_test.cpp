@@ -134,6 +134,10 @@ protected:
     stdx::function<void(Timestamp commonPoint)> _onCommonPointFoundFn =
         [this](Timestamp commonPoint) { _commonPointFound = commonPoint; };
 
+    std::vector<std::string> _completedPhases;
+    stdx::function<void(StringData phaseName)> _onPhaseCompleteFn =
+        [this](StringData phaseName) { _completedPhases.push_back(phaseName.toString()); };
+
     std::unique_ptr<Listener> _listener;
 };
 
@@ -182,6 +186,10 @@ public:
         _test->_onRecoverFromOplogFn();
     }
 
+    void onPhaseComplete(StringData phaseName, Milliseconds duration) noexcept {
+        _test->_onPhaseCompleteFn(phaseName);
+    }
+
 private:
     RollbackImplTest* _test;
 };
@@ -380,6 +388,52 @@ TEST_F(RollbackImplTest, RollbackSucceeds) {
     ASSERT_EQUALS(Timestamp(1, 1), _commonPointFound);
 }
 
+TEST_F(RollbackImplTest, RollbackRecordsPhaseDurations) {
+    auto op = makeOpAndRecordId(1);
+    _remoteOplog->setOperations({op});
+    _localOplog->setOperations({op});
+
+    ASSERT_OK(_rollback->runRollback(_opCtx.get()));
+
+    const std::vector<std::string> expectedPhases = {"transitionToRollback",
+                                                     "findCommonPoint",
+                                                     "recoverToStableTimestamp",
+                                                     "oplogRecovery",
+                                                     "transitionToSecondary"};
+    ASSERT_EQUALS(expectedPhases.size(), _completedPhases.size());
+    auto phaseDurations = _rollback->getPhaseDurations();
+    ASSERT_EQUALS(expectedPhases.size(), phaseDurations.size());
+    for (std::size_t i = 0; i < expectedPhases.size(); ++i) {
+        ASSERT_EQUALS(expectedPhases[i], _completedPhases[i]);
+        ASSERT_EQUALS(expectedPhases[i], phaseDurations[i].first);
+        ASSERT_GTE(phaseDurations[i].second, Milliseconds(0));
+    }
+}
+
+TEST_F(RollbackImplTest, RollbackRecordsOnlyCompletedPhasesOnFailure) {
+    auto op = makeOpAndRecordId(1);
+    _remoteOplog->setOperations({op});
+    _localOplog->setOperations({op});
+    _storageInterface->setRecoverToTimestampStatus(Status(ErrorCodes::InternalError, "error"));
+
+    ASSERT_EQUALS(ErrorCodes::InternalError, _rollback->runRollback(_opCtx.get()));
+
+    const std::vector<std::string> expectedPhases = {"transitionToRollback", "findCommonPoint"};
+    ASSERT_EQUALS(expectedPhases.size(), _completedPhases.size());
+    ASSERT_EQUALS(expectedPhases[0], _completedPhases[0]);
+    ASSERT_EQUALS(expectedPhases[1], _completedPhases[1]);
+}
+
+TEST_F(RollbackImplTest, RollbackCountsRolledBackOperations) {
+    auto commonOp = makeOpAndRecordId(1);
+    _remoteOplog->setOperations({commonOp});
+    _localOplog->setOperations({makeOpAndRecordId(3), makeOpAndRecordId(2), commonOp});
+
+    ASSERT_OK(_rollback->runRollback(_opCtx.get()));
+    ASSERT_EQUALS(Timestamp(1, 1), _commonPointFound);
+    ASSERT_EQUALS(2LL, _rollback->getRolledBackOperationCount());
+}
+
 DEATH_TEST_F(RollbackImplTest,
              RollbackTriggersFatalAssertionOnDetectingShardIdentityDocumentRollback,
              "shardIdentity document rollback detected.  Shutting down to clear in-memory sharding "
@@ -37,6 +37,7 @@
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/reporter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
@@ -49,6 +50,30 @@ namespace repl {
 
 namespace {
 
+// Maximum time, in milliseconds, a replication progress update may be held back so that it can be
+// sent to the sync source together with later updates. Heartbeat responses also carry our applied
+// and durable optimes, so the primary keeps learning our progress while updates are held back.
+// Zero sends every update as soon as possible.
+AtomicInt32 maxSyncSourceFeedbackDelayMillis(0);
+
+class MaxSyncSourceFeedbackDelayMillisServerParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime> {
+public:
+    MaxSyncSourceFeedbackDelayMillisServerParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "maxSyncSourceFeedbackDelayMillis",
+              &maxSyncSourceFeedbackDelayMillis) {}
+
+    Status validate(const int& potentialNewValue) override {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "maxSyncSourceFeedbackDelayMillis must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} maxSyncSourceFeedbackDelayMillisServerParameter;
+
 /**
  * Calculates the keep alive interval based on the current configuration in the replication
  * coordinator.
@@ -217,7 +242,8 @@ void SyncSourceFeedback::run(executor::TaskExecutor* executor, BackgroundSync* b
             executor,
             makePrepareReplSetUpdatePositionCommandFn(opCtx.get(), syncTarget, bgsync),
             syncTarget,
-            keepAliveInterval);
+            keepAliveInterval,
+            Milliseconds(maxSyncSourceFeedbackDelayMillis.load()));
         {
             stdx::lock_guard<stdx::mutex> lock(_mtx);
             if (_shutdownSignaled) {
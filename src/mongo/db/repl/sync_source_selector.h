@@ -73,6 +73,14 @@ public:
      */
     virtual void blacklistSyncSource(const HostAndPort& host, Date_t until) = 0;
 
+    /**
+     * Records that a batch of "bytes" bytes of oplog entries was fetched from sync source "host"
+     * in "elapsed". Used to estimate how quickly each member serves oplog.
+     */
+    virtual void recordSyncSourceFetchStats(const HostAndPort& host,
+                                            std::size_t bytes,
+                                            Milliseconds elapsed) = 0;
+
     /**
      * Determines if a new sync source should be chosen, if a better candidate sync source is
      * available.  If the current sync source's last optime (visibleOpTime or appliedOpTime of
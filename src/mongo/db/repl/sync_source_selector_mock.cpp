@@ -50,6 +50,10 @@ void SyncSourceSelectorMock::blacklistSyncSource(const HostAndPort& host, Date_t
     _lastBlacklistExpiration = until;
 }
 
+void SyncSourceSelectorMock::recordSyncSourceFetchStats(const HostAndPort& host,
+                                                        std::size_t bytes,
+                                                        Milliseconds elapsed) {}
+
 void SyncSourceSelectorMock::setChooseNewSyncSourceHook_forTest(
     const ChooseNewSyncSourceHook& hook) {
     _chooseNewSyncSourceHook = hook;
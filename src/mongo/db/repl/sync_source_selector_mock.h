@@ -51,6 +51,9 @@ public:
     void clearSyncSourceBlacklist() override;
     HostAndPort chooseNewSyncSource(const OpTime& ot) override;
     void blacklistSyncSource(const HostAndPort& host, Date_t until) override;
+    void recordSyncSourceFetchStats(const HostAndPort& host,
+                                    std::size_t bytes,
+                                    Milliseconds elapsed) override;
     bool shouldChangeSyncSource(const HostAndPort&,
                                 const rpc::ReplSetMetadata&,
                                 boost::optional<rpc::OplogQueryMetadata> oqMetadata) override;
@@ -146,6 +146,15 @@ public:
      */
     virtual void blacklistSyncSource(const HostAndPort& host, Date_t until) = 0;
 
+    /**
+     * Records that a batch of "bytes" bytes of oplog entries was fetched from sync source "host"
+     * in "elapsed". Used to estimate how quickly each member serves oplog when choosing sync
+     * sources.
+     */
+    virtual void recordSyncSourceFetchStats(const HostAndPort& host,
+                                            std::size_t bytes,
+                                            Milliseconds elapsed) = 0;
+
     /**
      * Removes a single entry "host" from the list of potential sync sources which we
      * have blacklisted, if it is supposed to be unblacklisted by "now".
@@ -32,6 +32,7 @@
 
 #include "mongo/db/repl/topology_coordinator_impl.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "mongo/db/audit.h"
@@ -80,6 +81,21 @@ int indexOfIterator(const std::vector<T>& vec, typename std::vector<T>::const_it
 // Maximum number of retries for a failed heartbeat.
 const int kMaxHeartbeatRetries = 2;
 
+// Fetched batches smaller than this are not used to measure sync source throughput, since the
+// time spent on them is dominated by waiting for new oplog entries rather than by transferring
+// them.
+const std::size_t kMinThroughputSampleBytes = 1024 * 1024;
+
+// Size of a full batch of fetched oplog entries. The time to fetch this many bytes at the
+// throughput measured from a sync source is part of its expected replication lag.
+const std::size_t kThroughputReferenceBatchBytes = 16 * 1024 * 1024;
+
+// When choosing sync sources by expected lag, a candidate must improve on the expected lag of
+// the current sync source by both this fraction and kMinSyncSourceLagImprovement before we
+// switch to it.
+const double kMinSyncSourceLagImprovementFraction = 0.25;
+const Milliseconds kMinSyncSourceLagImprovement(100);
+
 /**
  * Returns true if the only up heartbeats are auth errors.
  */
@@ -130,6 +146,14 @@ void PingStats::miss() {
     ++_numFailuresSinceLastStart;
 }
 
+void SyncSourceThroughputStats::hit(std::size_t bytes, Milliseconds elapsed) {
+    // Round sub-millisecond fetches up so that a fast batch does not yield infinite throughput.
+    const auto elapsedMillis = std::max<long long>(1, durationCount<Milliseconds>(elapsed));
+    const double bytesPerSecond = static_cast<double>(bytes) * 1000 / elapsedMillis;
+    _bytesPerSecond = _count == 0 ? bytesPerSecond : (_bytesPerSecond * 4 + bytesPerSecond) / 5;
+    ++_count;
+}
+
 TopologyCoordinatorImpl::TopologyCoordinatorImpl(Options options)
     : _role(Role::follower),
       _term(OpTime::kUninitializedTerm),
@@ -173,6 +197,9 @@ HostAndPort TopologyCoordinatorImpl::chooseNewSyncSource(Date_t now,
         invariant(_forceSyncSourceIndex < _rsConfig.getNumMembers());
         _syncSource = _rsConfig.getMemberAt(_forceSyncSourceIndex).getHostAndPort();
         _forceSyncSourceIndex = -1;
+        _syncSourceSelectionReason = "requested by replSetSyncFrom";
+        _syncSourceSelectedDate = now;
+        _syncSourceForced = true;
         log() << "choosing sync source candidate by request: " << _syncSource;
         std::string msg(str::stream() << "syncing from: " << _syncSource.toString()
                                       << " by request");
@@ -211,6 +238,9 @@ HostAndPort TopologyCoordinatorImpl::chooseNewSyncSource(Date_t now,
             return _syncSource;
         } else {
             _syncSource = _currentPrimaryMember()->getHostAndPort();
+            _syncSourceSelectionReason = "chaining not allowed; syncing from primary";
+            _syncSourceSelectedDate = now;
+            _syncSourceForced = false;
             log() << "chaining not allowed, choosing primary as sync source candidate: "
                   << _syncSource;
             std::string msg(str::stream() << "syncing from primary: " << _syncSource.toString());
@@ -226,8 +256,9 @@ HostAndPort TopologyCoordinatorImpl::chooseNewSyncSource(Date_t now,
 
     // Find primary's oplog time. Reject sync candidates that are more than
     // _options.maxSyncSourceLagSecs seconds behind.
+    OpTime primaryOpTime;
     if (_currentPrimaryIndex != -1) {
-        OpTime primaryOpTime = _memberData.at(_currentPrimaryIndex).getHeartbeatAppliedOpTime();
+        primaryOpTime = _memberData.at(_currentPrimaryIndex).getHeartbeatAppliedOpTime();
 
         // Check if primaryOpTime is still close to 0 because we haven't received
         // our first heartbeat from a new primary yet.
@@ -321,9 +352,7 @@ HostAndPort TopologyCoordinatorImpl::chooseNewSyncSource(Date_t now,
                 continue;
             }
             // Candidate cannot be more latent than anything we've already considered.
-            if ((closestIndex != -1) &&
-                (_getPing(itMemberConfig.getHostAndPort()) >
-                 _getPing(_rsConfig.getMemberAt(closestIndex).getHostAndPort()))) {
+            if (!_isBetterSyncSourceCandidate(itIndex, closestIndex, primaryOpTime)) {
                 LOG(2) << "Cannot select sync source with higher latency than the best candidate: "
                        << itMemberConfig.getHostAndPort();
 
@@ -356,7 +385,26 @@ HostAndPort TopologyCoordinatorImpl::chooseNewSyncSource(Date_t now,
         return _syncSource;
     }
     _syncSource = _rsConfig.getMemberAt(closestIndex).getHostAndPort();
-    log() << "sync source candidate: " << _syncSource;
+    _syncSourceSelectedDate = now;
+    _syncSourceForced = false;
+    if (_options.useMeasuredSyncSourceThroughput) {
+        auto throughputIt = _syncSourceThroughput.find(_syncSource);
+        str::stream reason;
+        reason << "lowest expected replication lag ("
+               << _estimateSyncSourceLag(closestIndex, primaryOpTime) << "; ping "
+               << _getPing(_syncSource) << ", measured fetch throughput ";
+        if (throughputIt == _syncSourceThroughput.end()) {
+            reason << "unknown)";
+        } else {
+            reason << static_cast<long long>(throughputIt->second.getBytesPerSecond())
+                   << " bytes/s)";
+        }
+        _syncSourceSelectionReason = reason;
+    } else {
+        _syncSourceSelectionReason = str::stream() << "lowest ping time ("
+                                                   << _getPing(_syncSource) << ")";
+    }
+    log() << "sync source candidate: " << _syncSource << "; " << _syncSourceSelectionReason;
     std::string msg(str::stream() << "syncing from: " << _syncSource.toString(), 0);
     setMyHeartbeatMessage(now, msg);
     return _syncSource;
@@ -374,11 +422,84 @@ bool TopologyCoordinatorImpl::_memberIsBlacklisted(const MemberConfig& memberCon
     return false;
 }
 
+Milliseconds TopologyCoordinatorImpl::_estimateSyncSourceLag(int memberIndex,
+                                                             const OpTime& primaryOpTime) const {
+    const HostAndPort& host = _rsConfig.getMemberAt(memberIndex).getHostAndPort();
+
+    Milliseconds estimate(0);
+    auto pingIt = _pings.find(host);
+    if (pingIt != _pings.end()) {
+        estimate += pingIt->second.getMillis();
+    }
+
+    const OpTime& memberOpTime = _memberData.at(memberIndex).getHeartbeatAppliedOpTime();
+    if (!primaryOpTime.isNull() && primaryOpTime.getSecs() > memberOpTime.getSecs()) {
+        estimate += Seconds(primaryOpTime.getSecs() - memberOpTime.getSecs());
+    }
+
+    auto fetchTime = _getMeasuredSyncSourceFetchTime(host);
+    estimate += fetchTime ? *fetchTime : _getMedianSyncSourceFetchTime();
+    return estimate;
+}
+
+boost::optional<Milliseconds> TopologyCoordinatorImpl::_getMeasuredSyncSourceFetchTime(
+    const HostAndPort& host) const {
+    auto throughputIt = _syncSourceThroughput.find(host);
+    if (throughputIt == _syncSourceThroughput.end() ||
+        throughputIt->second.getBytesPerSecond() <= 0) {
+        return boost::none;
+    }
+    return Milliseconds(static_cast<long long>(kThroughputReferenceBatchBytes * 1000 /
+                                               throughputIt->second.getBytesPerSecond()));
+}
+
+Milliseconds TopologyCoordinatorImpl::_getMedianSyncSourceFetchTime() const {
+    std::vector<Milliseconds> fetchTimes;
+    for (const auto& entry : _syncSourceThroughput) {
+        if (auto fetchTime = _getMeasuredSyncSourceFetchTime(entry.first)) {
+            fetchTimes.push_back(*fetchTime);
+        }
+    }
+    if (fetchTimes.empty()) {
+        return Milliseconds(0);
+    }
+    auto median = fetchTimes.begin() + fetchTimes.size() / 2;
+    std::nth_element(fetchTimes.begin(), median, fetchTimes.end());
+    return *median;
+}
+
+bool TopologyCoordinatorImpl::_isBetterSyncSourceCandidate(int candidateIndex,
+                                                           int bestIndex,
+                                                           const OpTime& primaryOpTime) {
+    if (bestIndex == -1) {
+        return true;
+    }
+    if (_options.useMeasuredSyncSourceThroughput) {
+        return _estimateSyncSourceLag(candidateIndex, primaryOpTime) <=
+            _estimateSyncSourceLag(bestIndex, primaryOpTime);
+    }
+    return _getPing(_rsConfig.getMemberAt(candidateIndex).getHostAndPort()) <=
+        _getPing(_rsConfig.getMemberAt(bestIndex).getHostAndPort());
+}
+
 void TopologyCoordinatorImpl::blacklistSyncSource(const HostAndPort& host, Date_t until) {
     LOG(2) << "blacklisting " << host << " until " << until.toString();
     _syncSourceBlacklist[host] = until;
 }
 
+void TopologyCoordinatorImpl::recordSyncSourceFetchStats(const HostAndPort& host,
+                                                         std::size_t bytes,
+                                                         Milliseconds elapsed) {
+    if (bytes < kMinThroughputSampleBytes) {
+        return;
+    }
+    auto& stats = _syncSourceThroughput[host];
+    stats.hit(bytes, elapsed);
+    LOG(2) << "fetched " << bytes << " bytes of oplog from " << host << " in " << elapsed
+           << "; average fetch throughput " << static_cast<long long>(stats.getBytesPerSecond())
+           << " bytes/s";
+}
+
 void TopologyCoordinatorImpl::unblacklistSyncSource(const HostAndPort& host, Date_t now) {
     std::map<HostAndPort, Date_t>::iterator hostItr = _syncSourceBlacklist.find(host);
     if (hostItr != _syncSourceBlacklist.end() && now >= hostItr->second) {
@@ -1946,6 +2067,9 @@ void TopologyCoordinatorImpl::prepareStatusResponse(const ReplSetStatusArgs& rsS
     // Add sync source info
     if (!_syncSource.empty() && !myState.primary() && !myState.removed()) {
         response->append("syncingTo", _syncSource.toString());
+        if (!_syncSourceSelectionReason.empty()) {
+            response->append("syncSourceSelectionReason", _syncSourceSelectionReason);
+        }
     }
 
     if (_rsConfig.isConfigServer()) {
@@ -2934,6 +3058,50 @@ bool TopologyCoordinatorImpl::shouldChangeSyncSource(
         }
     }
 
+    // Switch to a candidate that we expect to give us noticeably less replication lag, but only
+    // once the current sync source has been in use for a while, so that we do not flap between
+    // sources with similar estimates. A sync source which is the primary because chaining is
+    // disabled, or which was requested via replSetSyncFrom, is kept.
+    if (_options.useMeasuredSyncSourceThroughput && _rsConfig.isChainingAllowed() &&
+        !_syncSourceForced &&
+        now - _syncSourceSelectedDate >= _options.syncSourceReselectionMinInterval) {
+        const OpTime primaryOpTime = _currentPrimaryIndex != -1
+            ? _memberData.at(_currentPrimaryIndex).getHeartbeatAppliedOpTime()
+            : OpTime();
+        const Milliseconds currentEstimate =
+            _estimateSyncSourceLag(currentSourceIndex, primaryOpTime);
+
+        for (std::vector<MemberData>::const_iterator it = _memberData.begin();
+             it != _memberData.end();
+             ++it) {
+            const int itIndex = indexOfIterator(_memberData, it);
+            if (itIndex == _selfIndex || itIndex == currentSourceIndex) {
+                continue;
+            }
+            const MemberConfig& candidateConfig = _rsConfig.getMemberAt(itIndex);
+            if (!it->up() || !it->getState().readable() || candidateConfig.isHidden() ||
+                (_selfConfig().isVoter() && !candidateConfig.isVoter()) ||
+                (_selfConfig().shouldBuildIndexes() && !candidateConfig.shouldBuildIndexes()) ||
+                _selfConfig().getSlaveDelay() < candidateConfig.getSlaveDelay() ||
+                _memberIsBlacklisted(candidateConfig, now) ||
+                it->getHeartbeatAppliedOpTime() <= myLastOpTime) {
+                continue;
+            }
+
+            const Milliseconds candidateEstimate = _estimateSyncSourceLag(itIndex, primaryOpTime);
+            const Milliseconds improvement = currentEstimate - candidateEstimate;
+            if (improvement >= kMinSyncSourceLagImprovement &&
+                improvement.count() >=
+                    kMinSyncSourceLagImprovementFraction * currentEstimate.count()) {
+                log() << "Choosing new sync source because member "
+                      << candidateConfig.getHostAndPort() << " has an expected replication lag of "
+                      << candidateEstimate << ", which is lower than the expected lag of "
+                      << currentEstimate << " of our current sync source, " << currentSource;
+                return true;
+            }
+        }
+    }
+
     return false;
 }
 
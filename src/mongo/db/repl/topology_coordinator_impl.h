@@ -121,6 +121,38 @@ private:
     int _numFailuresSinceLastStart = std::numeric_limits<int>::max();
 };
 
+/**
+ * Represents the oplog fetch throughput observed from a replica set member while it was our sync
+ * source. Like PingStats, the measurement is an average weighted 80% to the old value, and 20% to
+ * the new value.
+ */
+class SyncSourceThroughputStats {
+public:
+    /**
+     * Records that a batch of "bytes" bytes of oplog entries took "elapsed" to fetch.
+     */
+    void hit(std::size_t bytes, Milliseconds elapsed);
+
+    /**
+     * Gets the number of hit() calls.
+     */
+    unsigned int getCount() const {
+        return _count;
+    }
+
+    /**
+     * Gets the weighted average fetch throughput in bytes per second.
+     * Returns 0 if no batches have been recorded yet.
+     */
+    double getBytesPerSecond() const {
+        return _bytesPerSecond;
+    }
+
+private:
+    unsigned int _count = 0;
+    double _bytesPerSecond = 0;
+};
+
 class TopologyCoordinatorImpl : public TopologyCoordinator {
 public:
     struct Options {
@@ -129,6 +161,15 @@ public:
 
         // Whether or not this node is running as a config server.
         ClusterRole clusterRole{ClusterRole::None};
+
+        // If true, sync sources are chosen to minimize our expected replication lag, estimated
+        // from ping time, how far the candidate is behind the primary and the oplog fetch
+        // throughput measured while syncing from it, instead of by ping time alone.
+        bool useMeasuredSyncSourceThroughput{false};
+
+        // When choosing sync sources by expected lag, the current sync source is only replaced
+        // by a better candidate after it has been used for at least this long.
+        Seconds syncSourceReselectionMinInterval{60};
     };
 
     /**
@@ -154,6 +195,9 @@ public:
                                             const OpTime& lastOpTimeFetched,
                                             ChainingPreference chainingPreference) override;
     virtual void blacklistSyncSource(const HostAndPort& host, Date_t until);
+    virtual void recordSyncSourceFetchStats(const HostAndPort& host,
+                                            std::size_t bytes,
+                                            Milliseconds elapsed);
     virtual void unblacklistSyncSource(const HostAndPort& host, Date_t now);
     virtual void clearSyncSourceBlacklist();
     virtual bool shouldChangeSyncSource(const HostAndPort& currentSource,
@@ -395,6 +439,35 @@ private:
      **/
     bool _memberIsBlacklisted(const MemberConfig& memberConfig, Date_t now) const;
 
+    /**
+     * Returns the replication lag we expect to have if we sync from the member at "memberIndex".
+     * This is the member's ping time, plus how far it is behind "primaryOpTime", plus the time
+     * it would take to fetch a full batch of oplog entries from it. Members whose throughput has
+     * not been measured are assumed to fetch as fast as the median measured member, so that they
+     * neither always win nor always lose against measured members. A null "primaryOpTime" means
+     * the primary's position is unknown.
+     */
+    Milliseconds _estimateSyncSourceLag(int memberIndex, const OpTime& primaryOpTime) const;
+
+    /**
+     * Returns the time it would take to fetch a full batch of oplog entries from "host" at the
+     * throughput measured from it, or boost::none if it has not been measured.
+     */
+    boost::optional<Milliseconds> _getMeasuredSyncSourceFetchTime(const HostAndPort& host) const;
+
+    /**
+     * Returns the median of the measured fetch times over all members, or 0 if none is measured.
+     */
+    Milliseconds _getMedianSyncSourceFetchTime() const;
+
+    /**
+     * Returns true if the member at "candidateIndex" is a better sync source than the member at
+     * "bestIndex" so far. A "bestIndex" of -1 means there is no best candidate yet.
+     */
+    bool _isBetterSyncSourceCandidate(int candidateIndex,
+                                      int bestIndex,
+                                      const OpTime& primaryOpTime);
+
     /**
      * Returns true if we are a one-node replica set, we're the one member,
      * we're electable, we're not in maintenance mode, and we are currently in followerMode
@@ -428,6 +501,12 @@ private:
     std::map<HostAndPort, Date_t> _syncSourceBlacklist;
     // The next sync source to be chosen, requested via a replSetSyncFrom command
     int _forceSyncSourceIndex;
+    // Why _syncSource was chosen, reported by replSetGetStatus.
+    std::string _syncSourceSelectionReason;
+    // When _syncSource was chosen.
+    Date_t _syncSourceSelectedDate;
+    // Whether _syncSource was requested via a replSetSyncFrom command.
+    bool _syncSourceForced = false;
 
     // Options for this TopologyCoordinator
     Options _options;
@@ -483,6 +562,9 @@ private:
     // Ping stats for each member by HostAndPort;
     PingMap _pings;
 
+    // Oplog fetch throughput for each member we have synced from, by HostAndPort.
+    std::map<HostAndPort, SyncSourceThroughputStats> _syncSourceThroughput;
+
     // Last vote info from the election
     struct VoteLease {
         static const Seconds leaseTime;
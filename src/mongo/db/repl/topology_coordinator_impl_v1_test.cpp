@@ -680,6 +680,295 @@ TEST_F(TopoCoordTest, ChooseOnlyVotersAsSyncSourceWhenNodeIsAVoter) {
     ASSERT_EQUALS(h3, newSource);
 }
 
+TEST_F(TopoCoordTest, ChooseSyncSourceWithLowestExpectedLagWhenUsingMeasuredThroughput) {
+    TopologyCoordinatorImpl::Options options;
+    options.maxSyncSourceLagSecs = Seconds{100};
+    options.useMeasuredSyncSourceThroughput = true;
+    setOptions(options);
+    updateConfig(fromjson("{_id:'rs0', version:1, members:["
+                          "{_id:10, host:'hself'}, "
+                          "{_id:20, host:'h2'}, "
+                          "{_id:30, host:'h3'} "
+                          "]}"),
+                 0);
+
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    HostAndPort h2("h2"), h3("h3");
+    OpTime ot5(Timestamp(5, 0), 0);
+    Milliseconds hbRTT10(10), hbRTT50(50);
+
+    // Two rounds of heartbeat pings from each member.
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+
+    // Without any throughput measurements, the closest member is chosen.
+    ASSERT_EQUALS(h2,
+                  getTopoCoord().chooseNewSyncSource(
+                      now()++,
+                      OpTime(),
+                      TopologyCoordinator::ChainingPreference::kUseConfiguration));
+
+    // Batches that are too small to measure throughput are ignored.
+    getTopoCoord().recordSyncSourceFetchStats(h2, 512 * 1024, Milliseconds(4000));
+    ASSERT_EQUALS(h2,
+                  getTopoCoord().chooseNewSyncSource(
+                      now()++,
+                      OpTime(),
+                      TopologyCoordinator::ChainingPreference::kUseConfiguration));
+
+    // h2 serves oplog much more slowly than h3, which outweighs its lower ping time.
+    getTopoCoord().recordSyncSourceFetchStats(h2, 2 * 1024 * 1024, Milliseconds(4000));
+    getTopoCoord().recordSyncSourceFetchStats(h3, 2 * 1024 * 1024, Milliseconds(20));
+    ASSERT_EQUALS(h3,
+                  getTopoCoord().chooseNewSyncSource(
+                      now()++,
+                      OpTime(),
+                      TopologyCoordinator::ChainingPreference::kUseConfiguration));
+
+    // The reason for choosing h3 is reported by replSetGetStatus.
+    BSONObjBuilder statusBuilder;
+    Status resultStatus(ErrorCodes::InternalError, "prepareStatusResponse didn't set result");
+    getTopoCoord().prepareStatusResponse(
+        TopologyCoordinator::ReplSetStatusArgs{now(), 10, OpTime(), BSONObj()},
+        &statusBuilder,
+        &resultStatus);
+    ASSERT_OK(resultStatus);
+    BSONObj rsStatus = statusBuilder.obj();
+    ASSERT_EQUALS("h3:27017", rsStatus["syncingTo"].str());
+    ASSERT_STRING_CONTAINS(rsStatus["syncSourceSelectionReason"].str(),
+                           "lowest expected replication lag");
+}
+
+TEST_F(TopoCoordTest, UnmeasuredSyncSourceIsNotPreferredOverMeasuredOne) {
+    TopologyCoordinatorImpl::Options options;
+    options.maxSyncSourceLagSecs = Seconds{100};
+    options.useMeasuredSyncSourceThroughput = true;
+    setOptions(options);
+    updateConfig(fromjson("{_id:'rs0', version:1, members:["
+                          "{_id:10, host:'hself'}, "
+                          "{_id:20, host:'h2'}, "
+                          "{_id:30, host:'h3'} "
+                          "]}"),
+                 0);
+
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    HostAndPort h2("h2"), h3("h3");
+    OpTime ot5(Timestamp(5, 0), 0);
+    Milliseconds hbRTT10(10), hbRTT50(50);
+
+    // Two rounds of heartbeat pings from each member.
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+
+    // Only h2 has been measured. h3 is assumed to fetch as fast as h2 rather than instantly, so
+    // the closer h2 keeps being chosen.
+    getTopoCoord().recordSyncSourceFetchStats(h2, 16 * 1024 * 1024, Milliseconds(2000));
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQUALS(
+            h2,
+            getTopoCoord().chooseNewSyncSource(
+                now()++, OpTime(), TopologyCoordinator::ChainingPreference::kUseConfiguration));
+    }
+}
+
+TEST_F(TopoCoordTest, ChooseClosestSyncSourceWhenNotUsingMeasuredThroughput) {
+    updateConfig(fromjson("{_id:'rs0', version:1, members:["
+                          "{_id:10, host:'hself'}, "
+                          "{_id:20, host:'h2'}, "
+                          "{_id:30, host:'h3'} "
+                          "]}"),
+                 0);
+
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    HostAndPort h2("h2"), h3("h3");
+    OpTime ot5(Timestamp(5, 0), 0);
+    Milliseconds hbRTT10(10), hbRTT50(50);
+
+    // Two rounds of heartbeat pings from each member.
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+
+    // Throughput measurements have no effect unless enabled.
+    getTopoCoord().recordSyncSourceFetchStats(h2, 2 * 1024 * 1024, Milliseconds(4000));
+    getTopoCoord().recordSyncSourceFetchStats(h3, 2 * 1024 * 1024, Milliseconds(20));
+    ASSERT_EQUALS(h2,
+                  getTopoCoord().chooseNewSyncSource(
+                      now()++,
+                      OpTime(),
+                      TopologyCoordinator::ChainingPreference::kUseConfiguration));
+}
+
+TEST_F(TopoCoordTest, ShouldChangeToSyncSourceWithLowerExpectedLagOnlyAfterReselectionInterval) {
+    TopologyCoordinatorImpl::Options options;
+    options.maxSyncSourceLagSecs = Seconds{100};
+    options.useMeasuredSyncSourceThroughput = true;
+    options.syncSourceReselectionMinInterval = Seconds{60};
+    setOptions(options);
+    updateConfig(fromjson("{_id:'rs0', version:1, members:["
+                          "{_id:10, host:'hself'}, "
+                          "{_id:20, host:'h2'}, "
+                          "{_id:30, host:'h3'} "
+                          "]}"),
+                 0);
+
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    HostAndPort h2("h2"), h3("h3");
+    OpTime ot5(Timestamp(5, 0), 0);
+    Milliseconds hbRTT10(10), hbRTT50(50);
+
+    // Two rounds of heartbeat pings from each member.
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+
+    ASSERT_EQUALS(h2,
+                  getTopoCoord().chooseNewSyncSource(
+                      now()++,
+                      OpTime(),
+                      TopologyCoordinator::ChainingPreference::kUseConfiguration));
+
+    // h3 now looks much better, but h2 was only just chosen.
+    getTopoCoord().recordSyncSourceFetchStats(h2, 16 * 1024 * 1024, Milliseconds(20000));
+    getTopoCoord().recordSyncSourceFetchStats(h3, 16 * 1024 * 1024, Milliseconds(950));
+    ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(
+        h2, makeReplSetMetadata(), makeOplogQueryMetadata(ot5, -1, 1), now()));
+
+    // Once the reselection interval has passed, we switch.
+    now() += Seconds(60);
+    ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(
+        h2, makeReplSetMetadata(), makeOplogQueryMetadata(ot5, -1, 1), now()));
+}
+
+TEST_F(TopoCoordTest, ShouldNotChangeToSyncSourceWithSlightlyLowerExpectedLag) {
+    TopologyCoordinatorImpl::Options options;
+    options.maxSyncSourceLagSecs = Seconds{100};
+    options.useMeasuredSyncSourceThroughput = true;
+    options.syncSourceReselectionMinInterval = Seconds{60};
+    setOptions(options);
+    updateConfig(fromjson("{_id:'rs0', version:1, members:["
+                          "{_id:10, host:'hself'}, "
+                          "{_id:20, host:'h2'}, "
+                          "{_id:30, host:'h3'} "
+                          "]}"),
+                 0);
+
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    HostAndPort h2("h2"), h3("h3");
+    OpTime ot5(Timestamp(5, 0), 0);
+    Milliseconds hbRTT10(10), hbRTT50(50);
+
+    // Two rounds of heartbeat pings from each member.
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+
+    ASSERT_EQUALS(h2,
+                  getTopoCoord().chooseNewSyncSource(
+                      now()++,
+                      OpTime(),
+                      TopologyCoordinator::ChainingPreference::kUseConfiguration));
+
+    // h3 is expected to be only slightly better than h2, which is not worth a switch.
+    getTopoCoord().recordSyncSourceFetchStats(h2, 16 * 1024 * 1024, Milliseconds(1000));
+    getTopoCoord().recordSyncSourceFetchStats(h3, 16 * 1024 * 1024, Milliseconds(900));
+    now() += Seconds(60);
+    ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(
+        h2, makeReplSetMetadata(), makeOplogQueryMetadata(ot5, -1, 1), now()));
+}
+
+TEST_F(TopoCoordTest, ShouldNotChangeFromPrimaryToSyncSourceWithLowerExpectedLagWithoutChaining) {
+    TopologyCoordinatorImpl::Options options;
+    options.maxSyncSourceLagSecs = Seconds{100};
+    options.useMeasuredSyncSourceThroughput = true;
+    options.syncSourceReselectionMinInterval = Seconds{60};
+    setOptions(options);
+    updateConfig(fromjson("{_id:'rs0', version:1, settings:{chainingAllowed:false}, members:["
+                          "{_id:10, host:'hself'}, "
+                          "{_id:20, host:'h2'}, "
+                          "{_id:30, host:'h3'} "
+                          "]}"),
+                 0);
+
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    HostAndPort h2("h2"), h3("h3");
+    OpTime ot5(Timestamp(5, 0), 0);
+    Milliseconds hbRTT10(10), hbRTT50(50);
+
+    // Two rounds of heartbeat pings from each member.
+    heartbeatFromMember(h2, "rs0", MemberState::RS_PRIMARY, ot5, hbRTT10);
+    heartbeatFromMember(h2, "rs0", MemberState::RS_PRIMARY, ot5, hbRTT10);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+
+    ASSERT_EQUALS(h2,
+                  getTopoCoord().chooseNewSyncSource(
+                      now()++,
+                      OpTime(),
+                      TopologyCoordinator::ChainingPreference::kUseConfiguration));
+
+    // h3 looks much better, but chaining is not allowed, so we keep syncing from the primary.
+    getTopoCoord().recordSyncSourceFetchStats(h2, 16 * 1024 * 1024, Milliseconds(20000));
+    getTopoCoord().recordSyncSourceFetchStats(h3, 16 * 1024 * 1024, Milliseconds(950));
+    now() += Seconds(60);
+    ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(
+        h2, makeReplSetMetadata(), makeOplogQueryMetadata(ot5, 1, -1), now()));
+}
+
+TEST_F(TopoCoordTest, ShouldNotChangeFromRequestedSyncSourceToOneWithLowerExpectedLag) {
+    TopologyCoordinatorImpl::Options options;
+    options.maxSyncSourceLagSecs = Seconds{100};
+    options.useMeasuredSyncSourceThroughput = true;
+    options.syncSourceReselectionMinInterval = Seconds{60};
+    setOptions(options);
+    updateConfig(fromjson("{_id:'rs0', version:1, members:["
+                          "{_id:10, host:'hself'}, "
+                          "{_id:20, host:'h2'}, "
+                          "{_id:30, host:'h3'} "
+                          "]}"),
+                 0);
+
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    HostAndPort h2("h2"), h3("h3");
+    OpTime ot5(Timestamp(5, 0), 0);
+    Milliseconds hbRTT10(10), hbRTT50(50);
+
+    // Two rounds of heartbeat pings from each member.
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h2, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT10);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+    heartbeatFromMember(h3, "rs0", MemberState::RS_SECONDARY, ot5, hbRTT50);
+
+    // h3 was requested via replSetSyncFrom.
+    getTopoCoord().setForceSyncSourceIndex(2);
+    ASSERT_EQUALS(h3,
+                  getTopoCoord().chooseNewSyncSource(
+                      now()++,
+                      OpTime(),
+                      TopologyCoordinator::ChainingPreference::kUseConfiguration));
+
+    // h2 looks much better, but the user asked for h3.
+    getTopoCoord().recordSyncSourceFetchStats(h2, 16 * 1024 * 1024, Milliseconds(950));
+    getTopoCoord().recordSyncSourceFetchStats(h3, 16 * 1024 * 1024, Milliseconds(20000));
+    now() += Seconds(60);
+    ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(
+        h3, makeReplSetMetadata(), makeOplogQueryMetadata(ot5, -1, 1), now()));
+}
+
 TEST_F(TopoCoordTest, ChooseSameSyncSourceEvenWhenPrimary) {
     updateConfig(BSON("_id"
                       << "rs0"
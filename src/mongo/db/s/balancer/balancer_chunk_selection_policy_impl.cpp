@@ -43,6 +43,7 @@
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/shard_util.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -113,6 +114,40 @@ StatusWith<DistributionStatus> createCollectionDistributionStatus(
     return {std::move(distribution)};
 }
 
+/**
+ * Obtains the size of the collection's data on each of the shards, which own chunks for it, and
+ * records them in the distribution, so that it gets balanced by data size and shard load. If the
+ * size cannot be obtained from any of the shards, records nothing and the collection is balanced
+ * by number of chunks instead.
+ */
+void addCollectionDataSizes(OperationContext* opCtx,
+                            const ShardStatisticsVector& allShards,
+                            DistributionStatus* distribution) {
+    std::map<ShardId, long long> dataSizes;
+
+    for (const auto& stat : allShards) {
+        if (!distribution->numberOfChunksInShard(stat.shardId)) {
+            continue;
+        }
+
+        auto dataSizeStatus =
+            shardutil::retrieveCollectionDataSize(opCtx, stat.shardId, distribution->nss());
+        if (!dataSizeStatus.isOK()) {
+            warning() << "Unable to obtain the size of collection " << distribution->nss()
+                      << " on shard " << stat.shardId
+                      << ", so it will be balanced by number of chunks"
+                      << causedBy(dataSizeStatus.getStatus());
+            return;
+        }
+
+        dataSizes[stat.shardId] = dataSizeStatus.getValue();
+    }
+
+    for (const auto& dataSize : dataSizes) {
+        distribution->setDataSizeOnShard(dataSize.first, dataSize.second);
+    }
+}
+
 /**
  * Helper class used to accumulate the split points for the same chunk together so they can be
  * submitted to the shard as a single call versus multiple. This is necessary in order to avoid
@@ -425,12 +460,12 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
 
     const auto& shardKeyPattern = cm->getShardKeyPattern().getKeyPattern();
 
-    const auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
+    auto collInfoStatus = createCollectionDistributionStatus(opCtx, shardStats, cm);
     if (!collInfoStatus.isOK()) {
         return collInfoStatus.getStatus();
     }
 
-    const DistributionStatus& distribution = collInfoStatus.getValue();
+    DistributionStatus& distribution = collInfoStatus.getValue();
 
     for (const auto& tagRangeEntry : distribution.tagRanges()) {
         const auto& tagRange = tagRangeEntry.second;
@@ -473,6 +508,10 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         }
     }
 
+    if (balancerBalanceByDataSizeAndLoad.load()) {
+        addCollectionDataSizes(opCtx, shardStats, &distribution);
+    }
+
     return BalancerPolicy::balance(shardStats, distribution, aggressiveBalanceHint);
 }
 
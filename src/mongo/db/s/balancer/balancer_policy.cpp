@@ -33,6 +33,7 @@
 #include "mongo/db/s/balancer/balancer_policy.h"
 
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -53,8 +54,20 @@ namespace {
 const size_t kDefaultImbalanceThreshold = 2;
 const size_t kAggressiveImbalanceThreshold = 1;
 
+// These values indicate the minimum difference between the costs of two shards in a zone for a
+// rebalancing migration to be initiated, when balancing by cost. The cost of the average shard is
+// one plus the load weight.
+const double kDefaultCostImbalanceThreshold = 0.2;
+const double kAggressiveCostImbalanceThreshold = 0.1;
+
+// Weight of a shard's share of the operations load relative to its share of the data, when
+// balancing by cost
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadCostWeight, double, 1.0);
+
 }  // namespace
 
+MONGO_EXPORT_SERVER_PARAMETER(balancerBalanceByDataSizeAndLoad, bool, false);
+
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
     : _nss(std::move(nss)),
       _shardChunks(std::move(shardToChunksMap)),
@@ -107,6 +120,25 @@ const vector<ChunkType>& DistributionStatus::getChunks(const ShardId& shardId) c
     return i->second;
 }
 
+void DistributionStatus::setDataSizeOnShard(const ShardId& shardId, long long dataSizeBytes) {
+    _shardDataSizes[shardId] = dataSizeBytes;
+}
+
+long long DistributionStatus::estimatedChunkSizeOnShard(const ShardId& shardId) const {
+    const auto it = _shardDataSizes.find(shardId);
+    const size_t numChunks = numberOfChunksInShard(shardId);
+    if (it == _shardDataSizes.end() || !numChunks) {
+        return 0;
+    }
+
+    return it->second / numChunks;
+}
+
+long long DistributionStatus::estimatedDataSizeInShardWithTag(const ShardId& shardId,
+                                                              const string& tag) const {
+    return estimatedChunkSizeOnShard(shardId) * numberOfChunksInShardWithTag(shardId, tag);
+}
+
 Status DistributionStatus::addRangeToZone(const ZoneRange& range) {
     const auto minIntersect = _zoneRanges.upper_bound(range.min);
     const auto maxIntersect = _zoneRanges.upper_bound(range.max);
@@ -183,6 +215,11 @@ void DistributionStatus::report(BSONObjBuilder* builder) const {
         BSONObjBuilder shardEntry(shardArr.subobjStart());
         shardEntry.append("name", shardChunk.first.toString());
 
+        const auto dataSizeIt = _shardDataSizes.find(shardChunk.first);
+        if (dataSizeIt != _shardDataSizes.end()) {
+            shardEntry.append("dataSizeBytes", dataSizeIt->second);
+        }
+
         BSONArrayBuilder chunkArr(shardEntry.subarrayStart("chunks"));
         for (const auto& chunk : shardChunk.second) {
             chunkArr.append(chunk.toConfigBSON());
@@ -423,6 +460,21 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             continue;
         }
 
+        if (distribution.hasDataSizes()) {
+            const double costImbalanceThreshold = shouldAggressivelyBalance
+                ? kAggressiveCostImbalanceThreshold
+                : kDefaultCostImbalanceThreshold;
+
+            while (_singleZoneBalanceByCost(shardStats,
+                                            distribution,
+                                            tag,
+                                            costImbalanceThreshold,
+                                            &migrations,
+                                            &usedShards))
+                ;
+            continue;
+        }
+
         // Calculate the ceiling of the optimal number of chunks per shard
         const size_t idealNumberOfChunksPerShardForTag =
             (totalNumberOfChunksWithTag / totalNumberOfShardsWithTag) +
@@ -528,6 +580,130 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_singleZoneBalanceByCost(const ShardStatisticsVector& shardStats,
+                                              const DistributionStatus& distribution,
+                                              const string& tag,
+                                              double imbalanceThreshold,
+                                              vector<MigrateInfo>* migrations,
+                                              set<ShardId>* usedShards) {
+    size_t numShardsWithTag = 0;
+    long long totalDataSize = 0;
+    double totalOpsPerSecond = 0;
+
+    for (const auto& stat : shardStats) {
+        totalDataSize += distribution.estimatedDataSizeInShardWithTag(stat.shardId, tag);
+
+        if (tag.empty() || stat.shardTags.count(tag)) {
+            numShardsWithTag++;
+            totalOpsPerSecond += stat.opsPerSecond;
+        }
+    }
+
+    if (!numShardsWithTag || totalDataSize <= 0)
+        return false;
+
+    const double loadWeight =
+        (totalOpsPerSecond > 0) ? std::max(0.0, balancerLoadCostWeight.load()) : 0;
+
+    const auto costOf = [&](double dataSize, double opsPerSecond) {
+        return numShardsWithTag *
+            (dataSize / totalDataSize +
+             (loadWeight > 0 ? loadWeight * opsPerSecond / totalOpsPerSecond : 0));
+    };
+
+    const auto shardCost = [&](const ClusterStatistics::ShardStatistics& stat) {
+        return costOf(distribution.estimatedDataSizeInShardWithTag(stat.shardId, tag),
+                      stat.opsPerSecond);
+    };
+
+    const ClusterStatistics::ShardStatistics* from = nullptr;
+    double maxCost = 0;
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId))
+            continue;
+
+        if (!distribution.numberOfChunksInShardWithTag(stat.shardId, tag))
+            continue;
+
+        const double cost = shardCost(stat);
+        if (!from || cost > maxCost) {
+            from = &stat;
+            maxCost = cost;
+        }
+    }
+
+    if (!from)
+        return false;
+
+    const ClusterStatistics::ShardStatistics* to = nullptr;
+    double minCost = 0;
+
+    for (const auto& stat : shardStats) {
+        if (usedShards->count(stat.shardId) || stat.shardId == from->shardId)
+            continue;
+
+        if (!isShardSuitableReceiver(stat, tag).isOK())
+            continue;
+
+        const double cost = shardCost(stat);
+        if (!to || cost < minCost) {
+            to = &stat;
+            minCost = cost;
+        }
+    }
+
+    if (!to) {
+        if (migrations->empty()) {
+            log() << "No available shards to take chunks for zone [" << tag << "]";
+        }
+        return false;
+    }
+
+    // The load of the donor is attributed evenly to its chunks of this collection
+    const double chunkCost =
+        costOf(distribution.estimatedChunkSizeOnShard(from->shardId),
+               from->opsPerSecond / distribution.numberOfChunksInShard(from->shardId));
+
+    LOG(1) << "collection : " << distribution.nss().ns();
+    LOG(1) << "zone       : " << tag;
+    LOG(1) << "donor      : " << from->shardId << " cost " << maxCost;
+    LOG(1) << "receiver   : " << to->shardId << " cost " << minCost;
+    LOG(1) << "chunk cost : " << chunkCost;
+    LOG(1) << "threshold  : " << imbalanceThreshold;
+
+    // Check whether it is necessary and useful to balance within this zone
+    if (maxCost - minCost < std::max(imbalanceThreshold, 2 * chunkCost))
+        return false;
+
+    const vector<ChunkType>& chunks = distribution.getChunks(from->shardId);
+
+    unsigned numJumboChunks = 0;
+
+    for (const auto& chunk : chunks) {
+        if (distribution.getTagForChunk(chunk) != tag)
+            continue;
+
+        if (chunk.getJumbo()) {
+            numJumboChunks++;
+            continue;
+        }
+
+        migrations->emplace_back(to->shardId, chunk);
+        invariant(usedShards->insert(chunk.getShard()).second);
+        invariant(usedShards->insert(to->shardId).second);
+        return true;
+    }
+
+    if (numJumboChunks) {
+        warning() << "Shard: " << from->shardId << ", collection: " << distribution.nss().ns()
+                  << " has only jumbo chunks for zone \'" << tag
+                  << "\' and cannot be balanced. Jumbo chunks count: " << numJumboChunks;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
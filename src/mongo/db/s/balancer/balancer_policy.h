@@ -32,11 +32,16 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard.h"
 
 namespace mongo {
 
+// When true, the balancer obtains the size of each sharded collection on every shard and balances
+// the collections by data size and shard load instead of by number of chunks
+extern AtomicBool balancerBalanceByDataSizeAndLoad;
+
 struct ZoneRange {
     ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone);
 
@@ -116,6 +121,32 @@ public:
      */
     const std::vector<ChunkType>& getChunks(const ShardId& shardId) const;
 
+    /**
+     * Records the size of the collection's data on the specified shard. Once any sizes have been
+     * recorded, the balancer policy balances the collection by data size and shard load instead of
+     * by number of chunks, so the sizes should be recorded for all the shards, which own chunks.
+     */
+    void setDataSizeOnShard(const ShardId& shardId, long long dataSizeBytes);
+
+    /**
+     * Returns whether the data sizes of the collection on the shards are known.
+     */
+    bool hasDataSizes() const {
+        return !_shardDataSizes.empty();
+    }
+
+    /**
+     * Returns the estimated size of each of the chunks on the specified shard. Since the sizes of
+     * individual chunks are not tracked, the collection's data on the shard is assumed to be split
+     * evenly between its chunks. Returns zero if the shard has no chunks or no recorded size.
+     */
+    long long estimatedChunkSizeOnShard(const ShardId& shardId) const;
+
+    /**
+     * Returns the estimated size of the chunks in the specified shard, which have the given tag.
+     */
+    long long estimatedDataSizeInShardWithTag(const ShardId& shardId, const std::string& tag) const;
+
     /**
      * Returns all tag ranges defined for the collection.
      */
@@ -149,6 +180,9 @@ private:
     // Map of what chunks are owned by each shard
     ShardToChunksMap _shardChunks;
 
+    // Map of the size in bytes of the collection's data on each shard, if known
+    std::map<ShardId, long long> _shardDataSizes;
+
     // Map of zone max key to the zone description
     BSONObjIndexedMap<ZoneRange> _zoneRanges;
 
@@ -177,6 +211,11 @@ public:
      * any of the shards have chunks, which are sufficiently higher than this number, suggests
      * moving chunks to shards, which are under this number.
      *
+     * If the data sizes of the collection on the shards are known, the optimum is instead defined
+     * in terms of a cost for each shard, which combines its share of the collection's data in the
+     * zone with its share of the operations load. Chunks are moved from the most costly shards to
+     * the least costly ones. See _singleZoneBalanceByCost for details.
+     *
      * The shouldAggressivelyBalance parameter causes the threshold for chunk could disparity
      * between shards to be lowered.
      */
@@ -230,6 +269,24 @@ private:
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
                                    std::set<ShardId>* usedShards);
+
+    /**
+     * Same as _singleZoneBalance, but balances by cost instead of by number of chunks. The cost of
+     * a shard is its share of the collection's data in the zone plus its share of the operations
+     * load of the zone's shards, weighted by the balancerLoadCostWeight parameter, scaled so that
+     * the cost of the average shard does not depend on the number of shards.
+     *
+     * A chunk is moved from the costliest to the cheapest shard if their costs differ by at least
+     * 'imbalanceThreshold' and by at least twice the estimated cost of the chunk, so that the
+     * migration does not make the recipient costlier than the donor and cause the chunk to be
+     * moved back in a later round.
+     */
+    static bool _singleZoneBalanceByCost(const ShardStatisticsVector& shardStats,
+                                         const DistributionStatus& distribution,
+                                         const std::string& tag,
+                                         double imbalanceThreshold,
+                                         std::vector<MigrateInfo>* migrations,
+                                         std::set<ShardId>* usedShards);
 };
 
 }  // namespace mongo
@@ -110,6 +110,132 @@ std::pair<ShardStatisticsVector, ShardToChunksMap> generateCluster(
     return std::make_pair(std::move(shardStats), std::move(chunkMap));
 }
 
+/**
+ * Simulates balancing rounds over a synthetic cluster, in which every chunk has its own data size
+ * and operations load. Each round reports the collection's data size on the shards and the load of
+ * the shards to the policy the way the balancer does and then applies the suggested migrations, so
+ * that the chunks take their size and load along to the recipient.
+ */
+class BalancingSimulation {
+public:
+    struct ChunkSpec {
+        long long sizeBytes;
+        double opsPerSecond;
+    };
+
+    explicit BalancingSimulation(
+        const vector<std::pair<ShardStatistics, vector<ChunkSpec>>>& shardsAndChunks)
+        : _chunkSpecs(SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ChunkSpec>()) {
+        vector<std::pair<ShardStatistics, size_t>> shardsAndNumChunks;
+        for (const auto& entry : shardsAndChunks) {
+            shardsAndNumChunks.emplace_back(entry.first, entry.second.size());
+        }
+
+        auto cluster = generateCluster(shardsAndNumChunks);
+        _shardStats = std::move(cluster.first);
+        _chunkMap = std::move(cluster.second);
+
+        for (const auto& entry : shardsAndChunks) {
+            const auto& chunks = _chunkMap[entry.first.shardId];
+            for (size_t i = 0; i < chunks.size(); i++) {
+                _chunkSpecs.emplace(chunks[i].getMin(), entry.second[i]);
+            }
+        }
+    }
+
+    /**
+     * Runs a single balancing round, applies the suggested migrations and returns them. Unless
+     * 'byCost' is false, the collection is balanced by data size and load.
+     */
+    vector<MigrateInfo> runRound(bool byCost = true) {
+        DistributionStatus distribution(kNamespace, _chunkMap);
+
+        for (auto& stat : _shardStats) {
+            stat.opsPerSecond = 0;
+
+            long long dataSize = 0;
+            for (const auto& chunk : _chunkMap[stat.shardId]) {
+                const auto& spec = _chunkSpecs.find(chunk.getMin())->second;
+                dataSize += spec.sizeBytes;
+                stat.opsPerSecond += spec.opsPerSecond;
+            }
+
+            if (byCost) {
+                distribution.setDataSizeOnShard(stat.shardId, dataSize);
+            }
+        }
+
+        auto migrations = BalancerPolicy::balance(_shardStats, distribution, false);
+
+        // The migrations of a round must not share shards, so that they can run concurrently
+        std::set<ShardId> usedShards;
+        for (const auto& migration : migrations) {
+            ASSERT(usedShards.insert(migration.from).second);
+            ASSERT(usedShards.insert(migration.to).second);
+
+            _moveChunk(migration);
+        }
+
+        return migrations;
+    }
+
+    /**
+     * Runs balancing rounds until the policy does not suggest any migrations and returns the
+     * number of rounds, which had migrations. Fails if that does not happen within 'maxRounds'.
+     */
+    int runUntilBalanced(int maxRounds = 100) {
+        int numRounds = 0;
+        while (!runRound().empty()) {
+            ASSERT_LT(++numRounds, maxRounds);
+        }
+
+        return numRounds;
+    }
+
+    size_t numChunksOnShard(const ShardId& shardId) {
+        return _chunkMap[shardId].size();
+    }
+
+    long long dataSizeOnShard(const ShardId& shardId) {
+        long long dataSize = 0;
+        for (const auto& chunk : _chunkMap[shardId]) {
+            dataSize += _chunkSpecs.find(chunk.getMin())->second.sizeBytes;
+        }
+
+        return dataSize;
+    }
+
+private:
+    void _moveChunk(const MigrateInfo& migration) {
+        auto& donorChunks = _chunkMap[migration.from];
+        auto it = std::find_if(donorChunks.begin(), donorChunks.end(), [&](const ChunkType& chunk) {
+            return SimpleBSONObjComparator::kInstance.evaluate(chunk.getMin() == migration.minKey);
+        });
+        ASSERT(it != donorChunks.end());
+
+        ChunkType chunk = *it;
+        donorChunks.erase(it);
+
+        chunk.setShard(migration.to);
+        _chunkMap[migration.to].push_back(std::move(chunk));
+    }
+
+    ShardStatisticsVector _shardStats;
+    ShardToChunksMap _chunkMap;
+    BSONObjIndexedMap<ChunkSpec> _chunkSpecs;
+};
+
+const long long kMB = 1024 * 1024;
+
+/**
+ * Returns 'numChunks' chunk specifications with the specified size and load.
+ */
+vector<BalancingSimulation::ChunkSpec> makeChunkSpecs(size_t numChunks,
+                                                      long long sizeBytes,
+                                                      double opsPerSecond = 0) {
+    return vector<BalancingSimulation::ChunkSpec>(numChunks, {sizeBytes, opsPerSecond});
+}
+
 TEST(BalancerPolicy, Basic) {
     auto cluster = generateCluster(
         {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
@@ -553,6 +679,64 @@ TEST(BalancerPolicy, BalancerHandlesNoShardsWithTag) {
     ASSERT(BalancerPolicy::balance(cluster.first, distribution, false).empty());
 }
 
+TEST(BalancerPolicy, CostBasedBalancingMovesDataOffShardWithLargerChunks) {
+    BalancingSimulation simulation(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+          makeChunkSpecs(4, 100 * kMB)},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+          makeChunkSpecs(4, 10 * kMB)},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+          makeChunkSpecs(4, 10 * kMB)}});
+
+    // The number of chunks is even, so balancing by chunk count does nothing
+    ASSERT(simulation.runRound(false).empty());
+
+    ASSERT_EQ(2, simulation.runUntilBalanced());
+    ASSERT_EQ(200 * kMB, simulation.dataSizeOnShard(kShardId0));
+    ASSERT_EQ(140 * kMB, simulation.dataSizeOnShard(kShardId1));
+    ASSERT_EQ(140 * kMB, simulation.dataSizeOnShard(kShardId2));
+}
+
+TEST(BalancerPolicy, CostBasedBalancingMovesChunksOffHotShard) {
+    BalancingSimulation simulation(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+          makeChunkSpecs(10, 10 * kMB, 100)},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+          makeChunkSpecs(10, 10 * kMB, 0)}});
+
+    ASSERT(simulation.runRound(false).empty());
+
+    // The hot shard keeps fewer chunks, so that the sum of its shares of the data and the load
+    // approaches that of the other shard
+    ASSERT_EQ(3, simulation.runUntilBalanced());
+    ASSERT_EQ(7U, simulation.numChunksOnShard(kShardId0));
+    ASSERT_EQ(13U, simulation.numChunksOnShard(kShardId1));
+}
+
+TEST(BalancerPolicy, CostBasedBalancingSchedulesParallelMigrations) {
+    BalancingSimulation simulation(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+          makeChunkSpecs(4, 100 * kMB)},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+          makeChunkSpecs(4, 100 * kMB)},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+          makeChunkSpecs(4, 10 * kMB)},
+         {ShardStatistics(kShardId3, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+          makeChunkSpecs(4, 10 * kMB)}});
+
+    const auto migrations = simulation.runRound();
+    ASSERT_EQ(2U, migrations.size());
+
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+
+    ASSERT_EQ(kShardId1, migrations[1].from);
+    ASSERT_EQ(kShardId3, migrations[1].to);
+
+    // Moving another chunk would make the recipients costlier than the donors
+    ASSERT_EQ(0, simulation.runUntilBalanced());
+}
+
 TEST(DistributionStatus, AddTagRangeOverlap) {
     DistributionStatus d(kNamespace, ShardToChunksMap{});
 
@@ -72,6 +72,7 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+    builder.append("opsPerSecond", opsPerSecond);
     return builder.obj();
 }
 
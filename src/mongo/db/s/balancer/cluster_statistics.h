@@ -92,6 +92,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Rate of operations served by this shard's primary since the previous time statistics
+        // were collected. Zero if it is not known yet.
+        double opsPerSecond{0};
     };
 
     virtual ~ClusterStatistics();
@@ -51,16 +51,15 @@ using std::vector;
 namespace {
 
 const char kVersionField[] = "version";
+const char kOpCountersField[] = "opcounters";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Returns the serverStatus response or an error. Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -81,15 +80,26 @@ StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId s
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
-    string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
-    if (!status.isOK()) {
-        return status;
+/**
+ * Returns the sum of all the operation counters in the specified serverStatus response or zero if
+ * they are not present.
+ */
+long long sumOpCounters(const BSONObj& serverStatus) {
+    long long totalOps = 0;
+
+    const auto opCounters = serverStatus[kOpCountersField];
+    if (opCounters.type() == Object) {
+        for (const auto& counter : opCounters.Obj()) {
+            if (counter.isNumber()) {
+                totalOps += counter.safeNumberLong();
+            }
+        }
     }
 
-    return version;
+    return totalOps;
 }
 
 }  // namespace
@@ -136,15 +146,28 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
         }
 
         string mongoDVersion;
+        double opsPerSecond = 0;
+
+        auto serverStatusStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        if (serverStatusStatus.isOK()) {
+            const auto& serverStatus = serverStatusStatus.getValue();
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
-        } else {
             // Since the mongod version is only used for reporting, there is no need to fail the
             // entire round if it cannot be retrieved, so just leave it empty
-            log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+            Status versionStatus =
+                bsonExtractStringField(serverStatus, kVersionField, &mongoDVersion);
+            if (!versionStatus.isOK()) {
+                log() << "Unable to obtain shard version for " << shard.getName()
+                      << causedBy(versionStatus);
+            }
+
+            opsPerSecond = _updateOpsPerSecond(shard.getName(),
+                                               {sumOpCounters(serverStatus), Date_t::now()});
+        } else {
+            // The server status is only used for reporting and as an input to the cost-based
+            // balancing, so there is no need to fail the entire round if it cannot be retrieved
+            log() << "Unable to obtain server status for " << shard.getName()
+                  << causedBy(serverStatusStatus.getStatus());
         }
 
         std::set<string> shardTags;
@@ -159,9 +182,32 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().opsPerSecond = opsPerSecond;
     }
 
     return stats;
 }
 
+double ClusterStatisticsImpl::_updateOpsPerSecond(const ShardId& shardId,
+                                                  OpCountersSample sample) {
+    stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+    double opsPerSecond = 0;
+
+    auto it = _opCountersSamples.find(shardId);
+    if (it != _opCountersSamples.end()) {
+        const auto& previous = it->second;
+        const auto elapsedMillis =
+            durationCount<Milliseconds>(sample.sampledAt - previous.sampledAt);
+
+        // The counters go backwards if the shard's primary has restarted or changed
+        if (elapsedMillis > 0 && sample.totalOps >= previous.totalOps) {
+            opsPerSecond = (sample.totalOps - previous.totalOps) * 1000.0 / elapsedMillis;
+        }
+    }
+
+    _opCountersSamples[shardId] = sample;
+    return opsPerSecond;
+}
+
 }  // namespace mongo
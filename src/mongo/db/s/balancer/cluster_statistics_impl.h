@@ -28,7 +28,11 @@
 
 #pragma once
 
+#include <map>
+
 #include "mongo/db/s/balancer/cluster_statistics.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -43,6 +47,28 @@ public:
     ~ClusterStatisticsImpl();
 
     StatusWith<std::vector<ShardStatistics>> getStats(OperationContext* opCtx) override;
+
+private:
+    /**
+     * Total of the operation counters reported by a shard and the time they were obtained.
+     */
+    struct OpCountersSample {
+        long long totalOps;
+        Date_t sampledAt;
+    };
+
+    /**
+     * Records 'sample' as the latest sample for the specified shard and returns the rate of
+     * operations since the previous sample, or zero if there was none.
+     */
+    double _updateOpsPerSecond(const ShardId& shardId, OpCountersSample sample);
+
+    // Protects the samples below, since statistics may be collected concurrently by the balancer
+    // and by the commands, which check whether a migration is allowed
+    stdx::mutex _mutex;
+
+    // The latest operation counters sample for each shard
+    std::map<ShardId, OpCountersSample> _opCountersSamples;
 };
 
 }  // namespace mongo
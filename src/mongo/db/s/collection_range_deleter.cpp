@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -53,12 +54,14 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -67,11 +70,25 @@ class ChunkRange;
 using CallbackArgs = executor::TaskExecutor::CallbackArgs;
 using logger::LogComponent;
 
+// Number of documents to delete per batch of range deletion. A value of zero or less means to use
+// internalQueryExecYieldIterations.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchSize, int, 0);
+
 namespace {
 
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 Seconds(60));
+
+// Minimum time to wait between two batches of range deletions.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 20);
+
+// Upper bound on the delay between two batches of range deletions. When the majority of the
+// replica set takes longer than rangeDeleterBatchDelayMS to replicate a batch, the next batch is
+// delayed by that much longer, up to this bound, so that range deletion backs off while the
+// secondaries are lagging.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxBatchDelayMS, int, 1000);
+
 }  // unnamed namespace
 
 CollectionRangeDeleter::~CollectionRangeDeleter() {
@@ -177,6 +194,16 @@ auto CollectionRangeDeleter::cleanUpNextRange(OperationContext* opCtx,
                 wrote = e.toStatus();
                 warning() << e.what();
             }
+            if (wrote.isOK() && wrote.getValue() > 0) {
+                stdx::lock_guard<stdx::mutex> scopedLock(css->_metadataManager->_managerLock);
+                if (!self->_orphans.empty() &&
+                    self->_orphans.front().notification == notification) {
+                    auto& front = self->_orphans.front();
+                    front.numDeleted += wrote.getValue();
+                    LOG(1) << "Deleted " << front.numDeleted << " documents so far in " << nss.ns()
+                           << " range " << redact(range->toString());
+                }
+            }
             if (!wrote.isOK() || wrote.getValue() == 0) {
                 if (wrote.isOK()) {
                     log() << "No documents remain to delete in " << nss << " range "
@@ -203,11 +230,13 @@ auto CollectionRangeDeleter::cleanUpNextRange(OperationContext* opCtx,
     // Wait for replication outside the lock
     WriteConcernResult unusedWCResult;
     Status status = Status::OK();
+    Timer replicationTimer;
     try {
         status = waitForWriteConcern(opCtx, clientOpTime, kMajorityWriteConcern, &unusedWCResult);
     } catch (const DBException& e) {
         status = e.toStatus();
     }
+    const Milliseconds replicationWait(replicationTimer.millis());
     if (!status.isOK()) {
         log() << "Error when waiting for write concern after removing " << nss << " range "
               << redact(range->toString()) << " : " << redact(status.reason());
@@ -227,11 +256,20 @@ auto CollectionRangeDeleter::cleanUpNextRange(OperationContext* opCtx,
         }
     } else {
         log() << "Deleted " << wrote.getValue() << " documents in " << nss.ns() << " range "
-              << redact(range->toString());
+              << redact(range->toString()) << " in batch replicated after " << replicationWait;
     }
 
     notification.abandon();
-    return Date_t{};
+
+    // Throttle the next batch by at least the configured delay, or by as long as the last batch
+    // took to replicate if that was longer, so that orphan cleanup does not outrun the secondaries.
+    const auto minDelay = Milliseconds(std::max(rangeDeleterBatchDelayMS.load(), 0));
+    const auto maxDelay = std::max(Milliseconds(rangeDeleterMaxBatchDelayMS.load()), minDelay);
+    const auto delay = std::min(std::max(minDelay, replicationWait), maxDelay);
+    if (delay == Milliseconds(0)) {
+        return Date_t{};
+    }
+    return Date_t::now() + delay;
 }
 
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
@@ -280,39 +318,47 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
     }
 
     int numDeleted = 0;
-    do {
-        auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
-        auto manual = PlanExecutor::YIELD_MANUAL;
-        auto forward = InternalPlanner::FORWARD;
-        auto fetch = InternalPlanner::IXSCAN_FETCH;
-
-        auto exec = InternalPlanner::indexScan(
-            opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
-
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
-        }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning(LogComponent::kSharding)
-                << PlanExecutor::statestr(state) << " - cursor error while trying to delete " << min
-                << " to " << max << " in " << nss << ": " << WorkingSetCommon::toStatusString(obj)
-                << ", stats: " << Explain::getWinningPlanStats(exec.get());
-            break;
+    writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
+        // Collect the whole batch with a single scan of the shard key index before deleting
+        // anything, so that the scan is not invalidated by its own deletions, and then remove the
+        // batch in one storage transaction instead of one transaction per document.
+        std::vector<std::pair<RecordId, BSONObj>> batch;
+        {
+            auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
+            auto manual = PlanExecutor::YIELD_MANUAL;
+            auto forward = InternalPlanner::FORWARD;
+            auto fetch = InternalPlanner::IXSCAN_FETCH;
+
+            auto exec = InternalPlanner::indexScan(
+                opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
+
+            RecordId rloc;
+            BSONObj obj;
+            PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+            while (batch.size() < static_cast<size_t>(maxToDelete) &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &rloc))) {
+                batch.emplace_back(rloc, obj.getOwned());
+            }
+            if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                warning(LogComponent::kSharding)
+                    << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
+                    << min << " to " << max << " in " << nss << ": "
+                    << WorkingSetCommon::toStatusString(obj)
+                    << ", stats: " << Explain::getWinningPlanStats(exec.get());
+            }
         }
-        invariant(PlanExecutor::ADVANCED == state);
 
-        writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
-            WriteUnitOfWork wuow(opCtx);
+        WriteUnitOfWork wuow(opCtx);
+        for (const auto& doc : batch) {
             if (saver) {
-                saver->goingToDelete(obj).transitional_ignore();
+                saver->goingToDelete(doc.second).transitional_ignore();
             }
-            collection->deleteDocument(opCtx, kUninitializedStmtId, rloc, nullptr, true);
-            wuow.commit();
-        });
-    } while (++numDeleted < maxToDelete);
+            collection->deleteDocument(opCtx, kUninitializedStmtId, doc.first, nullptr, true);
+        }
+        wuow.commit();
+
+        numDeleted = batch.size();
+    });
 
     return numDeleted;
 }
@@ -372,6 +418,9 @@ void CollectionRangeDeleter::append(BSONObjBuilder* builder) const {
     for (auto const& entry : _orphans) {
         BSONObjBuilder obj;
         entry.range.append(&obj);
+        if (entry.numDeleted) {
+            obj.append("numDeleted", entry.numDeleted);
+        }
         arr.append(obj.done());
     }
     for (auto const& entry : _delayedOrphans) {
@@ -30,6 +30,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/time_support.h"
@@ -40,6 +41,9 @@ class BSONObj;
 class Collection;
 class OperationContext;
 
+// Number of documents to delete per batch of range deletion, see collection_range_deleter.cpp.
+extern AtomicInt32 rangeDeleterBatchSize;
+
 class CollectionRangeDeleter {
     MONGO_DISALLOW_COPYING(CollectionRangeDeleter);
 
@@ -102,6 +106,7 @@ public:
         ChunkRange range;
         Date_t whenToDelete;  // A value of Date_t{} means immediately.
         DeleteNotification notification{};
+        long long numDeleted{0};  // Documents deleted so far, reported by append().
     };
 
     CollectionRangeDeleter() = default;
@@ -154,7 +159,9 @@ public:
      * it must be called without locks.
      *
      * If it should be scheduled to run again because there might be more documents to delete,
-     * returns the time to begin, or boost::none otherwise.
+     * returns the time to begin, or boost::none otherwise. After a batch of deletions, the time to
+     * begin is delayed by rangeDeleterBatchDelayMS, or by how long the batch took to replicate to
+     * a majority if that was longer, up to rangeDeleterMaxBatchDelayMS.
      *
      * Argument 'forTestOnly' is used in unit tests that exercise the CollectionRangeDeleter class,
      * so that they do not need to set up CollectionShardingState and MetadataManager objects.
@@ -168,8 +175,8 @@ public:
 
 private:
     /**
-     * Performs the deletion of up to maxToDelete entries within the range in progress. Must be
-     * called under the collection lock.
+     * Performs the deletion of up to maxToDelete entries within the range in progress, as a single
+     * write unit of work. Must be called under the collection lock.
      *
      * Returns the number of documents deleted, 0 if done with the range, or bad status if deleting
      * the range failed.
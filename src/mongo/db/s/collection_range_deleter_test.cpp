@@ -43,6 +43,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context_d_test_fixture.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/chunk_version.h"
@@ -79,6 +80,17 @@ protected:
         return _epoch;
     }
 
+    ServerParameter* getServerParameter(const std::string& name) {
+        const auto& parameters = ServerParameterSet::getGlobal()->getMap();
+        auto it = parameters.find(name);
+        invariant(it != parameters.end());
+        return it->second;
+    }
+
+    void setServerParameter(const std::string& name, const std::string& value) {
+        ASSERT_OK(getServerParameter(name)->setFromString(value));
+    }
+
     virtual std::unique_ptr<BalancerConfiguration> makeBalancerConfiguration() override {
         return stdx::make_unique<BalancerConfiguration>();
     }
@@ -88,6 +100,9 @@ private:
     void tearDown() override;
 
     OID _epoch;
+
+    // Values of the server parameters changed by the tests, restored on teardown.
+    std::vector<BSONObj> _savedServerParameters;
 };
 
 void CollectionRangeDeleterTest::setUp() {
@@ -103,6 +118,16 @@ void CollectionRangeDeleterTest::setUp() {
 
     configTargeter()->setFindHostReturnValue(dummyHost);
 
+    for (auto name : {"rangeDeleterBatchDelayMS", "rangeDeleterMaxBatchDelayMS"}) {
+        BSONObjBuilder builder;
+        getServerParameter(name)->append(operationContext(), builder, name);
+        _savedServerParameters.push_back(builder.obj());
+    }
+
+    // Run the batches back to back unless a test asks for throttling
+    setServerParameter("rangeDeleterBatchDelayMS", "0");
+    setServerParameter("rangeDeleterMaxBatchDelayMS", "0");
+
     DBDirectClient(operationContext()).createCollection(kNss.ns());
     {
         AutoGetCollection autoColl(operationContext(), kNss, MODE_IX);
@@ -129,6 +154,9 @@ void CollectionRangeDeleterTest::tearDown() {
         auto collectionShardingState = CollectionShardingState::get(operationContext(), kNss);
         collectionShardingState->refreshMetadata(operationContext(), nullptr);
     }
+    for (const auto& saved : _savedServerParameters) {
+        ASSERT_OK(getServerParameter(saved.firstElementFieldName())->set(saved.firstElement()));
+    }
     ShardingMongodTestFixture::tearDown();
 }
 
@@ -194,6 +222,44 @@ TEST_F(CollectionRangeDeleterTest, OneDocumentInOneRangeToClean) {
     ASSERT_EQUALS(0ULL, dbclient.count(kAdminSysVer.ns(), BSON(kPattern << "startRangeDeletion")));
 }
 
+// Tests that batches are spaced by the configured delay and that the progress of the range in
+// process of deletion is reported.
+TEST_F(CollectionRangeDeleterTest, BatchesAreThrottledAndReportProgress) {
+    setServerParameter("rangeDeleterBatchDelayMS", "50");
+    setServerParameter("rangeDeleterMaxBatchDelayMS", "1000");
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kPattern << 1));
+    dbclient.insert(kNss.toString(), BSON(kPattern << 2));
+    dbclient.insert(kNss.toString(), BSON(kPattern << 3));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(Deletion{ChunkRange(BSON(kPattern << 0), BSON(kPattern << 10)), Date_t{}});
+    rangeDeleter.add(std::move(ranges));
+
+    const auto before = Date_t::now();
+    auto when = next(rangeDeleter, 2);
+    ASSERT_TRUE(when);
+    ASSERT_GTE(*when, before + Milliseconds(50));
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSON(kPattern << LT << 5)));
+
+    BSONObjBuilder builder;
+    rangeDeleter.append(&builder);
+    auto rangesToClean = builder.obj()["rangesToClean"].Array();
+    ASSERT_EQUALS(1U, rangesToClean.size());
+    ASSERT_EQUALS(2, rangesToClean[0].Obj()["numDeleted"].numberLong());
+
+    ASSERT_TRUE(next(rangeDeleter, 2));
+    ASSERT_EQUALS(0ULL, dbclient.count(kNss.toString(), BSON(kPattern << LT << 5)));
+
+    // Finding the range empty pops it without waiting for replication
+    when = next(rangeDeleter, 2);
+    ASSERT_TRUE(when);
+    ASSERT_EQUALS(*when, Date_t{});
+    ASSERT_FALSE(next(rangeDeleter, 2));
+}
+
 // Tests the case that there are multiple documents within a range to clean.
 TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInOneRangeToClean) {
     CollectionRangeDeleter rangeDeleter;
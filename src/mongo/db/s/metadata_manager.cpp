@@ -400,7 +400,10 @@ void scheduleCleanup(executor::TaskExecutor* executor,
     std::ignore = executor->scheduleWorkAt(
         when, [ executor, nss = std::move(nss), epoch = std::move(epoch) ](auto&) {
             MONGO_FAIL_POINT_PAUSE_WHILE_SET(suspendRangeDeletion);
-            const int maxToDelete = std::max(int(internalQueryExecYieldIterations.load()), 1);
+            const int maxToDelete = std::max(rangeDeleterBatchSize.load() > 0
+                                                 ? rangeDeleterBatchSize.load()
+                                                 : int(internalQueryExecYieldIterations.load()),
+                                             1);
             Client::initThreadIfNotAlready("Collection Range Deleter");
             auto UniqueOpCtx = Client::getCurrent()->makeOperationContext();
             auto opCtx = UniqueOpCtx.get();
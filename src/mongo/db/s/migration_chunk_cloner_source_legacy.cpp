@@ -38,7 +38,6 @@
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
-#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/query/internal_plans.h"
@@ -85,45 +84,6 @@ BSONObj createRequestWithSessionId(StringData commandName,
 
 }  // namespace
 
-/**
- * Used to receive invalidation notifications from operations, which delete documents.
- */
-class DeleteNotificationStage final : public PlanStage {
-public:
-    DeleteNotificationStage(MigrationChunkClonerSourceLegacy* cloner, OperationContext* opCtx)
-        : PlanStage("SHARDING_NOTIFY_DELETE", opCtx), _cloner(cloner) {}
-
-    void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) override {
-        if (type == INVALIDATION_DELETION) {
-            stdx::lock_guard<stdx::mutex> sl(_cloner->_mutex);
-            _cloner->_cloneLocs.erase(dl);
-        }
-    }
-
-    StageState doWork(WorkingSetID* out) override {
-        MONGO_UNREACHABLE;
-    }
-
-    bool isEOF() override {
-        MONGO_UNREACHABLE;
-    }
-
-    std::unique_ptr<PlanStageStats> getStats() override {
-        MONGO_UNREACHABLE;
-    }
-
-    SpecificStats* getSpecificStats() const override {
-        MONGO_UNREACHABLE;
-    }
-
-    StageType stageType() const override {
-        return STAGE_NOTIFY_DELETE;
-    }
-
-private:
-    MigrationChunkClonerSourceLegacy* const _cloner;
-};
-
 /**
  * Used to commit work for LogOpForSharding. Used to keep track of changes in documents that are
  * part of a chunk being migrated.
@@ -179,17 +139,17 @@ MigrationChunkClonerSourceLegacy::MigrationChunkClonerSourceLegacy(MoveChunkRequ
 
 MigrationChunkClonerSourceLegacy::~MigrationChunkClonerSourceLegacy() {
     invariant(_state == kDone);
-    invariant(!_deleteNotifyExec);
+    invariant(!_cloneExec);
 }
 
 Status MigrationChunkClonerSourceLegacy::startClone(OperationContext* opCtx) {
     invariant(_state == kNew);
     invariant(!opCtx->lockState()->isLocked());
 
-    // Load the ids of the currently available documents
-    auto storeCurrentLocsStatus = _storeCurrentLocs(opCtx);
-    if (!storeCurrentLocsStatus.isOK()) {
-        return storeCurrentLocsStatus;
+    // Check the size of the chunk and position the scan which will return its documents
+    auto prepareCloneScanStatus = _prepareCloneScan(opCtx);
+    if (!prepareCloneScanStatus.isOK()) {
+        return prepareCloneScanStatus;
     }
 
     // Tell the recipient shard to start cloning
@@ -249,18 +209,19 @@ Status MigrationChunkClonerSourceLegacy::awaitUntilCriticalSectionIsAppropriate(
 
         stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-        const std::size_t cloneLocsRemaining = _cloneLocs.size();
-
         log() << "moveChunk data transfer progress: " << redact(res) << " mem used: " << _memoryUsed
-              << " documents remaining to clone: " << cloneLocsRemaining;
+              << " documents cloned: " << _numRecordsCloned << " of about "
+              << _numRecordsToClone;
 
         if (res["state"].String() == "steady") {
-            if (cloneLocsRemaining != 0) {
+            if (_cloneExec) {
                 return {ErrorCodes::OperationIncomplete,
                         str::stream() << "Unable to enter critical section because the recipient "
-                                         "shard thinks all data is cloned while there are still "
-                                      << cloneLocsRemaining
-                                      << " documents remaining"};
+                                         "shard thinks all data is cloned while only "
+                                      << _numRecordsCloned
+                                      << " documents out of about "
+                                      << _numRecordsToClone
+                                      << " have been cloned"};
             }
 
             return Status::OK();
@@ -396,8 +357,11 @@ void MigrationChunkClonerSourceLegacy::onDeleteOp(OperationContext* opCtx,
 uint64_t MigrationChunkClonerSourceLegacy::getCloneBatchBufferAllocationSize() {
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
+    const uint64_t numRecordsRemaining = _numRecordsToClone > _numRecordsCloned
+        ? _numRecordsToClone - _numRecordsCloned
+        : (_cloneExec ? 1 : 0);
     return std::min(static_cast<uint64_t>(BSONObjMaxUserSize),
-                    _averageObjectSizeForCloneLocs * _cloneLocs.size());
+                    _averageObjectSizeForCloneLocs * numRecordsRemaining);
 }
 
 Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
@@ -411,39 +375,65 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
 
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-    std::set<RecordId>::iterator it;
+    // An empty batch tells the recipient that there is no more initial clone data
+    if (!_cloneExec) {
+        return Status::OK();
+    }
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
+    _cloneExec->reattachToOperationContext(opCtx);
+    Status restoreStatus = _cloneExec->restoreState();
+    if (!restoreStatus.isOK()) {
+        _cloneExec->dispose(opCtx, collection->getCursorManager());
+        _cloneExec.reset();
+        return restoreStatus;
+    }
+
+    BSONObj obj;
+    PlanExecutor::ExecState state;
+    while (true) {
         // We must always make progress in this method by at least one document because empty return
         // indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(opCtx, *it, &doc)) {
-            // Use the builder size instead of accumulating the document sizes directly so that we
-            // take into consideration the overhead of BSONArray indices.
-            if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
-                break;
-            }
+        state = _cloneExec->getNext(&obj, nullptr);
+        if (state != PlanExecutor::ADVANCED) {
+            break;
+        }
 
-            arrBuilder->append(doc.value());
+        // Use the builder size instead of accumulating the document sizes directly so that we
+        // take into consideration the overhead of BSONArray indices.
+        if (arrBuilder->arrSize() &&
+            (arrBuilder->len() + obj.objsize() + 1024) > BSONObjMaxUserSize) {
+            // Return the document with the next batch.
+            _cloneExec->enqueue(obj.getOwned());
+            break;
         }
+
+        arrBuilder->append(obj);
+        _numRecordsCloned++;
     }
 
-    _cloneLocs.erase(_cloneLocs.begin(), it);
+    if (state == PlanExecutor::DEAD || state == PlanExecutor::FAILURE) {
+        _cloneExec->dispose(opCtx, collection->getCursorManager());
+        _cloneExec.reset();
+        return {ErrorCodes::InternalError,
+                str::stream() << "Executor error while scanning for documents belonging to chunk: "
+                              << WorkingSetCommon::toStatusString(obj)};
+    }
 
-    // If we have drained all the cloned data, there is no need to keep the delete notify executor
-    // around
-    if (_cloneLocs.empty() && _deleteNotifyExec) {
+    if (state == PlanExecutor::IS_EOF) {
         // We have a different OperationContext than when we created the PlanExecutor, so need to
         // manually destroy it ourselves.
-        _deleteNotifyExec->dispose(opCtx, collection->getCursorManager());
-        _deleteNotifyExec.reset();
+        _cloneExec->dispose(opCtx, collection->getCursorManager());
+        _cloneExec.reset();
+        return Status::OK();
     }
 
+    _cloneExec->saveState();
+    _cloneExec->detachFromOperationContext();
+
     return Status::OK();
 }
 
@@ -455,7 +445,7 @@ Status MigrationChunkClonerSourceLegacy::nextModsBatch(OperationContext* opCtx,
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
     // All clone data must have been drained before starting to fetch the incremental changes
-    invariant(_cloneLocs.empty());
+    invariant(!_cloneExec);
 
     long long docSizeAccumulator = 0;
 
@@ -475,12 +465,13 @@ void MigrationChunkClonerSourceLegacy::_cleanup(OperationContext* opCtx) {
         _deleted.clear();
     }
 
-    if (_deleteNotifyExec) {
-        AutoGetCollection autoColl(opCtx, _args.getNss(), MODE_IS);
+    AutoGetCollection autoColl(opCtx, _args.getNss(), MODE_IS);
+    stdx::lock_guard<stdx::mutex> sl(_mutex);
+    if (_cloneExec) {
         const auto cursorManager =
             autoColl.getCollection() ? autoColl.getCollection()->getCursorManager() : nullptr;
-        _deleteNotifyExec->dispose(opCtx, cursorManager);
-        _deleteNotifyExec.reset();
+        _cloneExec->dispose(opCtx, cursorManager);
+        _cloneExec.reset();
     }
 }
 
@@ -514,7 +505,7 @@ StatusWith<BSONObj> MigrationChunkClonerSourceLegacy::_callRecipient(const BSONO
     return responseStatus.data.getOwned();
 }
 
-Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opCtx) {
+Status MigrationChunkClonerSourceLegacy::_prepareCloneScan(OperationContext* opCtx) {
     AutoGetCollection autoColl(opCtx, _args.getNss(), MODE_IS);
 
     Collection* const collection = autoColl.getCollection();
@@ -532,23 +523,10 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
     if (!idx) {
         return {ErrorCodes::IndexNotFound,
                 str::stream() << "can't find index with prefix " << _shardKeyPattern.toBSON()
-                              << " in storeCurrentLocs for "
+                              << " in prepareCloneScan for "
                               << _args.getNss().ns()};
     }
 
-    // Install the stage, which will listen for notifications on the collection
-    auto statusWithDeleteNotificationPlanExecutor =
-        PlanExecutor::make(opCtx,
-                           stdx::make_unique<WorkingSet>(),
-                           stdx::make_unique<DeleteNotificationStage>(this, opCtx),
-                           collection,
-                           PlanExecutor::YIELD_MANUAL);
-    if (!statusWithDeleteNotificationPlanExecutor.isOK()) {
-        return statusWithDeleteNotificationPlanExecutor.getStatus();
-    }
-
-    _deleteNotifyExec = std::move(statusWithDeleteNotificationPlanExecutor.getValue());
-
     // Assume both min and max non-empty, append MinKey's to make them fit chosen index
     const KeyPattern kp(idx->keyPattern());
 
@@ -596,11 +574,6 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
             return interruptStatus;
         }
 
-        if (!isLargeChunk) {
-            stdx::lock_guard<stdx::mutex> lk(_mutex);
-            _cloneLocs.insert(recordId);
-        }
-
         if (++recCount > maxRecsWhenFull) {
             isLargeChunk = true;
             // Continue on despite knowing that it will fail, just to get the correct value for
@@ -636,7 +609,29 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* opC
                           << _args.getMaxKey()};
     }
 
+    // The scan which returns the documents to clone is registered with the collection's cursor
+    // manager, so that it is notified of deletions and stays valid while it is saved between
+    // batches. Documents modified after they were returned are transferred again as mods.
+    //
+    // Unlike a snapshot of record ids, the scan also returns documents inserted into the chunk
+    // after it started, which are then sent both in a clone batch and as a mod. This is harmless:
+    // the recipient upserts cloned documents by _id and only fetches mods once the clone is
+    // complete, so the mod upserts (or deletes) the latest version of a document it already has.
+    auto cloneExec = InternalPlanner::indexScan(opCtx,
+                                                collection,
+                                                idx,
+                                                min,
+                                                max,
+                                                BoundInclusion::kIncludeStartKeyOnly,
+                                                PlanExecutor::YIELD_MANUAL,
+                                                InternalPlanner::FORWARD,
+                                                InternalPlanner::IXSCAN_FETCH);
+    cloneExec->saveState();
+    cloneExec->detachFromOperationContext();
+
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _cloneExec = std::move(cloneExec);
+    _numRecordsToClone = recCount;
     _averageObjectSizeForCloneLocs = collectionAverageObjectSize + 12;
 
     return Status::OK();
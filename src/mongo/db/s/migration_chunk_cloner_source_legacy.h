@@ -29,7 +29,6 @@
 #pragma once
 
 #include <list>
-#include <set>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/connection_string.h"
@@ -49,7 +48,6 @@ class BSONArrayBuilder;
 class BSONObjBuilder;
 class Collection;
 class Database;
-class RecordId;
 
 class MigrationChunkClonerSourceLegacy final : public MigrationChunkClonerSource {
     MONGO_DISALLOW_COPYING(MigrationChunkClonerSourceLegacy);
@@ -122,7 +120,6 @@ public:
     Status nextModsBatch(OperationContext* opCtx, Database* db, BSONObjBuilder* builder);
 
 private:
-    friend class DeleteNotificationStage;
     friend class LogOpForShardingHandler;
 
     // Represents the states in which the cloner can be
@@ -141,12 +138,14 @@ private:
     StatusWith<BSONObj> _callRecipient(const BSONObj& cmdObj);
 
     /**
-     * Get the disklocs that belong to the chunk migrated and sort them in _cloneLocs (to avoid
-     * seeking disk later).
+     * Counts the documents that belong to the chunk being migrated, failing with ChunkTooBig if
+     * there are too many of them, and positions _cloneExec at the start of the chunk. The initial
+     * clone streams documents from _cloneExec instead of collecting their record ids up front, so
+     * memory use does not grow with the chunk size.
      *
      * Returns OK or any error status otherwise.
      */
-    Status _storeCurrentLocs(OperationContext* opCtx);
+    Status _prepareCloneScan(OperationContext* opCtx);
 
     /**
      * Insert items from docIdList to a new array with the given fieldName in the given builder. If
@@ -179,18 +178,21 @@ private:
     // The resolved primary of the recipient shard
     const HostAndPort _recipientHost;
 
-    // Registered deletion notifications plan executor, which will listen for document deletions
-    // during the cloning stage
-    std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> _deleteNotifyExec;
-
     // Protects the entries below
     stdx::mutex _mutex;
 
     // The current state of the cloner
     State _state{kNew};
 
-    // List of record ids that needs to be transferred (initial clone)
-    std::set<RecordId> _cloneLocs;
+    // Registered index scan over the chunk being migrated, which returns the documents to transfer
+    // during the initial clone. It is kept saved and detached from any operation context between
+    // calls to nextCloneBatch and is reset once it has been exhausted.
+    std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> _cloneExec;
+
+    // Number of documents found in the chunk when the clone started and number of documents
+    // transferred so far (initial clone)
+    uint64_t _numRecordsToClone{0};
+    uint64_t _numRecordsCloned{0};
 
     // The estimated average object size during the clone phase. Used for buffer size
     // pre-allocation (initial clone).
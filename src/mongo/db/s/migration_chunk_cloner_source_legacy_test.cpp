@@ -132,7 +132,8 @@ protected:
      * Shortcut to create BSON represenation of a moveChunk request for the specified range with
      * fixed kDonorConnStr and kRecipientConnStr, respectively.
      */
-    static MoveChunkRequest createMoveChunkRequest(const ChunkRange& chunkRange) {
+    static MoveChunkRequest createMoveChunkRequest(const ChunkRange& chunkRange,
+                                                   long long maxChunkSizeBytes = 1024 * 1024) {
         BSONObjBuilder cmdBuilder;
         MoveChunkRequest::appendAsCommand(
             &cmdBuilder,
@@ -142,7 +143,7 @@ protected:
             kDonorConnStr.getSetName(),
             kRecipientConnStr.getSetName(),
             chunkRange,
-            1024 * 1024,
+            maxChunkSizeBytes,
             MigrationSecondaryThrottleOptions::create(MigrationSecondaryThrottleOptions::kDefault),
             false);
 
@@ -156,6 +157,55 @@ protected:
         return BSON("_id" << value << "X" << value);
     }
 
+    /**
+     * Same as createCollectionDocument, but padded so that no more than two such documents fit
+     * in a single clone batch.
+     */
+    static BSONObj createLargeCollectionDocument(int value) {
+        return BSON("_id" << value << "X" << value << "pad" << std::string(6 * 1024 * 1024, 'x'));
+    }
+
+    /**
+     * Starts cloning 'chunkRange' with 'cloner', acknowledging the request sent to the recipient.
+     */
+    void startClone(MigrationChunkClonerSourceLegacy* cloner) {
+        auto futureStartClone = launchAsync([&]() {
+            onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+        });
+
+        ASSERT_OK(cloner->startClone(operationContext()));
+        futureStartClone.timed_get(kFutureTimeout);
+    }
+
+    /**
+     * Cancels the clone, acknowledging the abort request sent to the recipient.
+     */
+    void cancelClone(MigrationChunkClonerSourceLegacy* cloner) {
+        auto futureCancel = launchAsync([&]() {
+            onCommand([&](const RemoteCommandRequest& request) { return BSON("ok" << true); });
+        });
+
+        cloner->cancelClone(operationContext());
+        futureCancel.timed_get(kFutureTimeout);
+    }
+
+    /**
+     * Fetches the next initial clone batch from 'cloner' and returns the shard key values of the
+     * documents in it.
+     */
+    std::vector<int> nextCloneBatchKeys(MigrationChunkClonerSourceLegacy* cloner) {
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_IS);
+        BSONArrayBuilder arrBuilder;
+        ASSERT_OK(
+            cloner->nextCloneBatch(operationContext(), autoColl.getCollection(), &arrBuilder));
+
+        std::vector<int> keys;
+        for (const auto& doc : arrBuilder.arr()) {
+            keys.push_back(doc.Obj()["X"].numberInt());
+        }
+        return keys;
+    }
+
 private:
     std::unique_ptr<ShardingCatalogClient> makeShardingCatalogClient(
         std::unique_ptr<DistLockManager> distLockManager) override {
@@ -369,5 +419,104 @@ TEST_F(MigrationChunkClonerSourceLegacyTest, FailedToEngageRecipientShard) {
     cloner.cancelClone(operationContext());
 }
 
+TEST_F(MigrationChunkClonerSourceLegacyTest, CloneScanResumesAcrossBatches) {
+    std::vector<BSONObj> contents;
+    for (int i = 100; i < 105; i++) {
+        contents.push_back(createLargeCollectionDocument(i));
+    }
+
+    createShardedCollection({});
+    for (const auto& doc : contents) {
+        client()->insert(kNss.ns(), doc);
+    }
+
+    MigrationChunkClonerSourceLegacy cloner(
+        createMoveChunkRequest(ChunkRange(BSON("X" << 100), BSON("X" << 200)), 64 * 1024 * 1024),
+        kShardKeyPattern,
+        kDonorConnStr,
+        kRecipientConnStr.getServers()[0]);
+    startClone(&cloner);
+
+    // The documents do not fit in a single batch. The one which did not fit in a batch must be
+    // returned at the start of the next one, so every document is returned once and in order.
+    std::vector<int> clonedKeys;
+    int numBatches = 0;
+    while (true) {
+        auto batchKeys = nextCloneBatchKeys(&cloner);
+        if (batchKeys.empty()) {
+            break;
+        }
+        ASSERT_LTE(batchKeys.size(), 2U);
+        clonedKeys.insert(clonedKeys.end(), batchKeys.begin(), batchKeys.end());
+        numBatches++;
+    }
+
+    ASSERT_GTE(numBatches, 3);
+    ASSERT(clonedKeys == std::vector<int>({100, 101, 102, 103, 104}));
+
+    cancelClone(&cloner);
+}
+
+TEST_F(MigrationChunkClonerSourceLegacyTest, CloneScanSeesChangesAheadOfIt) {
+    std::vector<BSONObj> contents;
+    for (int i = 100; i < 105; i++) {
+        contents.push_back(createLargeCollectionDocument(i));
+    }
+
+    createShardedCollection({});
+    for (const auto& doc : contents) {
+        client()->insert(kNss.ns(), doc);
+    }
+
+    MigrationChunkClonerSourceLegacy cloner(
+        createMoveChunkRequest(ChunkRange(BSON("X" << 100), BSON("X" << 200)), 64 * 1024 * 1024),
+        kShardKeyPattern,
+        kDonorConnStr,
+        kRecipientConnStr.getServers()[0]);
+    startClone(&cloner);
+
+    // At most two documents fit in the first batch.
+    auto clonedKeys = nextCloneBatchKeys(&cloner);
+    ASSERT_FALSE(clonedKeys.empty());
+    ASSERT_LTE(clonedKeys.size(), 2U);
+
+    // Change the part of the chunk which the scan has not reached yet, while it is saved between
+    // batches.
+    client()->remove(kNss.ns(), BSON("_id" << 104));
+    client()->insert(kNss.ns(), createCollectionDocument(150));
+    {
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_IX);
+        WriteUnitOfWork wuow(operationContext());
+        cloner.onDeleteOp(operationContext(), BSON("_id" << 104));
+        cloner.onInsertOp(operationContext(), createCollectionDocument(150));
+        wuow.commit();
+    }
+
+    while (true) {
+        auto batchKeys = nextCloneBatchKeys(&cloner);
+        if (batchKeys.empty()) {
+            break;
+        }
+        clonedKeys.insert(clonedKeys.end(), batchKeys.begin(), batchKeys.end());
+    }
+
+    // The deleted document is not cloned, and the inserted one is cloned as well as sent as a mod,
+    // which the recipient applies as an upsert of the same document.
+    ASSERT(clonedKeys == std::vector<int>({100, 101, 102, 103, 150}));
+    {
+        AutoGetCollection autoColl(operationContext(), kNss, MODE_IS);
+        BSONObjBuilder modsBuilder;
+        ASSERT_OK(cloner.nextModsBatch(operationContext(), autoColl.getDb(), &modsBuilder));
+
+        const auto modsObj = modsBuilder.obj();
+        ASSERT_EQ(1U, modsObj["reload"].Array().size());
+        ASSERT_BSONOBJ_EQ(createCollectionDocument(150), modsObj["reload"].Array()[0].Obj());
+        ASSERT_EQ(1U, modsObj["deleted"].Array().size());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 104), modsObj["deleted"].Array()[0].Obj());
+    }
+
+    cancelClone(&cloner);
+}
+
 }  // namespace
 }  // namespace mongo
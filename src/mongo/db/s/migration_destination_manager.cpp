@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/migration_destination_manager.h"
 
+#include <algorithm>
+#include <deque>
 #include <list>
 #include <vector>
 
@@ -55,6 +57,7 @@
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/shard_key_pattern.h"
@@ -63,6 +66,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -71,6 +75,10 @@ using str::stream;
 
 namespace {
 
+// Number of threads which insert the documents fetched during the initial clone of a chunk, while
+// the migration thread fetches the next batches from the donor.
+MONGO_EXPORT_SERVER_PARAMETER(migrationCloneInserterThreads, int, 4);
+
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 // Note: Even though we're setting UNSET here,
                                                 // kMajority implies JOURNAL if journaling is
@@ -197,6 +205,111 @@ BSONObj createTransferModsRequest(const NamespaceString& nss, const MigrationSes
     return builder.obj();
 }
 
+/**
+ * Bounded queue of "_migrateClone" responses, which the migration thread fills while the clone
+ * inserter threads drain it.
+ */
+class CloneBatchQueue {
+    MONGO_DISALLOW_COPYING(CloneBatchQueue);
+
+public:
+    CloneBatchQueue(std::size_t maxBatches, int numConsumers)
+        : _maxBatches(maxBatches), _numConsumers(numConsumers) {}
+
+    /**
+     * Blocks while the queue is full. Returns false if the queue was closed, in which case the
+     * batch is dropped. Throws if 'opCtx' is interrupted while waiting.
+     */
+    bool push(OperationContext* opCtx, BSONObj batch) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        opCtx->waitForConditionOrInterrupt(
+            _condVar, lk, [&] { return _closed || _batches.size() < _maxBatches; });
+        if (_closed) {
+            return false;
+        }
+
+        _batches.push_back(std::move(batch));
+        _condVar.notify_all();
+        return true;
+    }
+
+    /**
+     * Blocks until a batch is available. Returns boost::none once the queue was closed, or once
+     * all batches have been popped after markDone() was called.
+     */
+    boost::optional<BSONObj> pop() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _condVar.wait(lk, [&] { return _closed || _done || !_batches.empty(); });
+        if (_closed || _batches.empty()) {
+            return boost::none;
+        }
+
+        BSONObj batch = std::move(_batches.front());
+        _batches.pop_front();
+        _condVar.notify_all();
+        return batch;
+    }
+
+    /**
+     * Signals that no more batches will be pushed.
+     */
+    void markDone() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _done = true;
+        _condVar.notify_all();
+    }
+
+    /**
+     * Discards all queued batches and wakes up all producers and consumers. If 'status' is an
+     * error and no error was reported before, it is remembered and returned by getStatus().
+     */
+    void close(Status status = Status::OK()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_status.isOK()) {
+            _status = std::move(status);
+        }
+        _closed = true;
+        _batches.clear();
+        _condVar.notify_all();
+    }
+
+    Status getStatus() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _status;
+    }
+
+    /**
+     * Called by each consumer once it stops popping batches.
+     */
+    void consumerDone() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        invariant(_numConsumers > 0);
+        _numConsumers--;
+        _condVar.notify_all();
+    }
+
+    /**
+     * Blocks until every consumer has called consumerDone(). Throws if 'opCtx' is interrupted
+     * while waiting.
+     */
+    void waitForConsumers(OperationContext* opCtx) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        opCtx->waitForConditionOrInterrupt(_condVar, lk, [&] { return _numConsumers == 0; });
+    }
+
+private:
+    const std::size_t _maxBatches;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _condVar;
+
+    std::deque<BSONObj> _batches;
+    int _numConsumers;
+    bool _done{false};
+    bool _closed{false};
+    Status _status{Status::OK()};
+};
+
 // Enabling / disabling these fail points pauses / resumes MigrateStatus::_go(), the thread which
 // receives a chunk migration from the donor.
 MONGO_FP_DECLARE(migrateThreadHangAtStep1);
@@ -676,7 +789,85 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
 
         _chunkMarkedPending = true;  // no lock needed, only the migrate thread looks.
 
+        // The next batch is fetched from the donor while the inserter threads apply the previous
+        // ones.
+        const int numInserterThreads = std::max(1, migrationCloneInserterThreads.load());
+        CloneBatchQueue cloneBatches(2 * numInserterThreads, numInserterThreads);
+        std::vector<stdx::thread> inserterThreads;
+
+        // The inserter threads run under their own operation contexts. They are registered here
+        // so that they get interrupted when this thread stops cloning early, for example because
+        // the migration was killed, instead of blocking it on a replication wait.
+        stdx::mutex inserterOpCtxsMutex;
+        std::vector<OperationContext*> inserterOpCtxs;
+
+        ON_BLOCK_EXIT([&] {
+            cloneBatches.close();
+            {
+                stdx::lock_guard<stdx::mutex> lk(inserterOpCtxsMutex);
+                for (auto inserterOpCtx : inserterOpCtxs) {
+                    stdx::lock_guard<Client> clientLock(*inserterOpCtx->getClient());
+                    inserterOpCtx->getServiceContext()->killOperation(inserterOpCtx,
+                                                                      ErrorCodes::Interrupted);
+                }
+            }
+            for (auto& inserterThread : inserterThreads) {
+                if (inserterThread.joinable()) {
+                    inserterThread.join();
+                }
+            }
+        });
+
+        for (int i = 0; i < numInserterThreads; i++) {
+            inserterThreads.emplace_back([&, i] {
+                Client::initThread(str::stream() << "migrateCloneInserter-" << i);
+                auto insertOpCtx = getGlobalServiceContext()->makeOperationContext(&cc());
+                if (getGlobalAuthorizationManager()->isAuthEnabled()) {
+                    AuthorizationSession::get(insertOpCtx->getClient())
+                        ->grantInternalAuthorization();
+                }
+
+                {
+                    stdx::lock_guard<stdx::mutex> lk(inserterOpCtxsMutex);
+                    inserterOpCtxs.push_back(insertOpCtx.get());
+                }
+                ON_BLOCK_EXIT([&] {
+                    {
+                        stdx::lock_guard<stdx::mutex> lk(inserterOpCtxsMutex);
+                        inserterOpCtxs.erase(std::find(
+                            inserterOpCtxs.begin(), inserterOpCtxs.end(), insertOpCtx.get()));
+                    }
+                    cloneBatches.consumerDone();
+                });
+
+                try {
+                    while (auto batch = cloneBatches.pop()) {
+                        if (!_insertCloneBatch(insertOpCtx.get(),
+                                               (*batch)["objects"].Obj(),
+                                               min,
+                                               max,
+                                               shardKeyPattern,
+                                               writeConcern)) {
+                            cloneBatches.close();
+                            return;
+                        }
+                    }
+                } catch (const DBException& ex) {
+                    cloneBatches.close(ex.toStatus());
+                } catch (const std::exception& ex) {
+                    cloneBatches.close({ErrorCodes::UnknownError, ex.what()});
+                }
+            });
+        }
+
         while (true) {
+            opCtx->checkForInterrupt();
+
+            if (getState() == ABORT) {
+                log() << "Migration aborted while copying documents";
+                return;
+            }
+
             BSONObj res;
             if (!conn->runCommand("admin",
                                   migrateCloneRequest,
@@ -686,71 +877,40 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
                 return;
             }
 
-            BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
-
-            BSONObjIterator i(arr);
-            while (i.more()) {
-                opCtx->checkForInterrupt();
-
-                if (getState() == ABORT) {
-                    log() << "Migration aborted while copying documents";
-                    return;
-                }
-
-                BSONObj docToClone = i.next().Obj();
-                {
-                    OldClientWriteContext cx(opCtx, _nss.ns());
-
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(opCtx,
-                                            _nss,
-                                            min,
-                                            max,
-                                            shardKeyPattern,
-                                            cx.db(),
-                                            docToClone,
-                                            &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << redact(localDoc)
-                                                      << " has same _id as cloned "
-                                                      << "remote document " << redact(docToClone);
-
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
-                    }
+            if (res["objects"].Obj().isEmpty()) {
+                break;
+            }
 
-                    Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
-                }
-                thisTime++;
+            if (!cloneBatches.push(opCtx, std::move(res))) {
+                // An inserter thread failed or saw the migration being aborted.
+                break;
+            }
+        }
 
-                {
-                    stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
-                }
+        // Wait for the inserter threads to drain the queue without making this thread
+        // uninterruptible, then reap them.
+        cloneBatches.markDone();
+        cloneBatches.waitForConsumers(opCtx);
+        for (auto& inserterThread : inserterThreads) {
+            inserterThread.join();
+        }
 
-                if (writeConcern.shouldWaitForOtherNodes()) {
-                    repl::ReplicationCoordinator::StatusAndDuration replStatus =
-                        repl::getGlobalReplicationCoordinator()->awaitReplication(
-                            opCtx,
-                            repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
-                            writeConcern);
-                    if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
-                        warning() << "secondaryThrottle on, but doc insert timed out; "
-                                     "continuing";
-                    } else {
-                        massertStatusOK(replStatus.status);
-                    }
-                }
-            }
+        const Status insertStatus = cloneBatches.getStatus();
+        if (!insertStatus.isOK()) {
+            setStateFail(str::stream() << "migrate failed while inserting cloned documents: "
+                                       << redact(insertStatus));
+            return;
+        }
 
-            if (thisTime == 0)
-                break;
+        if (getState() == ABORT) {
+            log() << "Migration aborted while copying documents";
+            return;
         }
 
+        // The cloned documents were written by the inserter threads, so make sure the replication
+        // waits below cover them.
+        repl::ReplClientInfo::forClient(opCtx->getClient()).setLastOpToSystemLastOpTime(opCtx);
+
         timing.done(3);
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
     }
@@ -903,6 +1063,72 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
     conn.done();
 }
 
+bool MigrationDestinationManager::_insertCloneBatch(OperationContext* opCtx,
+                                                    const BSONObj& docsToClone,
+                                                    const BSONObj& min,
+                                                    const BSONObj& max,
+                                                    const BSONObj& shardKeyPattern,
+                                                    const WriteConcernOptions& writeConcern) {
+    long long numCloned = 0;
+    long long clonedBytes = 0;
+
+    {
+        OldClientWriteContext cx(opCtx, _nss.ns());
+
+        BSONObjIterator i(docsToClone);
+        while (i.more()) {
+            opCtx->checkForInterrupt();
+
+            if (getState() == ABORT) {
+                log() << "Migration aborted while copying documents";
+                return false;
+            }
+
+            BSONObj docToClone = i.next().Obj();
+
+            BSONObj localDoc;
+            if (willOverrideLocalId(
+                    opCtx, _nss, min, max, shardKeyPattern, cx.db(), docToClone, &localDoc)) {
+                string errMsg = str::stream() << "cannot migrate chunk, local document "
+                                              << redact(localDoc) << " has same _id as cloned "
+                                              << "remote document " << redact(docToClone);
+
+                warning() << errMsg;
+
+                // Exception will abort migration cleanly
+                uasserted(16976, errMsg);
+            }
+
+            Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
+
+            numCloned++;
+            clonedBytes += docToClone.objsize();
+        }
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> statsLock(_mutex);
+        _numCloned += numCloned;
+        _clonedBytes += clonedBytes;
+    }
+
+    if (writeConcern.shouldWaitForOtherNodes()) {
+        repl::ReplicationCoordinator::StatusAndDuration replStatus =
+            repl::getGlobalReplicationCoordinator()->awaitReplication(
+                opCtx,
+                repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
+                writeConcern);
+        if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
+            warning() << "secondaryThrottle on, but doc insert timed out; "
+                         "continuing";
+        } else {
+            massertStatusOK(replStatus.status);
+        }
+    }
+
+    return true;
+}
+
 bool MigrationDestinationManager::_applyMigrateOp(OperationContext* opCtx,
                                                   const NamespaceString& nss,
                                                   const BSONObj& min,
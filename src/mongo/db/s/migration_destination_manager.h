@@ -142,6 +142,19 @@ private:
                         const OID& epoch,
                         const WriteConcernOptions& writeConcern);
 
+    /**
+     * Inserts a batch of documents returned by the donor's "_migrateClone" command, holding the
+     * collection lock for the whole batch, and waits for them to replicate according to
+     * 'writeConcern'. Called concurrently by the clone inserter threads. Returns false if the
+     * migration was aborted.
+     */
+    bool _insertCloneBatch(OperationContext* opCtx,
+                           const BSONObj& docsToClone,
+                           const BSONObj& min,
+                           const BSONObj& max,
+                           const BSONObj& shardKeyPattern,
+                           const WriteConcernOptions& writeConcern);
+
     bool _applyMigrateOp(OperationContext* opCtx,
                          const NamespaceString& ns,
                          const BSONObj& min,
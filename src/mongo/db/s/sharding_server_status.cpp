@@ -31,8 +31,10 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/s/split_vector.h"
 #include "mongo/db/server_options.h"
 #include "mongo/s/balancer_configuration.h"
+#include "mongo/s/catalog_cache.h"
 #include "mongo/s/grid.h"
 
 namespace mongo {
@@ -77,5 +79,29 @@ public:
 
 } shardingServerStatus;
 
+class ShardingStatisticsServerStatus : public ServerStatusSection {
+public:
+    ShardingStatisticsServerStatus() : ServerStatusSection("shardingStatistics") {}
+
+    bool includeByDefault() const final {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const final {
+        BSONObjBuilder result;
+
+        // The catalog cache only exists once sharding has been initialized
+        auto const catalogCache = Grid::get(opCtx)->catalogCache();
+        if (ShardingState::get(opCtx)->enabled() && catalogCache) {
+            catalogCache->report(&result);
+        }
+
+        reportSplitVectorStatistics(&result);
+
+        return result.obj();
+    }
+
+} shardingStatisticsServerStatus;
+
 }  // namespace
 }  // namespace mongo
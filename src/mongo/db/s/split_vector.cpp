@@ -38,11 +38,14 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -50,12 +53,183 @@ namespace {
 
 const int kMaxObjectPerChunk{250000};
 
+// Maximum number of keys to sample at random in order to estimate the split points of a range,
+// instead of scanning the range. Sampling is only attempted for collections with more documents
+// than that, since scanning the ranges of smaller collections is cheap. Zero disables sampling.
+MONGO_EXPORT_SERVER_PARAMETER(splitVectorMaxSampleSize, int, 10000);
+
+// Sampling stops early once this many of the sampled keys fall in the range
+const size_t kTargetSampledKeysInRange = 1000;
+
+// The split points are only estimated from the sample if at least this many of the sampled keys
+// fall in the range. Otherwise the range is a small part of the collection and it is scanned.
+const size_t kMinSampledKeysInRange = 100;
+
+// Sampling gives up on the range once this fraction of the sample has been taken, if the keys in
+// the range are too rare for the whole sample to yield half of kMinSampledKeysInRange of them.
+// The margin allows for the variance of the hit rate measured on a small part of the sample.
+const long long kEarlyCheckSampleFraction = 20;
+
+// Counters describing how splitVector found the split points, reported through serverStatus
+AtomicInt64 splitVectorCountSampled;
+AtomicInt64 splitVectorCountScanned;
+AtomicInt64 splitVectorTotalKeysSampled;
+AtomicInt64 splitVectorTotalKeysScanned;
+AtomicInt64 splitVectorTotalTimeMillis;
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
 
+/**
+ * Samples up to 'maxSampleSize' keys of the index 'idx' at random and returns the ones, which fall
+ * in the range [minKey, maxKey), sorted in index order. The total number of sampled keys is
+ * returned in 'numSampled'.
+ *
+ * Returns boost::none if the storage engine does not support sampling at random.
+ */
+boost::optional<std::vector<BSONObj>> sampleKeysInRange(OperationContext* opCtx,
+                                                        Collection* collection,
+                                                        IndexDescriptor* idx,
+                                                        const BSONObj& minKey,
+                                                        const BSONObj& maxKey,
+                                                        long long maxSampleSize,
+                                                        long long* numSampled) {
+    const IndexAccessMethod* iam = collection->getIndexCatalog()->getIndex(idx);
+    const Ordering ordering = Ordering::make(idx->keyPattern());
+
+    std::vector<BSONObj> keysInRange;
+    *numSampled = 0;
+
+    const auto addIfInRange = [&](const BSONObj& key) {
+        if (key.woCompare(minKey, ordering) >= 0 && key.woCompare(maxKey, ordering) < 0) {
+            keysInRange.push_back(key.getOwned());
+        }
+    };
+
+    const auto shouldStop = [&] {
+        return *numSampled >= maxSampleSize || keysInRange.size() >= kTargetSampledKeysInRange ||
+            !canSampleEnoughKeysInRange(*numSampled, keysInRange.size(), maxSampleSize);
+    };
+
+    // Sampling whole documents is preferred, since they do not need to be fetched, but not all the
+    // storage engines support it for record stores
+    if (auto cursor = collection->getRecordStore()->getRandomCursor(opCtx)) {
+        while (!shouldStop()) {
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            (*numSampled)++;
+
+            BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+            iam->getKeys(record->data.toBson(),
+                         IndexAccessMethod::GetKeysMode::kRelaxConstraints,
+                         &keys,
+                         nullptr);
+            for (const auto& key : keys) {
+                addIfInRange(key);
+            }
+        }
+    } else if (auto cursor = iam->newRandomCursor(opCtx)) {
+        while (!shouldStop()) {
+            auto entry = cursor->next();
+            if (!entry) {
+                break;
+            }
+            (*numSampled)++;
+
+            addIfInRange(entry->key);
+        }
+    } else {
+        return boost::none;
+    }
+
+    std::sort(keysInRange.begin(),
+              keysInRange.end(),
+              [&ordering](const BSONObj& lhs, const BSONObj& rhs) {
+                  return lhs.woCompare(rhs, ordering) < 0;
+              });
+
+    return {std::move(keysInRange)};
+}
+
 }  // namespace
 
+bool canSampleEnoughKeysInRange(long long numSampled,
+                                long long numSampledInRange,
+                                long long maxSampleSize) {
+    if (numSampled < std::max(1LL, maxSampleSize / kEarlyCheckSampleFraction)) {
+        return true;
+    }
+
+    // Compare the number of keys in the range, which the whole sample is expected to yield at the
+    // hit rate so far, with half of the minimum.
+    const double expectedInRange =
+        static_cast<double>(numSampledInRange) * maxSampleSize / numSampled;
+    return 2 * expectedInRange >= kMinSampledKeysInRange;
+}
+
+std::vector<BSONObj> selectSplitKeysFromSample(const std::vector<BSONObj>& sortedSample,
+                                               const BSONObj& indexKeyPattern,
+                                               const BSONObj& shardKeyPattern,
+                                               long long estimatedNumDocs,
+                                               long long keyCount,
+                                               boost::optional<long long> maxSplitPoints) {
+    std::vector<BSONObj> splitKeys;
+    if (sortedSample.empty() || estimatedNumDocs <= 0) {
+        return splitKeys;
+    }
+
+    // Scanning the range would pick a split key after every 'keyCount + 1' documents, so pick the
+    // keys at the same fractions of the sample
+    const double sampledKeysPerChunk =
+        static_cast<double>(keyCount + 1) * sortedSample.size() / estimatedNumDocs;
+
+    const auto extractShardKey = [&](const BSONObj& key) {
+        return dotted_path_support::extractElementsBasedOnTemplate(
+            prettyKey(indexKeyPattern, key), shardKeyPattern);
+    };
+
+    // The first key of the range is a sentinel, like for the scan of the range
+    BSONObj prevKey = extractShardKey(sortedSample.front());
+
+    for (long long numChunks = 1;; numChunks++) {
+        const size_t pos = static_cast<size_t>(numChunks * sampledKeysPerChunk);
+        if (pos >= sortedSample.size()) {
+            break;
+        }
+
+        BSONObj key = extractShardKey(sortedSample[pos]);
+
+        // Do not use this split key if it is the same as the previous split key or as the first
+        // key of the range
+        if (key.woCompare(prevKey) == 0) {
+            continue;
+        }
+
+        splitKeys.push_back(key);
+        prevKey = std::move(key);
+
+        // Stop if we have enough split points.
+        if (maxSplitPoints && maxSplitPoints.get() &&
+            static_cast<long long>(splitKeys.size()) >= maxSplitPoints.get()) {
+            break;
+        }
+    }
+
+    return splitKeys;
+}
+
+void reportSplitVectorStatistics(BSONObjBuilder* builder) {
+    BSONObjBuilder splitVectorBuilder(builder->subobjStart("splitVector"));
+    splitVectorBuilder.append("countSampled", splitVectorCountSampled.load());
+    splitVectorBuilder.append("countScanned", splitVectorCountScanned.load());
+    splitVectorBuilder.append("totalKeysSampled", splitVectorTotalKeysSampled.load());
+    splitVectorBuilder.append("totalKeysScanned", splitVectorTotalKeysScanned.load());
+    splitVectorBuilder.append("totalTimeMillis", splitVectorTotalTimeMillis.load());
+}
+
 StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              const NamespaceString& nss,
                                              const BSONObj& keyPattern,
@@ -151,14 +325,58 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
             keyCount = maxChunkObjects.get();
         }
 
+        Timer timer;
+
+        //
+        // For large collections, first try to estimate the split keys from a random sample of the
+        // index keys, so that large ranges do not have to be scanned. The number of documents in
+        // the range is estimated from the fraction of the sampled keys, which fall in it.
+        //
+
+        const long long maxSampleSize = splitVectorMaxSampleSize.load();
+        if (!force && maxSampleSize > 0 && recCount > maxSampleSize) {
+            long long numSampled = 0;
+            auto sampledKeys = sampleKeysInRange(
+                opCtx, collection, idx, minKey, maxKey, maxSampleSize, &numSampled);
+
+            if (sampledKeys && sampledKeys->size() >= kMinSampledKeysInRange) {
+                const long long estimatedNumDocs = recCount * sampledKeys->size() / numSampled;
+
+                splitKeys = selectSplitKeysFromSample(*sampledKeys,
+                                                      idx->keyPattern(),
+                                                      keyPattern,
+                                                      estimatedNumDocs,
+                                                      keyCount,
+                                                      maxSplitPoints);
+
+                splitVectorCountSampled.addAndFetch(1);
+                splitVectorTotalKeysSampled.addAndFetch(numSampled);
+                splitVectorTotalTimeMillis.addAndFetch(timer.millis());
+
+                LOG(1) << "Estimated " << splitKeys.size() << " split points for " << nss.toString()
+                       << " over " << redact(keyPattern) << " keyCount: " << keyCount
+                       << " from " << sampledKeys->size() << " of " << numSampled
+                       << " sampled keys in " << timer.millis() << "ms";
+
+                std::sort(splitKeys.begin(),
+                          splitKeys.end(),
+                          SimpleBSONObjComparator::kInstance.makeLessThan());
+                return splitKeys;
+            }
+
+            if (numSampled) {
+                splitVectorTotalKeysSampled.addAndFetch(numSampled);
+            }
+        }
+
         //
         // Traverse the index and add the keyCount-th key to the result vector. If that key
         // appeared in the vector before, we omit it. The invariant here is that all the
         // instances of a given key value live in the same chunk.
         //
 
-        Timer timer;
         long long currCount = 0;
+        long long numKeysScanned = 0;
         long long numChunks = 0;
 
         auto exec = InternalPlanner::indexScan(opCtx,
@@ -187,6 +405,7 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
         while (1) {
             while (PlanExecutor::ADVANCED == state) {
                 currCount++;
+                numKeysScanned++;
 
                 if (currCount > keyCount && !force) {
                     currKey = dotted_path_support::extractElementsBasedOnTemplate(
@@ -259,10 +478,14 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
         // Remove the sentinel at the beginning before returning
         splitKeys.erase(splitKeys.begin());
 
+        splitVectorCountScanned.addAndFetch(1);
+        splitVectorTotalKeysScanned.addAndFetch(numKeysScanned);
+        splitVectorTotalTimeMillis.addAndFetch(timer.millis());
+
         if (timer.millis() > serverGlobalParams.slowMS) {
             warning() << "Finding the split vector for " << nss.toString() << " over "
                       << redact(keyPattern) << " keyCount: " << keyCount
-                      << " numSplits: " << splitKeys.size() << " lookedAt: " << currCount
+                      << " numSplits: " << splitKeys.size() << " lookedAt: " << numKeysScanned
                       << " took " << timer.millis() << "ms";
         }
 
@@ -34,6 +34,7 @@
 namespace mongo {
 
 class BSONObj;
+class BSONObjBuilder;
 class NamespaceString;
 class OperationContext;
 template <typename T>
@@ -66,4 +67,39 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              boost::optional<long long> maxChunkSize,
                                              boost::optional<long long> maxChunkSizeBytes);
 
+/**
+ * Used by splitVector to find the split points of a range from a random sample of its keys,
+ * instead of from a scan of the range.
+ *
+ * Given the keys of the index 'indexKeyPattern', which were sampled from the range and are sorted
+ * in index order, and the estimated number of documents in the range, returns the shard keys, which
+ * would split it into chunks of 'keyCount' documents each, at most 'maxSplitPoints' of them. Like
+ * for the scan of the range, the index keys are reduced to their 'shardKeyPattern' prefix before
+ * they are compared, and split keys equal to the previous split key or to the smallest key of the
+ * range are skipped, since all the documents with the same shard key must be in the same chunk.
+ */
+std::vector<BSONObj> selectSplitKeysFromSample(const std::vector<BSONObj>& sortedSample,
+                                               const BSONObj& indexKeyPattern,
+                                               const BSONObj& shardKeyPattern,
+                                               long long estimatedNumDocs,
+                                               long long keyCount,
+                                               boost::optional<long long> maxSplitPoints);
+
+/**
+ * Used by splitVector while it samples keys at random from the whole collection to find the ones
+ * in a range. Returns whether, after 'numSampled' keys of which 'numSampledInRange' fell in the
+ * range, a sample of 'maxSampleSize' keys may still yield enough keys in the range to estimate its
+ * split points from. Once a small part of the sample has been taken, sampling gives up on ranges
+ * which hold too small a part of the collection, so that they are scanned without sampling the
+ * whole collection first.
+ */
+bool canSampleEnoughKeysInRange(long long numSampled,
+                                long long numSampledInRange,
+                                long long maxSampleSize);
+
+/**
+ * Reports how the split points were found by the splitVector calls so far, for serverStatus.
+ */
+void reportSplitVectorStatistics(BSONObjBuilder* builder);
+
 }  // namespace mongo
@@ -300,5 +300,85 @@ TEST_F(SplitVectorTest, NoMaxChunkSize) {
     ASSERT_EQUALS(status.code(), ErrorCodes::InvalidOptions);
 }
 
+TEST(SplitVectorSampleTest, GivesUpEarlyOnRangesWithTooFewSampledKeys) {
+    // Nothing is decided before a twentieth of the sample has been taken
+    ASSERT(canSampleEnoughKeysInRange(0, 0, 10000));
+    ASSERT(canSampleEnoughKeysInRange(499, 0, 10000));
+
+    // 100 keys in the range are needed from the whole sample of 10000, so at least 50 are expected
+    // at the hit rate measured so far
+    ASSERT_FALSE(canSampleEnoughKeysInRange(500, 0, 10000));
+    ASSERT_FALSE(canSampleEnoughKeysInRange(500, 2, 10000));
+    ASSERT(canSampleEnoughKeysInRange(500, 3, 10000));
+    ASSERT_FALSE(canSampleEnoughKeysInRange(5000, 24, 10000));
+    ASSERT(canSampleEnoughKeysInRange(5000, 25, 10000));
+
+    // A range holding a tenth of the collection keeps being sampled
+    ASSERT(canSampleEnoughKeysInRange(1000, 100, 10000));
+}
+
+TEST(SplitVectorSampleTest, SelectsKeysAtChunkBoundaries) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 100; i++) {
+        sample.push_back(BSON("" << i));
+    }
+
+    const BSONObj keyPattern = BSON("a" << 1);
+
+    // Each of the 1000 estimated documents is represented by 0.1 sampled keys, so chunks of 250
+    // documents start at every 25th sampled key
+    const auto splitKeys =
+        selectSplitKeysFromSample(sample, keyPattern, keyPattern, 1000, 249, boost::none);
+    std::vector<BSONObj> expected = {BSON("a" << 25), BSON("a" << 50), BSON("a" << 75)};
+    ASSERT_EQ(expected.size(), splitKeys.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_BSONOBJ_EQ(expected[i], splitKeys[i]);
+    }
+
+    const auto limitedSplitKeys =
+        selectSplitKeysFromSample(sample, keyPattern, keyPattern, 1000, 249, 2LL);
+    ASSERT_EQ(2U, limitedSplitKeys.size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 50), limitedSplitKeys[1]);
+
+    // There is not enough data in the range for more than one chunk
+    ASSERT(selectSplitKeysFromSample(sample, keyPattern, keyPattern, 100, 249, boost::none)
+               .empty());
+}
+
+TEST(SplitVectorSampleTest, SkipsRepeatedKeys) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 100; i++) {
+        sample.push_back(BSON("" << (i < 60 ? 0 : 1)));
+    }
+
+    const BSONObj keyPattern = BSON("a" << 1);
+
+    // All the documents with key 0 must stay in the first chunk
+    const auto splitKeys =
+        selectSplitKeysFromSample(sample, keyPattern, keyPattern, 1000, 99, boost::none);
+    ASSERT_EQ(1U, splitKeys.size());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1), splitKeys[0]);
+}
+
+TEST(SplitVectorSampleTest, SkipsRepeatedShardKeysOfCompoundIndex) {
+    // The keys of an index { a: 1, b: 1 }, which is prefixed by the shard key { a: 1 }. Each value
+    // of 'a' spans 20 sampled keys, which all differ in 'b'.
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 100; i++) {
+        sample.push_back(BSON("" << i / 20 << "" << i));
+    }
+
+    // Every 10th sampled key starts a chunk, but the chunks are only split where 'a' changes, and
+    // never at the smallest value of 'a' in the range
+    const auto splitKeys = selectSplitKeysFromSample(
+        sample, BSON("a" << 1 << "b" << 1), BSON("a" << 1), 1000, 99, boost::none);
+    std::vector<BSONObj> expected = {
+        BSON("a" << 1), BSON("a" << 2), BSON("a" << 3), BSON("a" << 4)};
+    ASSERT_EQ(expected.size(), splitKeys.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        ASSERT_BSONOBJ_EQ(expected[i], splitKeys[i]);
+    }
+}
+
 }  // namespace
 }  // namespace mongo
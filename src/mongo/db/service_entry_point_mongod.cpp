@@ -64,6 +64,7 @@
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
@@ -78,6 +79,7 @@
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/stale_exception.h"
+#include "mongo/util/concurrency/priority_ticketholder.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
@@ -91,6 +93,10 @@ MONGO_FP_DECLARE(rsStopGetMore);
 namespace {
 using logger::LogComponent;
 
+// Allows a getMore sent with the OP_MSG exhaustAllowed flag to be answered with a stream of
+// replies. Off by default, as no client consumes the stream yet.
+MONGO_EXPORT_SERVER_PARAMETER(enableOpMsgExhaust, bool, false);
+
 inline void opread(const Message& m) {
     if (_diaglog.getLevel() & 2) {
         _diaglog.readop(m.singleData().view2ptr(), m.header().getLen());
@@ -552,6 +558,7 @@ void execCommandDatabase(OperationContext* opCtx,
         BSONElement helpField;
         BSONElement shardVersionFieldIdx;
         BSONElement queryOptionMaxTimeMSField;
+        BSONElement priorityField;
 
         StringMap<int> topLevelFields;
         for (auto&& element : request.body) {
@@ -564,6 +571,8 @@ void execCommandDatabase(OperationContext* opCtx,
                 shardVersionFieldIdx = element;
             } else if (fieldName == QueryRequest::queryOptionMaxTimeMS) {
                 queryOptionMaxTimeMSField = element;
+            } else if (fieldName == Command::kPriorityFieldName) {
+                priorityField = element;
             }
 
             uassert(ErrorCodes::FailedToParse,
@@ -655,6 +664,17 @@ void execCommandDatabase(OperationContext* opCtx,
             opCtx->setDeadlineAfterNowBy(Milliseconds{maxTimeMS});
         }
 
+        // Handle command option priority.
+        if (!priorityField.eoo()) {
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "'" << Command::kPriorityFieldName
+                                  << "' must be a string, but was "
+                                  << typeName(priorityField.type()),
+                    priorityField.type() == String);
+            opCtx->lockState()->setAdmissionPriority(
+                uassertStatusOK(parseAdmissionPriority(priorityField.valueStringData())));
+        }
+
         repl::ReadConcernArgs::get(opCtx) = uassertStatusOK(_extractReadConcern(
             request.body,
             command->supportsNonLocalReadConcern(request.getDatabase().toString(), request.body)));
@@ -768,6 +788,9 @@ void curOpCommandSetup(OperationContext* opCtx, const OpMsgRequest& request) {
 
 DbResponse runCommands(OperationContext* opCtx, const Message& message) {
     auto replyBuilder = rpc::makeReplyBuilder(rpc::protocolForMessage(message));
+    // Set to the getMore to run again if the client allowed this request to be answered in
+    // exhaust mode.
+    BSONObj exhaustCmd;
     [&] {
         OpMsgRequest request;
         try {  // Parse.
@@ -813,6 +836,11 @@ DbResponse runCommands(OperationContext* opCtx, const Message& message) {
             }
 
             execCommandDatabase(opCtx, c, request, replyBuilder.get());
+
+            if (enableOpMsgExhaust.load() && OpMsg::isFlagSet(message, OpMsg::kExhaustAllowed) &&
+                request.getCommandName() == "getMore") {
+                exhaustCmd = request.body.getOwned();
+            }
         } catch (const DBException& ex) {
             LOG(1) << "assertion while executing command '" << request.getCommandName() << "' "
                    << "on database '" << request.getDatabase() << "': " << ex.toString();
@@ -833,8 +861,23 @@ DbResponse runCommands(OperationContext* opCtx, const Message& message) {
     auto response = replyBuilder->done();
     CurOp::get(opCtx)->debug().responseLength = response.header().dataLen();
 
-    // TODO exhaust
-    return DbResponse{std::move(response)};
+    if (exhaustCmd.isEmpty()) {
+        return DbResponse{std::move(response)};
+    }
+
+    // Keep streaming batches as long as the getMore succeeded and left the cursor open. The
+    // client stops the stream by killing the cursor or closing the connection.
+    const auto replyBody = OpMsg::parse(response).body;
+    const auto cursorId = replyBody.getObjectField("cursor")["id"].numberLong();
+    if (!replyBody["ok"].trueValue() || cursorId == 0) {
+        return DbResponse{std::move(response)};
+    }
+
+    OpMsg::setFlag(&response, OpMsg::kMoreToCome);
+    DbResponse dbResponse{std::move(response)};
+    dbResponse.shouldRunAgainForExhaust = true;
+    dbResponse.nextInvocation = std::move(exhaustCmd);
+    return dbResponse;
 }
 
 DbResponse receivedQuery(OperationContext* opCtx,
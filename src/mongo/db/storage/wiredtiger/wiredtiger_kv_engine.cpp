@@ -75,7 +75,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
-#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/concurrency/priority_ticketholder.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
@@ -265,11 +265,11 @@ class TicketServerParameter : public ServerParameter {
     MONGO_DISALLOW_COPYING(TicketServerParameter);
 
 public:
-    TicketServerParameter(TicketHolder* holder, const std::string& name)
+    TicketServerParameter(PriorityTicketHolder* holder, const std::string& name)
         : ServerParameter(ServerParameterSet::getGlobal(), name, true, true), _holder(holder) {}
 
     virtual void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) {
-        b.append(name, _holder->outof());
+        b.append(name, _holder->maxTickets());
     }
 
     virtual Status set(const BSONElement& newValueElement) {
@@ -295,17 +295,22 @@ public:
     }
 
 private:
-    TicketHolder* _holder;
+    PriorityTicketHolder* _holder;
 };
 
-TicketHolder openWriteTransaction(128);
+PriorityTicketHolder openWriteTransaction(128);
 TicketServerParameter openWriteTransactionParam(&openWriteTransaction,
                                                 "wiredTigerConcurrentWriteTransactions");
 
-TicketHolder openReadTransaction(128);
+PriorityTicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// When enabled, the number of read and write tickets handed out is sized dynamically between
+// kMinDynamicTickets and the configured number, following the observed throughput.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(wiredTigerDynamicConcurrentTransactions, bool, false);
+const int kMinDynamicTickets = 8;
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
@@ -433,6 +438,10 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
         new WiredTigerSizeStorer(_conn, _sizeStorerUri, sizeStorerLoggingEnabled, _readOnly));
     _sizeStorer->fillCache();
 
+    if (wiredTigerDynamicConcurrentTransactions) {
+        openReadTransaction.setDynamicSizing(true, kMinDynamicTickets);
+        openWriteTransaction.setDynamicSizing(true, kMinDynamicTickets);
+    }
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
 }
 
@@ -449,16 +458,12 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
     BSONObjBuilder bb(b.subobjStart("concurrentTransactions"));
     {
         BSONObjBuilder bbb(bb.subobjStart("write"));
-        bbb.append("out", openWriteTransaction.used());
-        bbb.append("available", openWriteTransaction.available());
-        bbb.append("totalTickets", openWriteTransaction.outof());
+        openWriteTransaction.appendStats(&bbb);
         bbb.done();
     }
     {
         BSONObjBuilder bbb(bb.subobjStart("read"));
-        bbb.append("out", openReadTransaction.used());
-        bbb.append("available", openReadTransaction.available());
-        bbb.append("totalTickets", openReadTransaction.outof());
+        openReadTransaction.appendStats(&bbb);
         bbb.done();
     }
     bb.done();
@@ -33,10 +33,16 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/cursor_id.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/dbmessage.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/transport/service_entry_point.h"
 #include "mongo/util/net/op_msg.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -68,6 +74,107 @@ TEST(CommandTests, InputDocumentSequeceWorksEndToEnd) {
     ASSERT_EQ(db.count(ns.ns()), 5u);
 }
 
+namespace {
+
+void setOpMsgExhaustEnabled(bool enabled) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("enableOpMsgExhaust");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString(enabled ? "true" : "false"));
+}
+
+/**
+ * Inserts 'numDocs' documents into 'ns' and returns the id of a cursor over them which has
+ * returned its first one.
+ */
+CursorId openCursor(const NamespaceString& ns, int numDocs) {
+    const auto opCtxHolder = cc().makeOperationContext();
+    DBDirectClient db(opCtxHolder.get());
+    db.dropCollection(ns.ns());
+    for (int i = 0; i < numDocs; ++i) {
+        db.insert(ns.ns(), BSON("_id" << i));
+    }
+
+    BSONObj reply;
+    ASSERT(db.runCommand(
+        ns.db().toString(), BSON("find" << ns.coll() << "batchSize" << 1), reply));
+    const auto cursorId = reply["cursor"]["id"].numberLong();
+    ASSERT_NE(0, cursorId);
+    return cursorId;
+}
+
+/**
+ * Runs a getMore of one document from 'cursorId' through the service entry point, as received from
+ * a client which allows replies in exhaust mode. Like the ServiceStateMachine, uses a new operation
+ * for each request.
+ */
+DbResponse runExhaustGetMore(const NamespaceString& ns, CursorId cursorId) {
+    const auto opCtxHolder = cc().makeOperationContext();
+    auto opCtx = opCtxHolder.get();
+    auto request =
+        OpMsgRequest::fromDBAndBody(ns.db(),
+                                    BSON("getMore" << cursorId << "collection" << ns.coll()
+                                                   << "batchSize"
+                                                   << 1))
+            .serialize();
+    OpMsg::setFlag(&request, OpMsg::kExhaustAllowed);
+    return opCtx->getServiceContext()->getServiceEntryPoint()->handleRequest(opCtx, request);
+}
+
+}  // namespace
+
+TEST(CommandTests, ExhaustGetMoreStreamsUntilCursorIsExhausted) {
+    setOpMsgExhaustEnabled(true);
+    ON_BLOCK_EXIT([] { setOpMsgExhaustEnabled(false); });
+
+    NamespaceString ns("test", "exhaust_getmore");
+    const auto cursorId = openCursor(ns, 3);
+
+    // The cursor stays open after each of the remaining documents, so these replies are streamed.
+    for (int i = 1; i < 3; ++i) {
+        auto dbResponse = runExhaustGetMore(ns, cursorId);
+        ASSERT(OpMsg::isFlagSet(dbResponse.response, OpMsg::kMoreToCome));
+        ASSERT(dbResponse.shouldRunAgainForExhaust);
+        ASSERT_EQ(cursorId, dbResponse.nextInvocation["getMore"].numberLong());
+
+        const auto reply = OpMsg::parse(dbResponse.response).body;
+        ASSERT_EQ(cursorId, reply["cursor"]["id"].numberLong());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << i), reply["cursor"]["nextBatch"].Array()[0].Obj());
+    }
+
+    // The stream ends with the reply which reports the cursor exhausted.
+    auto dbResponse = runExhaustGetMore(ns, cursorId);
+    ASSERT_FALSE(OpMsg::isFlagSet(dbResponse.response, OpMsg::kMoreToCome));
+    ASSERT_FALSE(dbResponse.shouldRunAgainForExhaust);
+    ASSERT_EQ(0, OpMsg::parse(dbResponse.response).body["cursor"]["id"].numberLong());
+}
+
+TEST(CommandTests, ExhaustGetMoreEndsStreamOnError) {
+    setOpMsgExhaustEnabled(true);
+    ON_BLOCK_EXIT([] { setOpMsgExhaustEnabled(false); });
+
+    NamespaceString ns("test", "exhaust_getmore");
+    const auto cursorId = openCursor(ns, 3);
+    {
+        const auto opCtxHolder = cc().makeOperationContext();
+        DBDirectClient(opCtxHolder.get()).killCursor(ns, cursorId);
+    }
+
+    auto dbResponse = runExhaustGetMore(ns, cursorId);
+    ASSERT_FALSE(OpMsg::isFlagSet(dbResponse.response, OpMsg::kMoreToCome));
+    ASSERT_FALSE(dbResponse.shouldRunAgainForExhaust);
+    ASSERT_FALSE(OpMsg::parse(dbResponse.response).body["ok"].trueValue());
+}
+
+TEST(CommandTests, ExhaustGetMoreIsOffByDefault) {
+    NamespaceString ns("test", "exhaust_getmore");
+    const auto cursorId = openCursor(ns, 3);
+
+    auto dbResponse = runExhaustGetMore(ns, cursorId);
+    ASSERT_FALSE(OpMsg::isFlagSet(dbResponse.response, OpMsg::kMoreToCome));
+    ASSERT_FALSE(dbResponse.shouldRunAgainForExhaust);
+    ASSERT_EQ(cursorId, OpMsg::parse(dbResponse.response).body["cursor"]["id"].numberLong());
+}
+
 using std::string;
 
 /**
@@ -43,7 +43,7 @@
 #include "mongo/util/scopeguard.h"
 
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the pool lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
@@ -65,8 +65,16 @@ public:
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Locks this pool. The parent's _mutex must be held while acquiring the lock, so that the
+     * pool cannot be shut down and destroyed in between; it may be released once this returns.
+     */
+    stdx::unique_lock<stdx::mutex> lockPool() {
+        return stdx::unique_lock<stdx::mutex>(_mutex);
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks the pool's unique_lock
+     * to preserve the lock on _mutex
      */
     void getConnection(const HostAndPort& hostAndPort,
                        Milliseconds timeout,
@@ -81,8 +89,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks the pool's unique_lock
+     * to preserve the lock on _mutex
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -113,14 +121,24 @@ public:
      */
     size_t openConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns how long fulfilled requests have waited for a connection from this pool.
+     */
+    const ConnectionWaitTimeHistogram& acquisitionWaitTimes(
+        const stdx::unique_lock<stdx::mutex>& lk);
+
 private:
     using OwnedConnection = std::unique_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
-    using Request = std::pair<Date_t, GetConnectionCallback>;
+    struct Request {
+        Date_t expiration;
+        Date_t requested;
+        GetConnectionCallback cb;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
@@ -145,6 +163,10 @@ private:
 
     const HostAndPort _hostAndPort;
 
+    // Guards all of the state below. Each host has its own pool lock, so checkouts and returns
+    // for different hosts do not contend with each other.
+    stdx::mutex _mutex;
+
     LRUOwnershipPool _readyPool;
     OwnershipPool _processingPool;
     OwnershipPool _droppedProcessingPool;
@@ -160,6 +182,8 @@ private:
 
     size_t _created;
 
+    ConnectionWaitTimeHistogram _acquisitionWaitTimes;
+
     /**
      * The current state of the pool
      *
@@ -211,8 +235,13 @@ void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
     if (iter == _pools.end())
         return;
 
-    iter->second.get()->processFailure(
-        Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"), std::move(lk));
+    auto pool = iter->second.get();
+    auto poolLk = pool->lockPool();
+    lk.unlock();
+
+    pool->processFailure(
+        Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
+        std::move(poolLk));
 }
 
 void ConnectionPool::get(const HostAndPort& hostAndPort,
@@ -234,7 +263,10 @@ void ConnectionPool::get(const HostAndPort& hostAndPort,
 
     invariant(pool);
 
-    pool->getConnection(hostAndPort, timeout, std::move(lk), std::move(cb));
+    auto poolLk = pool->lockPool();
+    lk.unlock();
+
+    pool->getConnection(hostAndPort, timeout, std::move(poolLk), std::move(cb));
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
@@ -244,10 +276,13 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
         HostAndPort host = kv.first;
 
         auto& pool = kv.second;
-        ConnectionStatsPer hostStats{pool->inUseConnections(lk),
-                                     pool->availableConnections(lk),
-                                     pool->createdConnections(lk),
-                                     pool->refreshingConnections(lk)};
+        auto poolLk = pool->lockPool();
+        ConnectionStatsPer hostStats{pool->inUseConnections(poolLk),
+                                     pool->availableConnections(poolLk),
+                                     pool->createdConnections(poolLk),
+                                     pool->refreshingConnections(poolLk)};
+        hostStats.acquisitionWaitTimes = pool->acquisitionWaitTimes(poolLk);
+        poolLk.unlock();
         stats->updateStatsForHost(_name, host, hostStats);
     }
 }
@@ -256,7 +291,8 @@ size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort)
     stdx::unique_lock<stdx::mutex> lk(_mutex);
     auto iter = _pools.find(hostAndPort);
     if (iter != _pools.end()) {
-        return iter->second->openConnections(lk);
+        auto poolLk = iter->second->lockPool();
+        return iter->second->openConnections(poolLk);
     }
 
     return 0;
@@ -269,7 +305,11 @@ void ConnectionPool::returnConnection(ConnectionInterface* conn) {
 
     invariant(iter != _pools.end());
 
-    iter->second.get()->returnConnection(conn, std::move(lk));
+    auto pool = iter->second.get();
+    auto poolLk = pool->lockPool();
+    lk.unlock();
+
+    pool->returnConnection(conn, std::move(poolLk));
 }
 
 ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort)
@@ -309,6 +349,11 @@ size_t ConnectionPool::SpecificPool::openConnections(const stdx::unique_lock<std
     return _checkedOutPool.size() + _readyPool.size() + _processingPool.size();
 }
 
+const ConnectionWaitTimeHistogram& ConnectionPool::SpecificPool::acquisitionWaitTimes(
+    const stdx::unique_lock<stdx::mutex>& lk) {
+    return _acquisitionWaitTimes;
+}
+
 void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
                                                  Milliseconds timeout,
                                                  stdx::unique_lock<stdx::mutex> lk,
@@ -317,9 +362,9 @@ void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
         timeout = _parent->_options.refreshTimeout;
     }
 
-    const auto expiration = _parent->_factory->now() + timeout;
+    const auto now = _parent->_factory->now();
 
-    _requests.push(make_pair(expiration, std::move(cb)));
+    _requests.push(Request{now + timeout, now, std::move(cb)});
 
     updateStateInLock();
 
@@ -372,7 +417,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
                          [this](ConnectionInterface* connPtr, Status status) {
                              connPtr->indicateUsed();
 
-                             stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+                             stdx::unique_lock<stdx::mutex> lk(_mutex);
 
                              auto conn = takeFromProcessingPool(connPtr);
 
@@ -432,7 +477,7 @@ void ConnectionPool::SpecificPool::addToReady(stdx::unique_lock<stdx::mutex>& lk
     connPtr->setTimeout(_parent->_options.refreshRequirement, [this, connPtr]() {
         OwnedConnection conn;
 
-        stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
 
         if (!_readyPool.count(connPtr)) {
             // We've already been checked out. We don't need to refresh
@@ -492,7 +537,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status,
     lk.unlock();
 
     while (requestsToFail.size()) {
-        requestsToFail.top().second(status);
+        requestsToFail.top().cb(status);
         requestsToFail.pop();
     }
 }
@@ -535,7 +580,8 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         }
 
         // Grab the request and callback
-        auto cb = std::move(_requests.top().second);
+        _acquisitionWaitTimes.record(_parent->_factory->now() - _requests.top().requested);
+        auto cb = std::move(_requests.top().cb);
         _requests.pop();
 
         auto connPtr = conn.get();
@@ -594,7 +640,7 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
             _parent->_options.refreshTimeout, [this](ConnectionInterface* connPtr, Status status) {
                 connPtr->indicateUsed();
 
-                stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
 
                 auto conn = takeFromProcessingPool(connPtr);
 
@@ -624,7 +670,9 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
 
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+    // Erasing ourselves from the parent requires its lock, which must be taken before ours.
+    stdx::unique_lock<stdx::mutex> parentLk(_parent->_mutex);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     // We're racing:
     //
@@ -658,6 +706,9 @@ void ConnectionPool::SpecificPool::shutdown() {
     invariant(_requests.empty());
     invariant(_checkedOutPool.empty());
 
+    // Our mutex is destroyed along with us, so release it first. Holding the parent's lock keeps
+    // any other thread from finding and locking this pool in the meantime.
+    lk.unlock();
     _parent->_pools.erase(_hostAndPort);
 }
 
@@ -688,29 +739,29 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // If we were already running and the timer is the same as it was
         // before, nothing to do
-        if (_state == State::kRunning && _requestTimerExpiration == _requests.top().first)
+        if (_state == State::kRunning && _requestTimerExpiration == _requests.top().expiration)
             return;
 
         _state = State::kRunning;
 
         _requestTimer->cancelTimeout();
 
-        _requestTimerExpiration = _requests.top().first;
+        _requestTimerExpiration = _requests.top().expiration;
 
-        auto timeout = _requests.top().first - _parent->_factory->now();
+        auto timeout = _requests.top().expiration - _parent->_factory->now();
 
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
         _requestTimer->setTimeout(timeout, [this]() {
-            stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
 
             auto now = _parent->_factory->now();
 
             while (_requests.size()) {
                 auto& x = _requests.top();
 
-                if (x.first <= now) {
-                    auto cb = std::move(x.second);
+                if (x.expiration <= now) {
+                    auto cb = std::move(x.cb);
                     _requests.pop();
 
                     lk.unlock();
@@ -144,7 +144,8 @@ private:
 
     const std::unique_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
+    // Guards the map of specific pools. Each SpecificPool has its own mutex for its connections
+    // and requests, which is acquired while holding this one and then this one is released.
     mutable stdx::mutex _mutex;
     stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> _pools;
 };
@@ -30,12 +30,58 @@
 
 #include "mongo/executor/connection_pool_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/map_util.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 namespace executor {
 
+constexpr size_t ConnectionWaitTimeHistogram::kNumBuckets;
+const std::array<Milliseconds, ConnectionWaitTimeHistogram::kNumBuckets - 1>
+    ConnectionWaitTimeHistogram::kBucketUpperBounds = {Milliseconds(1),
+                                                       Milliseconds(2),
+                                                       Milliseconds(5),
+                                                       Milliseconds(10),
+                                                       Milliseconds(50),
+                                                       Milliseconds(100),
+                                                       Milliseconds(1000)};
+
+void ConnectionWaitTimeHistogram::record(Milliseconds waitTime) {
+    auto bound =
+        std::upper_bound(kBucketUpperBounds.begin(), kBucketUpperBounds.end(), waitTime);
+    counts[bound - kBucketUpperBounds.begin()]++;
+    totalCount++;
+    totalWaitTime += waitTime;
+}
+
+ConnectionWaitTimeHistogram& ConnectionWaitTimeHistogram::operator+=(
+    const ConnectionWaitTimeHistogram& other) {
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        counts[i] += other.counts[i];
+    }
+    totalCount += other.totalCount;
+    totalWaitTime += other.totalWaitTime;
+
+    return *this;
+}
+
+void ConnectionWaitTimeHistogram::appendToBSON(BSONObjBuilder* builder) const {
+    BSONObjBuilder histogramBuilder(builder->subobjStart("acquisitionWaitTimes"));
+    for (size_t i = 0; i < kNumBuckets - 1; ++i) {
+        const std::string bucketName = str::stream() << "lt" << kBucketUpperBounds[i].count()
+                                                     << "ms";
+        histogramBuilder.appendNumber(bucketName, counts[i]);
+    }
+    const std::string lastBucketName = str::stream() << "gte" << kBucketUpperBounds.back().count()
+                                                     << "ms";
+    histogramBuilder.appendNumber(lastBucketName, counts.back());
+    histogramBuilder.appendNumber("totalCount", totalCount);
+    histogramBuilder.appendNumber("totalWaitMillis", durationCount<Milliseconds>(totalWaitTime));
+}
+
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
                                        size_t nCreated,
@@ -49,6 +95,7 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    acquisitionWaitTimes += other.acquisitionWaitTimes;
 
     return *this;
 }
@@ -66,6 +113,7 @@ void ConnectionPoolStats::updateStatsForHost(std::string pool,
     totalAvailable += newStats.available;
     totalCreated += newStats.created;
     totalRefreshing += newStats.refreshing;
+    totalAcquisitionWaitTimes += newStats.acquisitionWaitTimes;
 }
 
 void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
@@ -73,6 +121,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
     result.appendNumber("totalRefreshing", totalRefreshing);
+    totalAcquisitionWaitTimes.appendToBSON(&result);
 
     {
         BSONObjBuilder poolBuilder(result.subobjStart("pools"));
@@ -83,6 +132,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             poolInfo.appendNumber("poolAvailable", poolStats.available);
             poolInfo.appendNumber("poolCreated", poolStats.created);
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
+            poolStats.acquisitionWaitTimes.appendToBSON(&poolInfo);
             for (auto&& host : statsByPoolHost[pool.first]) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
                 auto hostStats = host.second;
@@ -90,6 +140,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                hostStats.acquisitionWaitTimes.appendToBSON(&hostInfo);
             }
         }
     }
@@ -102,6 +153,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            hostStats.acquisitionWaitTimes.appendToBSON(&hostInfo);
         }
     }
 }
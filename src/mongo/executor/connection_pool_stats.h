@@ -28,12 +28,38 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
+
+class BSONObjBuilder;
+
 namespace executor {
 
+/**
+ * Counts connection acquisitions by how long the request waited for a connection. Each bucket
+ * holds the waits shorter than its upper bound in kBucketUpperBounds and at least as long as the
+ * previous bucket's bound; the final bucket holds everything longer.
+ */
+struct ConnectionWaitTimeHistogram {
+    static constexpr size_t kNumBuckets = 8;
+    static const std::array<Milliseconds, kNumBuckets - 1> kBucketUpperBounds;
+
+    void record(Milliseconds waitTime);
+
+    ConnectionWaitTimeHistogram& operator+=(const ConnectionWaitTimeHistogram& other);
+
+    void appendToBSON(BSONObjBuilder* builder) const;
+
+    std::array<size_t, kNumBuckets> counts{};
+    size_t totalCount = 0u;
+    Milliseconds totalWaitTime{0};
+};
+
 /**
  * Holds connection information for a specific pool or remote host. These objects are maintained by
  * a parent ConnectionPoolStats object and should not need to be created directly.
@@ -49,6 +75,7 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+    ConnectionWaitTimeHistogram acquisitionWaitTimes;
 };
 
 /**
@@ -65,6 +92,7 @@ struct ConnectionPoolStats {
     size_t totalAvailable = 0u;
     size_t totalCreated = 0u;
     size_t totalRefreshing = 0u;
+    ConnectionWaitTimeHistogram totalAcquisitionWaitTimes;
 
     stdx::unordered_map<std::string, ConnectionStatsPer> statsByPool;
     stdx::unordered_map<HostAndPort, ConnectionStatsPer> statsByHost;
@@ -34,6 +34,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -1308,6 +1309,66 @@ TEST_F(ConnectionPoolTest, RefreshTimeoutsDontTimeoutRequests) {
     ASSERT(!conn2);
 }
 
+/**
+ * Verify that the time requests spend waiting for a connection is recorded per host.
+ */
+TEST_F(ConnectionPoolTest, AcquisitionWaitTimesAreRecordedPerHost) {
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    // The first request has to wait for its connection to be set up.
+    size_t conn1Id = 0;
+    pool.get(HostAndPort("host1", 27017),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 conn1Id = CONN2ID(swConn);
+                 doneWith(swConn.getValue());
+             });
+    ASSERT(!conn1Id);
+
+    PoolImpl::setNow(now + Milliseconds(20));
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn1Id);
+
+    // The second request is served straight from the ready pool.
+    size_t conn2Id = 0;
+    pool.get(HostAndPort("host1", 27017),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 conn2Id = CONN2ID(swConn);
+                 doneWith(swConn.getValue());
+             });
+    ASSERT_EQ(conn1Id, conn2Id);
+
+    // A request to another host is accounted to that host only.
+    size_t conn3Id = 0;
+    ConnectionImpl::pushSetup(Status::OK());
+    pool.get(HostAndPort("host2", 27017),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 conn3Id = CONN2ID(swConn);
+                 doneWith(swConn.getValue());
+             });
+    ASSERT(conn3Id);
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+
+    const auto& host1Times = stats.statsByHost[HostAndPort("host1", 27017)].acquisitionWaitTimes;
+    ASSERT_EQ(host1Times.totalCount, 2u);
+    ASSERT_EQ(host1Times.totalWaitTime, Milliseconds(20));
+    ASSERT_EQ(host1Times.counts[0], 1u);  // < 1ms
+    ASSERT_EQ(host1Times.counts[4], 1u);  // [10ms, 50ms)
+
+    const auto& host2Times = stats.statsByHost[HostAndPort("host2", 27017)].acquisitionWaitTimes;
+    ASSERT_EQ(host2Times.totalCount, 1u);
+    ASSERT_EQ(host2Times.counts[0], 1u);
+
+    ASSERT_EQ(stats.totalAcquisitionWaitTimes.totalCount, 3u);
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
@@ -57,10 +57,6 @@
 namespace mongo {
 namespace executor {
 
-namespace {
-const std::size_t kIOServiceWorkers = 1;
-}  // namespace
-
 NetworkInterfaceASIO::Options::Options() = default;
 
 NetworkInterfaceASIO::NetworkInterfaceASIO(Options options)
@@ -77,6 +73,7 @@ NetworkInterfaceASIO::NetworkInterfaceASIO(Options options)
       _isExecutorRunnable(false),
       _strand(_io_service) {
     invariant(_timerFactory);
+    invariant(_options.numWorkerThreads > 0);
 }
 
 std::string NetworkInterfaceASIO::getDiagnosticString() {
@@ -149,8 +146,8 @@ std::string NetworkInterfaceASIO::getHostName() {
 }
 
 void NetworkInterfaceASIO::startup() {
-    _serviceRunners.resize(kIOServiceWorkers);
-    for (std::size_t i = 0; i < kIOServiceWorkers; ++i) {
+    _serviceRunners.resize(_options.numWorkerThreads);
+    for (std::size_t i = 0; i < _options.numWorkerThreads; ++i) {
         _serviceRunners[i] = stdx::thread([this, i]() {
             setThreadName(_options.instanceName + "-" + std::to_string(i));
             try {
@@ -108,6 +108,10 @@ public:
         std::unique_ptr<NetworkConnectionHook> networkConnectionHook;
         std::unique_ptr<AsyncStreamFactoryInterface> streamFactory;
         std::unique_ptr<rpc::EgressMetadataHook> metadataHook;
+
+        // Number of threads running the io_service. Every operation runs on its own strand, so
+        // with more than one thread, operations make progress in parallel.
+        size_t numWorkerThreads = 1;
     };
 
     NetworkInterfaceASIO(Options = Options());
@@ -904,6 +904,40 @@ TEST_F(NetworkInterfaceASIOTest, SetAlarm) {
     ASSERT(!deferred2.hasCompleted());
 }
 
+class NetworkInterfaceASIOMultipleWorkersTest : public NetworkInterfaceASIOTest {
+public:
+    void setUp() override {
+        NetworkInterfaceASIO::Options options{};
+        options.streamFactory = stdx::make_unique<AsyncMockStreamFactory>();
+        options.timerFactory = stdx::make_unique<AsyncTimerFactoryMock>();
+        options.numWorkerThreads = 2;
+        _net = stdx::make_unique<NetworkInterfaceASIO>(std::move(options));
+        _net->startup();
+    }
+};
+
+TEST_F(NetworkInterfaceASIOMultipleWorkersTest, AlarmsRunConcurrently) {
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    bool secondAlarmRan = false;
+
+    // The first alarm can only complete once the second one has run on another worker thread.
+    Deferred<bool> firstAlarmSawSecond;
+    ASSERT_OK(net().setAlarm(net().now(), [&, firstAlarmSawSecond]() mutable {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        firstAlarmSawSecond.emplace(cv.wait_for(
+            lk, Seconds(30).toSystemDuration(), [&] { return secondAlarmRan; }));
+    }));
+    ASSERT_OK(net().setAlarm(net().now(), [&] {
+        ASSERT(net().onNetworkThread());
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        secondAlarmRan = true;
+        cv.notify_all();
+    }));
+
+    ASSERT(firstAlarmSawSecond.get());
+}
+
 TEST_F(NetworkInterfaceASIOTest, SetAlarmReturnsNotOKIfShutdownHasStarted) {
     net().shutdown();
     ASSERT_NOT_OK(net().setAlarm(net().now() + Milliseconds(100), [] {}));
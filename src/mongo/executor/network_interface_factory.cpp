@@ -30,6 +30,8 @@
 
 #include "mongo/executor/network_interface_factory.h"
 
+#include <algorithm>
+
 #include "mongo/base/init.h"
 #include "mongo/base/status.h"
 #include "mongo/config.h"
@@ -48,6 +50,14 @@
 namespace mongo {
 namespace executor {
 
+namespace {
+
+// Number of threads driving the networking of each NetworkInterface created here. Values below 1
+// are treated as 1.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(networkInterfaceWorkerThreads, int, 1);
+
+}  // namespace
+
 std::unique_ptr<NetworkInterface> makeNetworkInterface(std::string instanceName) {
     return makeNetworkInterface(std::move(instanceName), nullptr, nullptr);
 }
@@ -63,6 +73,7 @@ std::unique_ptr<NetworkInterface> makeNetworkInterface(
     options.metadataHook = std::move(metadataHook);
     options.timerFactory = stdx::make_unique<AsyncTimerFactoryASIO>();
     options.connectionPoolOptions = connPoolOptions;
+    options.numWorkerThreads = static_cast<size_t>(std::max(networkInterfaceWorkerThreads, 1));
 
 #ifdef MONGO_CONFIG_SSL
     if (SSLManagerInterface* manager = getSSLManager()) {
@@ -32,12 +32,20 @@
 
 #include "mongo/s/async_requests_sender.h"
 
+#include <algorithm>
+
+#include "mongo/base/counter.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -48,6 +56,128 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Whether eligible reads to replica set secondaries are hedged. Off by default.
+MONGO_EXPORT_SERVER_PARAMETER(enableHedgedReads, bool, false);
+
+// The hedge delay for a host whose latency has not been observed often enough yet.
+MONGO_EXPORT_SERVER_PARAMETER(hedgedReadsDefaultDelayMillis, int, 20);
+
+// Lower bound on the hedge delay, so that hosts which answer very quickly are not hedged on
+// every request.
+MONGO_EXPORT_SERVER_PARAMETER(hedgedReadsMinDelayMillis, int, 2);
+
+// Requests to a host are hedged once they take longer than this percentile of its latencies.
+const int kHedgeDelayPercentile = 95;
+
+// The number of attempts made at finding a second host to hedge a request to.
+const int kMaxHedgeHostSelectionAttempts = 3;
+
+Counter64 hedgeEligibleCount;
+Counter64 hedgeSentCount;
+Counter64 hedgeWinCount;
+
+ServerStatusMetricField<Counter64> displayHedgeEligibleCount("hedgedReads.eligible",
+                                                             &hedgeEligibleCount);
+ServerStatusMetricField<Counter64> displayHedgeSentCount("hedgedReads.sent", &hedgeSentCount);
+ServerStatusMetricField<Counter64> displayHedgeWinCount("hedgedReads.wins", &hedgeWinCount);
+
+/**
+ * Keeps the most recent response latencies observed for each host.
+ */
+class HostLatencyTracker {
+public:
+    void record(const HostAndPort& host, Milliseconds latency) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto& samples = _samplesByHost[host];
+        if (samples.latencies.size() < kMaxSamples) {
+            samples.latencies.push_back(latency);
+        } else {
+            samples.latencies[samples.next] = latency;
+        }
+        samples.next = (samples.next + 1) % kMaxSamples;
+    }
+
+    /**
+     * Returns the given percentile of the latencies recorded for 'host', or boost::none if too
+     * few have been recorded for it to be meaningful.
+     */
+    boost::optional<Milliseconds> getPercentile(const HostAndPort& host, int percentile) {
+        std::vector<Milliseconds> latencies;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            auto it = _samplesByHost.find(host);
+            if (it == _samplesByHost.end() || it->second.latencies.size() < kMinSamples) {
+                return boost::none;
+            }
+            latencies = it->second.latencies;
+        }
+
+        auto nth = latencies.begin() + (latencies.size() - 1) * percentile / 100;
+        std::nth_element(latencies.begin(), nth, latencies.end());
+        return *nth;
+    }
+
+private:
+    static constexpr size_t kMaxSamples = 100;
+    static constexpr size_t kMinSamples = 20;
+
+    struct Samples {
+        std::vector<Milliseconds> latencies;
+        size_t next = 0;
+    };
+
+    stdx::mutex _mutex;
+    stdx::unordered_map<HostAndPort, Samples> _samplesByHost;
+};
+
+HostLatencyTracker hostLatencyTracker;
+
+/**
+ * Returns how long a request to 'host' may run before a hedged duplicate of it is sent.
+ */
+Milliseconds getHedgeDelay(const HostAndPort& host) {
+    const Milliseconds minDelay(std::max(0, hedgedReadsMinDelayMillis.load()));
+    auto percentileLatency = hostLatencyTracker.getPercentile(host, kHedgeDelayPercentile);
+    if (!percentileLatency) {
+        return std::max(minDelay, Milliseconds(hedgedReadsDefaultDelayMillis.load()));
+    }
+    return std::max(minDelay, *percentileLatency);
+}
+
+/**
+ * Returns whether 'cmdObj' is a read which may be sent to two hosts at once.
+ */
+bool isHedgeableRead(const ReadPreferenceSetting& readPref, const BSONObj& cmdObj) {
+    if (!enableHedgedReads.load()) {
+        return false;
+    }
+
+    if (readPref.pref != ReadPreference::Nearest &&
+        readPref.pref != ReadPreference::SecondaryPreferred) {
+        return false;
+    }
+
+    const StringData cmdName = cmdObj.firstElementFieldName();
+    if (cmdName == "aggregate") {
+        // A pipeline containing $out writes, so it must only run once.
+        BSONElement pipeline = cmdObj["pipeline"];
+        if (pipeline.type() != Array) {
+            return false;
+        }
+        for (auto&& stage : pipeline.Obj()) {
+            if (stage.type() != Object) {
+                return false;
+            }
+            if (StringData(stage.Obj().firstElementFieldName()) == "$out") {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    return cmdName == "find" || cmdName == "count" || cmdName == "distinct";
+}
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -81,6 +211,25 @@ AsyncRequestsSender::~AsyncRequestsSender() {
     while (!done()) {
         next();
     }
+
+    // A hedged remote's losing request and its hedge timer may outlive the remote's response. They
+    // have been canceled above, but their callbacks still refer to this object, so wait for them.
+    // Waiting on a handle whose callback has already run returns immediately.
+    std::vector<executor::TaskExecutor::CallbackHandle> hedgeCbHandles;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (const auto& remote : _remotes) {
+            for (const auto& cbHandle :
+                 {remote.cbHandle, remote.hedgeTimerCbHandle, remote.hedgeCbHandle}) {
+                if (cbHandle.isValid()) {
+                    hedgeCbHandles.push_back(cbHandle);
+                }
+            }
+        }
+    }
+    for (const auto& cbHandle : hedgeCbHandles) {
+        _executor->wait(cbHandle);
+    }
 }
 
 AsyncRequestsSender::Response AsyncRequestsSender::next() {
@@ -128,6 +277,12 @@ void AsyncRequestsSender::_cancelPendingRequests() {
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        if (remote.hedgeTimerCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeTimerCbHandle);
+        }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
     }
 }
 
@@ -146,10 +301,10 @@ boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
         if (remote.swResponse && !remote.done) {
             remote.done = true;
             if (remote.swResponse->isOK()) {
-                invariant(remote.shardHostAndPort);
+                invariant(remote.getRespondingHostAndPort());
                 return Response(std::move(remote.shardId),
                                 std::move(remote.swResponse->getValue()),
-                                std::move(*remote.shardHostAndPort));
+                                *remote.getRespondingHostAndPort());
             } else {
                 // If _interruptStatus is set, promote CallbackCanceled errors to it.
                 if (!_interruptStatus.isOK() &&
@@ -158,7 +313,7 @@ boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
                 }
                 return Response(std::move(remote.shardId),
                                 std::move(remote.swResponse->getStatus()),
-                                std::move(remote.shardHostAndPort));
+                                remote.getRespondingHostAndPort());
             }
         }
     }
@@ -189,24 +344,28 @@ void AsyncRequestsSender::_scheduleRequests_inlock() {
                         Status(ErrorCodes::ShardNotFound,
                                str::stream() << "Could not find shard " << remote.shardId);
                 } else {
-                    if (remote.shardHostAndPort) {
-                        shard->updateReplSetMonitor(*remote.shardHostAndPort, status);
+                    const auto& respondingHost = remote.getRespondingHostAndPort();
+                    if (respondingHost) {
+                        shard->updateReplSetMonitor(*respondingHost, status);
                     }
                     if (shard->isRetriableError(status.code(), Shard::RetryPolicy::kIdempotent) &&
                         remote.retryCount < kMaxNumFailedHostRetryAttempts) {
                         LOG(1) << "Command to remote " << remote.shardId << " at host "
-                               << *remote.shardHostAndPort
+                               << *respondingHost
                                << " failed with retriable error and will be retried "
                                << causedBy(redact(status));
                         ++remote.retryCount;
                         remote.swResponse.reset();
+                        remote.hedgeHostAndPort.reset();
+                        remote.responseFromHedge = false;
                     }
                 }
             }
         }
 
-        // If the remote does not have a response or pending request, schedule remote work for it.
-        if (!remote.swResponse && !remote.cbHandle.isValid()) {
+        // If the remote does not have a response or pending request, schedule remote work for it. A
+        // hedged remote whose first request failed is still pending until its hedge responds.
+        if (!remote.swResponse && !remote.cbHandle.isValid() && !remote.hedgeCbHandle.isValid()) {
             auto scheduleStatus = _scheduleRequest_inlock(i);
             if (!scheduleStatus.isOK()) {
                 remote.swResponse = std::move(scheduleStatus);
@@ -225,6 +384,7 @@ Status AsyncRequestsSender::_scheduleRequest_inlock(size_t remoteIndex) {
     auto& remote = _remotes[remoteIndex];
 
     invariant(!remote.cbHandle.isValid());
+    invariant(!remote.hedgeCbHandle.isValid());
     invariant(!remote.swResponse);
 
     Status resolveStatus = remote.resolveShardIdToHostAndPort(_readPreference);
@@ -237,26 +397,142 @@ Status AsyncRequestsSender::_scheduleRequest_inlock(size_t remoteIndex) {
 
     auto callbackStatus = _executor->scheduleRemoteCommand(
         request,
-        stdx::bind(
-            &AsyncRequestsSender::_handleResponse, this, stdx::placeholders::_1, remoteIndex));
+        stdx::bind(&AsyncRequestsSender::_handleResponse,
+                   this,
+                   stdx::placeholders::_1,
+                   remoteIndex,
+                   /*isHedge*/ false));
     if (!callbackStatus.isOK()) {
         return callbackStatus.getStatus();
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    remote.requestSentAt = _executor->now();
+    remote.targeter->markHostRequestStarted(*remote.shardHostAndPort);
+
+    if (remote.retryCount == 0 && isHedgeableRead(_readPreference, remote.cmdObj)) {
+        hedgeEligibleCount.increment();
+        _scheduleHedge_inlock(remoteIndex);
+    }
+
     return Status::OK();
 }
 
+void AsyncRequestsSender::_scheduleHedge_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    remote.hedgeHostAndPort = remote.resolveHedgeHostAndPort(_readPreference);
+    if (!remote.hedgeHostAndPort) {
+        return;
+    }
+
+    auto timerStatus = _executor->scheduleWorkAt(
+        remote.requestSentAt + getHedgeDelay(*remote.shardHostAndPort),
+        stdx::bind(
+            &AsyncRequestsSender::_sendHedgedRequest, this, stdx::placeholders::_1, remoteIndex));
+    if (!timerStatus.isOK()) {
+        remote.hedgeHostAndPort.reset();
+        return;
+    }
+
+    remote.hedgeTimerCbHandle = timerStatus.getValue();
+}
+
+void AsyncRequestsSender::_sendHedgedRequest(const executor::TaskExecutor::CallbackArgs& cbData,
+                                             size_t remoteIndex) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto& remote = _remotes[remoteIndex];
+    remote.hedgeTimerCbHandle = executor::TaskExecutor::CallbackHandle();
+
+    // Nothing to do if the timer was canceled or the original request has already completed.
+    if (!cbData.status.isOK() || _stopRetrying || remote.swResponse ||
+        !remote.cbHandle.isValid() || remote.retryCount != 0) {
+        return;
+    }
+
+    executor::RemoteCommandRequest request(
+        *remote.hedgeHostAndPort, _db, remote.cmdObj, _metadataObj, _opCtx);
+
+    auto callbackStatus = _executor->scheduleRemoteCommand(
+        request,
+        stdx::bind(&AsyncRequestsSender::_handleResponse,
+                   this,
+                   stdx::placeholders::_1,
+                   remoteIndex,
+                   /*isHedge*/ true));
+    if (!callbackStatus.isOK()) {
+        return;
+    }
+
+    LOG(1) << "Hedging command to remote " << remote.shardId << " at host "
+           << *remote.shardHostAndPort << " by also sending it to " << *remote.hedgeHostAndPort;
+
+    remote.hedgeCbHandle = callbackStatus.getValue();
+    remote.hedgeSentAt = _executor->now();
+    remote.targeter->markHostRequestStarted(*remote.hedgeHostAndPort);
+    hedgeSentCount.increment();
+}
+
 void AsyncRequestsSender::_handleResponse(
-    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, size_t remoteIndex) {
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
+    size_t remoteIndex,
+    bool isHedge) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     auto& remote = _remotes[remoteIndex];
-    invariant(!remote.swResponse);
 
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
-    // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    // 'remote' on this host.
+    auto& ownCbHandle = isHedge ? remote.hedgeCbHandle : remote.cbHandle;
+    ownCbHandle = executor::TaskExecutor::CallbackHandle();
+
+    const auto& otherCbHandle = isHedge ? remote.cbHandle : remote.hedgeCbHandle;
+    const HostAndPort& host = isHedge ? *remote.hedgeHostAndPort : *remote.shardHostAndPort;
+    remote.targeter->markHostRequestFinished(host);
+
+    if (remote.swResponse) {
+        // The other request for this remote already produced its response.
+        invariant(remote.hedgeHostAndPort);
+        _cleanUpLosingResponse_inlock(cbData, host);
+        return;
+    }
+
+    if (remote.hedgeHostAndPort) {
+        Status status = cbData.response.status;
+        if (status.isOK()) {
+            status = getStatusFromCommandResult(cbData.response.data);
+        }
+
+        if (!status.isOK() && otherCbHandle.isValid()) {
+            // Wait for the other request instead of failing or retrying while it may succeed.
+            if (auto shard = remote.getShard()) {
+                shard->updateReplSetMonitor(host, status);
+            }
+            return;
+        }
+
+        if (otherCbHandle.isValid()) {
+            _executor->cancel(otherCbHandle);
+        }
+        if (remote.hedgeTimerCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeTimerCbHandle);
+        }
+
+        if (isHedge) {
+            remote.responseFromHedge = true;
+            if (status.isOK()) {
+                hedgeWinCount.increment();
+            }
+        }
+    }
+
+    if (cbData.response.isOK() && enableHedgedReads.load()) {
+        const auto sentAt = isHedge ? remote.hedgeSentAt : remote.requestSentAt;
+        hostLatencyTracker.record(
+            host,
+            cbData.response.elapsedMillis.value_or(_executor->now() - sentAt));
+    }
 
     // Store the response or error.
     if (cbData.response.status.isOK()) {
@@ -271,6 +547,34 @@ void AsyncRequestsSender::_handleResponse(
     }
 }
 
+void AsyncRequestsSender::_cleanUpLosingResponse_inlock(
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, const HostAndPort& host) {
+    if (!cbData.response.isOK()) {
+        return;
+    }
+
+    auto swCursorResponse = CursorResponse::parseFromBSON(cbData.response.data);
+    if (!swCursorResponse.isOK() || swCursorResponse.getValue().getCursorId() == 0) {
+        return;
+    }
+
+    const auto& cursorResponse = swCursorResponse.getValue();
+    executor::RemoteCommandRequest request(
+        host,
+        cursorResponse.getNSS().db().toString(),
+        KillCursorsRequest(cursorResponse.getNSS(), {cursorResponse.getCursorId()}).toBSON(),
+        nullptr);
+
+    // This is best effort; a cursor which cannot be killed here is eventually reaped by the
+    // remote's cursor timeout.
+    auto callbackStatus = _executor->scheduleRemoteCommand(
+        request, [](const executor::TaskExecutor::RemoteCommandCallbackArgs&) {});
+    if (!callbackStatus.isOK()) {
+        LOG(1) << "Failed to kill cursor " << cursorResponse.getCursorId() << " on " << host
+               << " left open by a hedged request " << causedBy(redact(callbackStatus.getStatus()));
+    }
+}
+
 AsyncRequestsSender::Request::Request(ShardId shardId, BSONObj cmdObj)
     : shardId(shardId), cmdObj(cmdObj) {}
 
@@ -297,7 +601,9 @@ Status AsyncRequestsSender::RemoteData::resolveShardIdToHostAndPort(
                       str::stream() << "Could not find shard " << shardId);
     }
 
-    auto findHostStatus = shard->getTargeter()->findHostWithMaxWait(readPref, Seconds{20});
+    targeter = shard->getTargeter();
+
+    auto findHostStatus = targeter->findHostWithMaxWait(readPref, Seconds{20});
     if (!findHostStatus.isOK()) {
         return findHostStatus.getStatus();
     }
@@ -307,6 +613,33 @@ Status AsyncRequestsSender::RemoteData::resolveShardIdToHostAndPort(
     return Status::OK();
 }
 
+boost::optional<HostAndPort> AsyncRequestsSender::RemoteData::resolveHedgeHostAndPort(
+    const ReadPreferenceSetting& readPref) {
+    const auto shard = getShard();
+    if (!shard) {
+        return boost::none;
+    }
+
+    // The targeter picks randomly among the eligible members, so a few attempts are enough to
+    // find a second one if it exists.
+    for (int attempt = 0; attempt < kMaxHedgeHostSelectionAttempts; ++attempt) {
+        auto findHostStatus = shard->getTargeter()->findHostNoWait(readPref);
+        if (!findHostStatus.isOK()) {
+            return boost::none;
+        }
+        if (findHostStatus.getValue() != *shardHostAndPort) {
+            return std::move(findHostStatus.getValue());
+        }
+    }
+
+    return boost::none;
+}
+
+const boost::optional<HostAndPort>& AsyncRequestsSender::RemoteData::getRespondingHostAndPort()
+    const {
+    return responseFromHedge ? hedgeHostAndPort : shardHostAndPort;
+}
+
 std::shared_ptr<Shard> AsyncRequestsSender::RemoteData::getShard() {
     // TODO: Pass down an OperationContext* to use here.
     return grid.shardRegistry()->getShardNoReload(shardId);
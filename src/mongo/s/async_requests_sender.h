@@ -50,6 +50,11 @@ namespace mongo {
  * The AsyncRequestsSender allows for sending requests to a set of remote shards in parallel.
  * Work on remote nodes is accomplished by scheduling remote work in a TaskExecutor's event loop.
  *
+ * If the enableHedgedReads server parameter is set, reads with 'nearest' or 'secondaryPreferred'
+ * read preference are hedged: when a remote has not responded within a delay derived from the
+ * recently observed latencies of its host, the same request is also sent to a second eligible
+ * member of the shard. The first successful response is returned and the other request canceled.
+ *
  * Typical usage is:
  *
  * // Add some requests
@@ -173,6 +178,17 @@ private:
          */
         Status resolveShardIdToHostAndPort(const ReadPreferenceSetting& readPref);
 
+        /**
+         * Given a read preference, tries to select a host other than shardHostAndPort on which a
+         * hedged duplicate of the command can be run. Returns boost::none if there is none.
+         */
+        boost::optional<HostAndPort> resolveHedgeHostAndPort(const ReadPreferenceSetting& readPref);
+
+        /**
+         * Returns the host which produced the response in swResponse.
+         */
+        const boost::optional<HostAndPort>& getRespondingHostAndPort() const;
+
         /**
          * Returns the Shard object associated with this remote.
          */
@@ -192,12 +208,35 @@ private:
         // sent.
         boost::optional<HostAndPort> shardHostAndPort;
 
+        // The targeter used to pick shardHostAndPort and hedgeHostAndPort, which is told about
+        // every request sent to and response received from those hosts.
+        std::shared_ptr<RemoteCommandTargeter> targeter;
+
         // The number of times we've retried sending the command to this remote.
         int retryCount = 0;
 
         // The callback handle to an outstanding request for this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
+        // When the outstanding request to shardHostAndPort was sent.
+        Date_t requestSentAt;
+
+        // The second host to which a hedged duplicate of the request is or may be sent. Is unset
+        // if the request is not being hedged.
+        boost::optional<HostAndPort> hedgeHostAndPort;
+
+        // The callback handle to the timer which sends the hedged request when it fires.
+        executor::TaskExecutor::CallbackHandle hedgeTimerCbHandle;
+
+        // The callback handle to an outstanding hedged request for this remote.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+
+        // When the outstanding request to hedgeHostAndPort was sent.
+        Date_t hedgeSentAt;
+
+        // Whether swResponse came from hedgeHostAndPort rather than shardHostAndPort.
+        bool responseFromHedge = false;
+
         // Whether this remote's result has been returned.
         bool done = false;
     };
@@ -238,16 +277,41 @@ private:
      */
     Status _scheduleRequest_inlock(size_t remoteIndex);
 
+    /**
+     * If the request just sent to the remote at 'remoteIndex' may be hedged and the shard has a
+     * second eligible host, schedules a timer that sends the hedged request after the hedge delay
+     * for the first host.
+     */
+    void _scheduleHedge_inlock(size_t remoteIndex);
+
+    /**
+     * The callback for the hedge timer of the remote at 'remoteIndex'. Sends the hedged request
+     * unless the timer was canceled or the remote no longer awaits a response.
+     */
+    void _sendHedgedRequest(const executor::TaskExecutor::CallbackArgs& cbData,
+                            size_t remoteIndex);
+
     /**
      * The callback for a remote command.
      *
      * 'remoteIndex' is the position of the relevant remote node in '_remotes', and therefore
      * indicates which node the response came from and where the response should be buffered.
+     * 'isHedge' tells whether this is the response to the hedged duplicate of the request.
      *
-     * Stores the response or error in the remote and signals the notification.
+     * Stores the response or error in the remote and signals the notification. If the remote has
+     * another request outstanding, an error is dropped in favor of that request's response and a
+     * success cancels that request.
      */
     void _handleResponse(const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
-                         size_t remoteIndex);
+                         size_t remoteIndex,
+                         bool isHedge);
+
+    /**
+     * Releases remote resources held on behalf of a response which lost the race against the
+     * other request sent for the same remote, i.e. kills the cursor it opened, if any.
+     */
+    void _cleanUpLosingResponse_inlock(
+        const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, const HostAndPort& host);
 
     OperationContext* _opCtx;
 
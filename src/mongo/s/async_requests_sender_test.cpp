@@ -0,0 +1,358 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/async_requests_sender.h"
+
+#include "mongo/client/remote_command_targeter_factory_mock.h"
+#include "mongo/client/remote_command_targeter_mock.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/executor/network_interface_mock.h"
+#include "mongo/s/catalog/type_shard.h"
+#include "mongo/s/sharding_test_fixture.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using executor::NetworkInterfaceMock;
+using executor::RemoteCommandResponse;
+
+const NamespaceString kNss("TestDB", "TestColl");
+const ShardId kShardId("shard0");
+const HostAndPort kFirstHost("FakeHost1", 12345);
+const HostAndPort kHedgeHost("FakeHost2", 12345);
+const ShardId kOtherShardId("shard1");
+const HostAndPort kOtherShardHost("FakeHost3", 12345);
+const HostAndPort kConfigHost("FakeConfigHost", 12345);
+
+// The hedge delay of hosts whose latencies have not been observed often enough yet
+const Milliseconds kHedgeDelay{20};
+
+const BSONObj kFindCmd = BSON("find" << kNss.coll());
+
+BSONObj makeCursorResponse(CursorId cursorId) {
+    return CursorResponse(kNss, cursorId, {BSON("x" << 1)})
+        .toBSON(CursorResponse::ResponseType::InitialResponse);
+}
+
+void setHedgedReadsEnabled(bool enabled) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("enableHedgedReads");
+    ASSERT(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString(enabled ? "true" : "false"));
+}
+
+/**
+ * Sends reads to a shard with two eligible hosts, the first of which is picked for the request and
+ * the second of which for its hedged duplicate. Another shard has a single host, so its reads are
+ * never hedged.
+ */
+class AsyncRequestsSenderTest : public ShardingTestFixture {
+protected:
+    void setUp() override {
+        ShardingTestFixture::setUp();
+
+        configTargeter()->setFindHostReturnValue(kConfigHost);
+
+        const auto shardConnString =
+            ConnectionString::forReplicaSet(kShardId.toString(), {kFirstHost, kHedgeHost});
+
+        auto targeter = stdx::make_unique<RemoteCommandTargeterMock>();
+        _targeter = targeter.get();
+        targeter->setConnectionStringReturnValue(shardConnString);
+        targeter->setFindHostsReturnValue({kFirstHost, kHedgeHost});
+        targeterFactory()->addTargeterToReturn(shardConnString, std::move(targeter));
+
+        const auto otherShardConnString =
+            ConnectionString::forReplicaSet(kOtherShardId.toString(), {kOtherShardHost});
+
+        auto otherTargeter = stdx::make_unique<RemoteCommandTargeterMock>();
+        otherTargeter->setConnectionStringReturnValue(otherShardConnString);
+        otherTargeter->setFindHostReturnValue(kOtherShardHost);
+        targeterFactory()->addTargeterToReturn(otherShardConnString, std::move(otherTargeter));
+
+        ShardType shardType;
+        shardType.setName(kShardId.toString());
+        shardType.setHost(shardConnString.toString());
+        ShardType otherShardType;
+        otherShardType.setName(kOtherShardId.toString());
+        otherShardType.setHost(otherShardConnString.toString());
+        setupShards({shardType, otherShardType});
+
+        setHedgedReadsEnabled(true);
+    }
+
+    void tearDown() override {
+        setHedgedReadsEnabled(false);
+        ShardingTestFixture::tearDown();
+    }
+
+    std::unique_ptr<AsyncRequestsSender> makeARS(
+        const ReadPreferenceSetting& readPref = ReadPreferenceSetting(ReadPreference::Nearest),
+        const std::vector<ShardId>& shardIds = {kShardId}) {
+        std::vector<AsyncRequestsSender::Request> requests;
+        for (const auto& shardId : shardIds) {
+            requests.emplace_back(shardId, kFindCmd);
+        }
+        return stdx::make_unique<AsyncRequestsSender>(
+            operationContext(), executor(), kNss.db().toString(), requests, readPref);
+    }
+
+    /**
+     * Returns the next request sent, which must already be ready and be sent to 'target'. Must be
+     * called while in the network.
+     */
+    NetworkInterfaceMock::NetworkOperationIterator expectRequest(const HostAndPort& target) {
+        ASSERT(network()->hasReadyRequests());
+        auto noi = network()->getNextReadyRequest();
+        ASSERT_EQ(target, noi->getRequest().target);
+        return noi;
+    }
+
+    void respond(NetworkInterfaceMock::NetworkOperationIterator noi,
+                 const BSONObj& response,
+                 Date_t when) {
+        network()->scheduleResponse(
+            noi, when, RemoteCommandResponse(response, BSONObj(), Milliseconds(1)));
+    }
+
+    /**
+     * Lets the executor run the callbacks of the requests and timers, which were canceled, so that
+     * the ARS can be destroyed.
+     */
+    void runCanceledCallbacks() {
+        network()->enterNetwork();
+        network()->runReadyNetworkOperations();
+        network()->exitNetwork();
+    }
+
+    void assertNoOutstandingRequests() {
+        ASSERT_EQ(0, _targeter->getNumOutstandingRequests(kFirstHost));
+        ASSERT_EQ(0, _targeter->getNumOutstandingRequests(kHedgeHost));
+    }
+
+    RemoteCommandTargeterMock* _targeter;
+};
+
+TEST_F(AsyncRequestsSenderTest, HedgeIsSentAfterDelayAndFirstResponseWins) {
+    auto ars = makeARS();
+
+    network()->enterNetwork();
+    const auto start = network()->now();
+    auto firstNoi = expectRequest(kFirstHost);
+
+    // The request is not hedged before the delay has elapsed
+    network()->runUntil(start + kHedgeDelay - Milliseconds(1));
+    ASSERT_FALSE(network()->hasReadyRequests());
+
+    network()->runUntil(start + kHedgeDelay);
+    auto hedgeNoi = expectRequest(kHedgeHost);
+    ASSERT_EQ("find", hedgeNoi->getRequest().cmdObj.firstElement().fieldNameStringData());
+    ASSERT_EQ(1, _targeter->getNumOutstandingRequests(kFirstHost));
+    ASSERT_EQ(1, _targeter->getNumOutstandingRequests(kHedgeHost));
+
+    respond(hedgeNoi, makeCursorResponse(0), network()->now());
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    auto response = ars->next();
+    ASSERT_OK(response.swResponse.getStatus());
+    ASSERT_EQ(kHedgeHost, *response.shardHostAndPort);
+    ASSERT(ars->done());
+
+    // The first request was canceled
+    runCanceledCallbacks();
+    ASSERT_EQ(0, _targeter->getNumOutstandingRequests(kFirstHost));
+
+    ars.reset();
+    assertNoOutstandingRequests();
+}
+
+TEST_F(AsyncRequestsSenderTest, CursorOfLosingResponseIsKilled) {
+    auto ars = makeARS();
+
+    network()->enterNetwork();
+    const auto start = network()->now();
+    auto firstNoi = expectRequest(kFirstHost);
+    network()->runUntil(start + kHedgeDelay);
+    auto hedgeNoi = expectRequest(kHedgeHost);
+
+    // The hedged request responds shortly after the first one, before it could be canceled
+    const auto firstResponseAt = network()->now() + Milliseconds(1);
+    const auto hedgeResponseAt = network()->now() + Milliseconds(2);
+    respond(firstNoi, makeCursorResponse(0), firstResponseAt);
+    respond(hedgeNoi, makeCursorResponse(123), hedgeResponseAt);
+    network()->runUntil(hedgeResponseAt);
+
+    auto killNoi = expectRequest(kHedgeHost);
+    ASSERT_EQ("killCursors", killNoi->getRequest().cmdObj.firstElement().fieldNameStringData());
+    ASSERT_EQ(kNss.coll(), killNoi->getRequest().cmdObj.firstElement().String());
+    ASSERT_EQ(123, killNoi->getRequest().cmdObj["cursors"].Array()[0].numberLong());
+    respond(killNoi, BSON("ok" << 1), network()->now());
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    auto response = ars->next();
+    ASSERT_OK(response.swResponse.getStatus());
+    ASSERT_EQ(kFirstHost, *response.shardHostAndPort);
+    ASSERT(ars->done());
+
+    runCanceledCallbacks();
+    ars.reset();
+    assertNoOutstandingRequests();
+}
+
+TEST_F(AsyncRequestsSenderTest, ErrorWaitsForTheOtherRequest) {
+    auto ars = makeARS();
+
+    network()->enterNetwork();
+    const auto start = network()->now();
+    auto firstNoi = expectRequest(kFirstHost);
+    network()->runUntil(start + kHedgeDelay);
+    auto hedgeNoi = expectRequest(kHedgeHost);
+
+    // The first request fails while the hedged one is outstanding, which must not be reported
+    respond(firstNoi,
+            BSON("ok" << 0 << "code" << ErrorCodes::Unauthorized << "errmsg"
+                      << "not authorized"),
+            network()->now());
+    network()->runReadyNetworkOperations();
+    ASSERT_EQ(0, _targeter->getNumOutstandingRequests(kFirstHost));
+    ASSERT_EQ(1, _targeter->getNumOutstandingRequests(kHedgeHost));
+
+    respond(hedgeNoi, makeCursorResponse(0), network()->now());
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    auto response = ars->next();
+    ASSERT_OK(response.swResponse.getStatus());
+    ASSERT_EQ(kHedgeHost, *response.shardHostAndPort);
+    ASSERT(ars->done());
+
+    runCanceledCallbacks();
+    ars.reset();
+    assertNoOutstandingRequests();
+}
+
+TEST_F(AsyncRequestsSenderTest, FailedRequestIsNotResentWhileItsHedgeIsOutstanding) {
+    auto ars = makeARS(ReadPreferenceSetting(ReadPreference::Nearest), {kShardId, kOtherShardId});
+
+    network()->enterNetwork();
+    const auto start = network()->now();
+    auto firstNoi = expectRequest(kFirstHost);
+    auto otherShardNoi = expectRequest(kOtherShardHost);
+    network()->runUntil(start + kHedgeDelay);
+    auto hedgeNoi = expectRequest(kHedgeHost);
+
+    respond(firstNoi,
+            BSON("ok" << 0 << "code" << ErrorCodes::Unauthorized << "errmsg"
+                      << "not authorized"),
+            network()->now());
+    network()->runReadyNetworkOperations();
+    respond(otherShardNoi, makeCursorResponse(0), network()->now());
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    // The other shard's response wakes up the ARS while the first shard only has its hedge left.
+    auto response = ars->next();
+    ASSERT_OK(response.swResponse.getStatus());
+    ASSERT_EQ(kOtherShardId, response.shardId);
+    ASSERT_FALSE(ars->done());
+
+    network()->enterNetwork();
+    ASSERT_FALSE(network()->hasReadyRequests());
+    ASSERT_EQ(0, _targeter->getNumOutstandingRequests(kFirstHost));
+    ASSERT_EQ(1, _targeter->getNumOutstandingRequests(kHedgeHost));
+
+    respond(hedgeNoi, makeCursorResponse(0), network()->now());
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    response = ars->next();
+    ASSERT_OK(response.swResponse.getStatus());
+    ASSERT_EQ(kShardId, response.shardId);
+    ASSERT_EQ(kHedgeHost, *response.shardHostAndPort);
+    ASSERT(ars->done());
+
+    runCanceledCallbacks();
+    ars.reset();
+    assertNoOutstandingRequests();
+}
+
+TEST_F(AsyncRequestsSenderTest, HedgeTimerIsCanceledWhenFirstRequestCompletes) {
+    auto ars = makeARS();
+
+    network()->enterNetwork();
+    const auto start = network()->now();
+    auto firstNoi = expectRequest(kFirstHost);
+    respond(firstNoi, makeCursorResponse(0), network()->now());
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    auto response = ars->next();
+    ASSERT_OK(response.swResponse.getStatus());
+    ASSERT_EQ(kFirstHost, *response.shardHostAndPort);
+    ASSERT(ars->done());
+
+    // No hedged request is sent once the delay elapses
+    network()->enterNetwork();
+    network()->runUntil(start + kHedgeDelay * 2);
+    ASSERT_FALSE(network()->hasReadyRequests());
+    network()->exitNetwork();
+
+    runCanceledCallbacks();
+    ars.reset();
+    assertNoOutstandingRequests();
+}
+
+TEST_F(AsyncRequestsSenderTest, PrimaryReadIsNotHedged) {
+    auto ars = makeARS(ReadPreferenceSetting(ReadPreference::PrimaryOnly));
+
+    network()->enterNetwork();
+    const auto start = network()->now();
+    auto firstNoi = expectRequest(kFirstHost);
+    network()->runUntil(start + kHedgeDelay * 2);
+    ASSERT_FALSE(network()->hasReadyRequests());
+
+    respond(firstNoi, makeCursorResponse(0), network()->now());
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    auto response = ars->next();
+    ASSERT_OK(response.swResponse.getStatus());
+    ASSERT_EQ(kFirstHost, *response.shardHostAndPort);
+
+    ars.reset();
+    assertNoOutstandingRequests();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/repl/optime_with.h"
 #include "mongo/platform/unordered_set.h"
@@ -162,11 +163,14 @@ StatusWith<CachedCollectionRoutingInfo> CatalogCache::getCollectionRoutingInfo(
                                            std::make_shared<Notification<Status>>());
                 _scheduleCollectionRefresh_inlock(
                     dbEntry, std::move(collEntry.routingInfo), nss, 1);
+            } else {
+                _stats.countRefreshesCoalesced.addAndFetch(1);
             }
 
             // Wait on the notification outside of the mutex
             ul.unlock();
 
+            Timer waitTimer;
             auto refreshStatus = [&]() {
                 try {
                     return refreshNotification->get(opCtx);
@@ -174,6 +178,7 @@ StatusWith<CachedCollectionRoutingInfo> CatalogCache::getCollectionRoutingInfo(
                     return ex.toStatus();
                 }
             }();
+            _stats.totalRefreshWaitTimeMicros.addAndFetch(waitTimer.micros());
 
             if (!refreshStatus.isOK()) {
                 return refreshStatus;
@@ -215,6 +220,8 @@ void CatalogCache::onStaleConfigError(CachedCollectionRoutingInfo&& ccriToInvali
     // input argument so it can't be used anymore
     auto ccri(ccriToInvalidate);
 
+    _stats.countStaleConfigErrors.addAndFetch(1);
+
     if (!ccri._cm) {
         // Here we received a stale config error for a collection which we previously thought was
         // unsharded.
@@ -242,7 +249,9 @@ void CatalogCache::onStaleConfigError(CachedCollectionRoutingInfo&& ccriToInvali
         // next call to getCollectionRoutingInfo to return an unsharded collection.
         return;
     } else if (itColl->second.needsRefresh) {
-        // Refresh has been scheduled for the collection already
+        // Refresh has been scheduled for the collection already. It was either started after the
+        // routing table, which turned out to be stale, was installed, or it will be started by the
+        // next get, so it will see at least the version of the stale config error.
         return;
     } else if (itColl->second.routingInfo->getVersion() == ccri._cm->getVersion()) {
         // If the versions match, the last version of the routing information that we used is no
@@ -259,7 +268,12 @@ void CatalogCache::invalidateShardedCollection(const NamespaceString& nss) {
         return;
     }
 
-    it->second->collections[nss.ns()].needsRefresh = true;
+    auto& collEntry = it->second->collections[nss.ns()];
+    if (collEntry.refreshCompletionNotification) {
+        collEntry.refreshAgainOnCompletion = true;
+    }
+
+    collEntry.needsRefresh = true;
 }
 
 void CatalogCache::invalidateShardedCollection(StringData ns) {
@@ -276,6 +290,25 @@ void CatalogCache::purgeAllDatabases() {
     _databases.clear();
 }
 
+void CatalogCache::report(BSONObjBuilder* builder) const {
+    BSONObjBuilder cacheStatsBuilder(builder->subobjStart("catalogCache"));
+
+    size_t numDatabaseEntries;
+    size_t numCollectionEntries{0};
+    {
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
+        numDatabaseEntries = _databases.size();
+        for (const auto& dbEntry : _databases) {
+            numCollectionEntries += dbEntry.second->collections.size();
+        }
+    }
+
+    cacheStatsBuilder.append("numDatabaseEntries", static_cast<long long>(numDatabaseEntries));
+    cacheStatsBuilder.append("numCollectionEntries", static_cast<long long>(numCollectionEntries));
+
+    _stats.report(&cacheStatsBuilder);
+}
+
 std::shared_ptr<CatalogCache::DatabaseInfoEntry> CatalogCache::_getDatabase(OperationContext* opCtx,
                                                                             StringData dbName) {
     stdx::lock_guard<stdx::mutex> lg(_mutex);
@@ -322,11 +355,22 @@ void CatalogCache::_scheduleCollectionRefresh_inlock(
     const ChunkVersion startingCollectionVersion =
         (existingRoutingInfo ? existingRoutingInfo->getVersion() : ChunkVersion::UNSHARDED());
 
+    if (existingRoutingInfo) {
+        _stats.countIncrementalRefreshesStarted.addAndFetch(1);
+    } else {
+        _stats.countFullRefreshesStarted.addAndFetch(1);
+    }
+    _stats.numActiveRefreshes.addAndFetch(1);
+
     const auto refreshFailed_inlock =
         [ this, t, dbEntry, nss, refreshAttempt ](const Status& status) noexcept {
         log() << "Refresh for collection " << nss << " took " << t.millis() << " ms and failed"
               << causedBy(redact(status));
 
+        _stats.numActiveRefreshes.subtractAndFetch(1);
+        _stats.countFailedRefreshes.addAndFetch(1);
+        _stats.totalRefreshTimeMillis.addAndFetch(t.millis());
+
         auto& collections = dbEntry->collections;
         auto it = collections.find(nss.ns());
         invariant(it != collections.end());
@@ -340,6 +384,7 @@ void CatalogCache::_scheduleCollectionRefresh_inlock(
         } else {
             // Leave needsRefresh to true so that any subsequent get attempts will kick off
             // another round of refresh
+            collEntry.refreshAgainOnCompletion = false;
             collEntry.refreshCompletionNotification->set(status);
             collEntry.refreshCompletionNotification = nullptr;
         }
@@ -349,6 +394,11 @@ void CatalogCache::_scheduleCollectionRefresh_inlock(
         [ this, t, dbEntry, nss, existingRoutingInfo, refreshFailed_inlock ](
             OperationContext * opCtx,
             StatusWith<CatalogCacheLoader::CollectionAndChangedChunks> swCollAndChunks) noexcept {
+        if (swCollAndChunks.isOK()) {
+            _stats.countChunksChanged.addAndFetch(
+                swCollAndChunks.getValue().changedChunks.size());
+        }
+
         std::shared_ptr<ChunkManager> newRoutingInfo;
         try {
             newRoutingInfo = refreshCollectionRoutingInfo(
@@ -359,13 +409,21 @@ void CatalogCache::_scheduleCollectionRefresh_inlock(
             return;
         }
 
+        // Walks the whole routing table, so do it before taking the lock
+        const size_t routingTableBytes =
+            newRoutingInfo ? newRoutingInfo->getMemoryUsageBytes() : 0;
+
         stdx::lock_guard<stdx::mutex> lg(_mutex);
         auto& collections = dbEntry->collections;
         auto it = collections.find(nss.ns());
         invariant(it != collections.end());
         auto& collEntry = it->second;
 
-        collEntry.needsRefresh = false;
+        _stats.numActiveRefreshes.subtractAndFetch(1);
+        _stats.totalRefreshTimeMillis.addAndFetch(t.millis());
+
+        collEntry.needsRefresh = collEntry.refreshAgainOnCompletion;
+        collEntry.refreshAgainOnCompletion = false;
         collEntry.refreshCompletionNotification->set(Status::OK());
         collEntry.refreshCompletionNotification = nullptr;
 
@@ -376,7 +434,11 @@ void CatalogCache::_scheduleCollectionRefresh_inlock(
             collections.erase(it);
         } else {
             log() << "Refresh for collection " << nss << " took " << t.millis()
-                  << " ms and found version " << newRoutingInfo->getVersion();
+                  << " ms and found version " << newRoutingInfo->getVersion() << " with "
+                  << newRoutingInfo->numChunks() << " chunks using " << routingTableBytes
+                  << " bytes of routing table ("
+                  << routingTableBytes / std::max(newRoutingInfo->numChunks(), 1)
+                  << " bytes per chunk)";
 
             collEntry.routingInfo = std::move(newRoutingInfo);
         }
@@ -400,6 +462,19 @@ void CatalogCache::_scheduleCollectionRefresh_inlock(
     }
 }
 
+void CatalogCache::Stats::report(BSONObjBuilder* builder) const {
+    builder->append("countStaleConfigErrors", countStaleConfigErrors.load());
+    builder->append("countRefreshesCoalesced", countRefreshesCoalesced.load());
+    builder->append("totalRefreshWaitTimeMicros", totalRefreshWaitTimeMicros.load());
+
+    builder->append("countFullRefreshesStarted", countFullRefreshesStarted.load());
+    builder->append("countIncrementalRefreshesStarted", countIncrementalRefreshesStarted.load());
+    builder->append("numActiveRefreshes", numActiveRefreshes.load());
+    builder->append("countFailedRefreshes", countFailedRefreshes.load());
+    builder->append("totalRefreshTimeMillis", totalRefreshTimeMillis.load());
+    builder->append("countChunksChanged", countChunksChanged.load());
+}
+
 CachedDatabaseInfo::CachedDatabaseInfo(std::shared_ptr<CatalogCache::DatabaseInfoEntry> db)
     : _db(std::move(db)) {}
 
@@ -30,6 +30,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog_cache_loader.h"
 #include "mongo/s/chunk_manager.h"
 #include "mongo/s/chunk_version.h"
@@ -41,6 +42,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class CachedDatabaseInfo;
 class CachedCollectionRoutingInfo;
 class OperationContext;
@@ -117,6 +119,11 @@ public:
      */
     void purgeAllDatabases();
 
+    /**
+     * Reports statistics about the refreshes of the cached routing tables, for serverStatus.
+     */
+    void report(BSONObjBuilder* builder) const;
+
 private:
     // Make the cache entries friends so they can access the private classes below
     friend class CachedDatabaseInfo;
@@ -134,6 +141,12 @@ private:
         // needsRefresh is true)
         std::shared_ptr<Notification<Status>> refreshCompletionNotification;
 
+        // Set if the entry was invalidated while a refresh was already in progress. That refresh
+        // may have read the metadata before the change which caused the invalidation, so the entry
+        // stays in the 'needsRefresh' state after it completes and the next get starts another
+        // (incremental) refresh, which all the concurrent invalidations share.
+        bool refreshAgainOnCompletion{false};
+
         // Contains the cached routing information (only available if needsRefresh is false)
         std::shared_ptr<ChunkManager> routingInfo;
     };
@@ -166,11 +179,48 @@ private:
                                            const NamespaceString& nss,
                                            int refreshAttempt);
 
+    /**
+     * Counters describing the refresh activity of the cache.
+     */
+    struct Stats {
+        // Number of times a stale config error caused a routing table to be marked for refresh
+        AtomicInt64 countStaleConfigErrors;
+
+        // Number of times a get had to wait for a refresh, which was started by another thread
+        AtomicInt64 countRefreshesCoalesced;
+
+        // Cumulative time spent by threads waiting for refreshes to complete
+        AtomicInt64 totalRefreshWaitTimeMicros;
+
+        // Number of refreshes, which built the routing table from scratch
+        AtomicInt64 countFullRefreshesStarted;
+
+        // Number of refreshes, which applied the changed chunks to an existing routing table
+        AtomicInt64 countIncrementalRefreshesStarted;
+
+        // Number of refreshes currently in progress
+        AtomicInt64 numActiveRefreshes;
+
+        // Number of refreshes, which ended with an error
+        AtomicInt64 countFailedRefreshes;
+
+        // Cumulative duration of all the completed refreshes
+        AtomicInt64 totalRefreshTimeMillis;
+
+        // Number of chunks received from the loader by all the refreshes
+        AtomicInt64 countChunksChanged;
+
+        void report(BSONObjBuilder* builder) const;
+    };
+
     // Interface from which chunks will be retrieved
     CatalogCacheLoader& _cacheLoader;
 
+    // Statistics about the refreshes, reported through serverStatus
+    Stats _stats;
+
     // Mutex to serialize access to the structures below
-    stdx::mutex _mutex;
+    mutable stdx::mutex _mutex;
 
     // Map from DB name to the info for that database
     DatabaseInfoMap _databases;
@@ -30,12 +30,14 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
 #include "mongo/s/catalog/type_database.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/catalog_cache_test_fixture.h"
+#include "mongo/s/grid.h"
 
 namespace mongo {
 namespace {
@@ -75,6 +77,12 @@ protected:
             return std::vector<BSONObj>{collType.toBSON()};
         }());
     }
+
+    BSONObj getCatalogCacheStats() {
+        BSONObjBuilder builder;
+        Grid::get(serviceContext())->catalogCache()->report(&builder);
+        return builder.obj()["catalogCache"].Obj().getOwned();
+    }
 };
 
 TEST_F(CatalogCacheRefreshTest, FullLoad) {
@@ -612,5 +620,45 @@ TEST_F(CatalogCacheRefreshTest, IncrementalLoadAfterMoveLastChunk) {
     ASSERT_EQ(version, cm->getVersion({"1"}));
 }
 
+TEST_F(CatalogCacheRefreshTest, IncrementalLoadIsReportedInStatistics) {
+    const ShardKeyPattern shardKeyPattern(BSON("_id" << 1));
+
+    auto initialRoutingInfo(makeChunkManager(kNss, shardKeyPattern, nullptr, true, {}));
+    ASSERT_EQ(1, initialRoutingInfo->numChunks());
+
+    auto stats = getCatalogCacheStats();
+    ASSERT_EQ(1, stats["countFullRefreshesStarted"].numberLong());
+    ASSERT_EQ(0, stats["countIncrementalRefreshesStarted"].numberLong());
+    ASSERT_EQ(1, stats["countChunksChanged"].numberLong());
+
+    ChunkVersion version = initialRoutingInfo->getVersion();
+
+    auto future = scheduleRoutingInfoRefresh(kNss);
+
+    expectGetCollection(version.epoch(), shardKeyPattern);
+    expectFindOnConfigSendBSONObjVector([&]() {
+        version.incMajor();
+        ChunkType chunk1(
+            kNss, {shardKeyPattern.getKeyPattern().globalMin(), BSON("_id" << 0)}, version, {"0"});
+
+        version.incMinor();
+        ChunkType chunk2(
+            kNss, {BSON("_id" << 0), shardKeyPattern.getKeyPattern().globalMax()}, version, {"0"});
+
+        return std::vector<BSONObj>{chunk1.toConfigBSON(), chunk2.toConfigBSON()};
+    }());
+
+    auto routingInfo = future.timed_get(kFutureTimeout);
+    ASSERT_EQ(2, routingInfo->cm()->numChunks());
+
+    stats = getCatalogCacheStats();
+    ASSERT_EQ(1, stats["countFullRefreshesStarted"].numberLong());
+    ASSERT_EQ(1, stats["countIncrementalRefreshesStarted"].numberLong());
+    ASSERT_EQ(0, stats["numActiveRefreshes"].numberLong());
+    ASSERT_EQ(0, stats["countFailedRefreshes"].numberLong());
+    ASSERT_EQ(3, stats["countChunksChanged"].numberLong());
+    ASSERT_EQ(1, stats["numCollectionEntries"].numberLong());
+}
+
 }  // namespace
 }  // namespace mongo
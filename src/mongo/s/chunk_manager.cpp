@@ -32,6 +32,7 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -49,6 +51,9 @@ namespace {
 // Used to generate sequence numbers to assign to each newly created ChunkManager
 AtomicUInt32 nextCMSequenceNumber(0);
 
+// Shard key fields are always ascending
+const Ordering kShardKeyOrdering = Ordering::make(BSONObj());
+
 void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
     for (const auto&& element : o) {
         uassert(ErrorCodes::ConflictingOperationInProgress,
@@ -59,20 +64,64 @@ void checkAllElementsAreOfType(BSONType type, const BSONObj& o) {
 
 }  // namespace
 
+std::string ChunkManager::ChunkKeyIndex::encode(const BSONObj& key) {
+    const KeyString keyString(KeyString::kLatestVersion, key, kShardKeyOrdering);
+    return std::string(keyString.getBuffer(), keyString.getSize());
+}
+
+void ChunkManager::ChunkKeyIndex::reserve(size_t numKeys, size_t numBytes) {
+    _offsets.reserve(numKeys + 1);
+    _buffer.reserve(numBytes);
+}
+
+void ChunkManager::ChunkKeyIndex::append(StringData encodedKey) {
+    _buffer.insert(_buffer.end(), encodedKey.rawData(), encodedKey.rawData() + encodedKey.size());
+    _offsets.push_back(_buffer.size());
+}
+
+size_t ChunkManager::ChunkKeyIndex::upperBound(StringData encodedKey, size_t from) const {
+    size_t low = from;
+    size_t high = size();
+
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        if (encodedKey < get(mid)) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return low;
+}
+
 ChunkManager::ChunkManager(NamespaceString nss,
                            KeyPattern shardKeyPattern,
                            std::unique_ptr<CollatorInterface> defaultCollator,
                            bool unique,
-                           ChunkMap chunkMap,
+                           ChunkVector chunks,
+                           ChunkKeyIndex chunkMaxKeys,
                            ChunkVersion collectionVersion)
     : _sequenceNumber(nextCMSequenceNumber.addAndFetch(1)),
       _nss(std::move(nss)),
       _shardKeyPattern(shardKeyPattern),
       _defaultCollator(std::move(defaultCollator)),
       _unique(unique),
-      _chunkMap(std::move(chunkMap)),
-      _chunkMapViews(_constructChunkMapViews(collectionVersion.epoch(), _chunkMap)),
-      _collectionVersion(collectionVersion) {}
+      _chunks(std::move(chunks)),
+      _chunkMaxKeys(std::move(chunkMaxKeys)),
+      _chunkMapViews(_constructChunkMapViews(collectionVersion.epoch(), _chunks)),
+      _collectionVersion(collectionVersion) {
+    invariant(_chunks.size() == _chunkMaxKeys.size());
+}
+
+size_t ChunkManager::_findChunkPosition(const BSONObj& shardKey) const {
+    const size_t pos = _chunkMaxKeys.upperBound(ChunkKeyIndex::encode(shardKey));
+    if (pos == _chunks.size() || !_chunks[pos]->containsKey(shardKey)) {
+        return _chunks.size();
+    }
+
+    return pos;
+}
 
 std::shared_ptr<Chunk> ChunkManager::findIntersectingChunk(const BSONObj& shardKey,
                                                            const BSONObj& collation) const {
@@ -87,12 +136,12 @@ std::shared_ptr<Chunk> ChunkManager::findIntersectingChunk(const BSONObj& shardK
         }
     }
 
-    const auto it = _chunkMap.upper_bound(shardKey);
+    const size_t pos = _findChunkPosition(shardKey);
     uassert(ErrorCodes::ShardKeyNotFound,
             str::stream() << "Cannot target single shard using key " << shardKey,
-            it != _chunkMap.end() && it->second->containsKey(shardKey));
+            pos != _chunks.size());
 
-    return it->second;
+    return _chunks[pos];
 }
 
 std::shared_ptr<Chunk> ChunkManager::findIntersectingChunkWithSimpleCollation(
@@ -100,6 +149,43 @@ std::shared_ptr<Chunk> ChunkManager::findIntersectingChunkWithSimpleCollation(
     return findIntersectingChunk(shardKey, CollationSpec::kSimpleSpec);
 }
 
+std::vector<std::shared_ptr<Chunk>> ChunkManager::findIntersectingChunksWithSimpleCollation(
+    const std::vector<BSONObj>& shardKeys) const {
+    // Sort the positions of the keys by their KeyString encoding, so that sorting only needs to
+    // compare bytes instead of BSON elements
+    std::vector<std::string> encodedKeys;
+    encodedKeys.reserve(shardKeys.size());
+    for (const auto& shardKey : shardKeys) {
+        encodedKeys.push_back(ChunkKeyIndex::encode(shardKey));
+    }
+
+    std::vector<size_t> sortedPositions(shardKeys.size());
+    for (size_t i = 0; i < sortedPositions.size(); ++i) {
+        sortedPositions[i] = i;
+    }
+    std::sort(sortedPositions.begin(), sortedPositions.end(), [&](size_t lhs, size_t rhs) {
+        return encodedKeys[lhs] < encodedKeys[rhs];
+    });
+
+    // Merge the sorted keys with the chunk max keys. Since both are sorted, the index only needs to
+    // be searched again, starting at the current chunk, once a key reaches the max of that chunk.
+    std::vector<std::shared_ptr<Chunk>> chunks(shardKeys.size());
+    size_t chunkPos = _chunks.size();
+    for (const size_t pos : sortedPositions) {
+        const StringData encodedKey(encodedKeys[pos]);
+        if (chunkPos == _chunks.size() || !(encodedKey < _chunkMaxKeys.get(chunkPos))) {
+            chunkPos = _chunkMaxKeys.upperBound(encodedKey, chunkPos == _chunks.size() ? 0 : chunkPos);
+            uassert(ErrorCodes::ShardKeyNotFound,
+                    str::stream() << "Cannot target single shard using key " << shardKeys[pos],
+                    chunkPos != _chunks.size() && _chunks[chunkPos]->containsKey(shardKeys[pos]));
+        }
+
+        chunks[pos] = _chunks[chunkPos];
+    }
+
+    return chunks;
+}
+
 void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
                                        const BSONObj& query,
                                        const BSONObj& collation,
@@ -167,26 +253,35 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
     // For now, we satisfy that assumption by adding a shard with no matches rather than returning
     // an empty set of shards.
     if (shardIds->empty()) {
-        shardIds->insert(_chunkMapViews.chunkRangeMap.begin()->second.shardId);
+        shardIds->insert(_chunkMapViews.shardChunkRuns.front().shardId);
     }
 }
 
 void ChunkManager::getShardIdsForRange(const BSONObj& min,
                                        const BSONObj& max,
                                        std::set<ShardId>* shardIds) const {
-    auto it = _chunkMapViews.chunkRangeMap.upper_bound(min);
-    auto end = _chunkMapViews.chunkRangeMap.upper_bound(max);
+    const size_t first = _chunkMaxKeys.upperBound(ChunkKeyIndex::encode(min));
+    size_t last = _chunkMaxKeys.upperBound(ChunkKeyIndex::encode(max), first);
 
-    // The chunk range map must always cover the entire key space
-    invariant(it != _chunkMapViews.chunkRangeMap.end());
+    // The chunks must always cover the entire key space
+    invariant(first < _chunks.size());
 
     // We need to include the last chunk
-    if (end != _chunkMapViews.chunkRangeMap.cend()) {
-        ++end;
+    if (last == _chunks.size()) {
+        --last;
     }
 
-    for (; it != end; ++it) {
-        shardIds->insert(it->second.shardId);
+    // Start with the run of chunks, which contains the first chunk
+    const auto& runs = _chunkMapViews.shardChunkRuns;
+    auto it = std::upper_bound(
+        runs.begin(), runs.end(), first, [](size_t chunkPos, const ShardChunkRun& run) {
+            return chunkPos < run.firstChunk;
+        });
+    invariant(it != runs.begin());
+    --it;
+
+    for (; it != runs.end() && it->firstChunk <= last; ++it) {
+        shardIds->insert(it->shardId);
 
         // No need to iterate through the rest of the ranges, because we already know we need to use
         // all shards.
@@ -336,93 +431,79 @@ std::string ChunkManager::toString() const {
     StringBuilder sb;
     sb << "ChunkManager: " << _nss.ns() << " key:" << _shardKeyPattern.toString() << '\n';
 
-    for (const auto& entry : _chunkMap) {
-        sb << "\t" << entry.second->toString() << '\n';
+    for (const auto& chunk : _chunks) {
+        sb << "\t" << chunk->toString() << '\n';
     }
 
     return sb.str();
 }
 
-ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const OID& epoch,
-                                                                  const ChunkMap& chunkMap) {
+size_t ChunkManager::getMemoryUsageBytes() const {
+    size_t size = sizeof(ChunkManager) + _chunks.capacity() * sizeof(ChunkVector::value_type) +
+        _chunkMaxKeys.getMemoryUsageBytes() +
+        _chunkMapViews.shardChunkRuns.capacity() * sizeof(ShardChunkRun);
+
+    for (const auto& chunk : _chunks) {
+        size += sizeof(Chunk) + chunk->getMin().objsize() + chunk->getMax().objsize() +
+            chunk->getShardId().toString().capacity();
+    }
 
-    ChunkRangeMap chunkRangeMap =
-        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ShardAndChunkRange>();
+    return size;
+}
 
+ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const OID& epoch,
+                                                                  const ChunkVector& chunks) {
+    std::vector<ShardChunkRun> shardChunkRuns;
     ShardVersionMap shardVersions;
 
-    ChunkMap::const_iterator current = chunkMap.cbegin();
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const auto& chunk = chunks[i];
+
+        if (i > 0) {
+            // Make sure there are no gaps or overlaps between the chunks
+            const auto& prevChunk = chunks[i - 1];
+            uassert(ErrorCodes::ConflictingOperationInProgress,
+                    str::stream() << "Gap or an overlap between chunks " << chunk->toString()
+                                  << " and "
+                                  << prevChunk->toString(),
+                    SimpleBSONObjComparator::kInstance.evaluate(prevChunk->getMax() ==
+                                                                chunk->getMin()));
+        }
 
-    while (current != chunkMap.cend()) {
-        const auto& firstChunkInRange = current->second;
+        if (shardChunkRuns.empty() || shardChunkRuns.back().shardId != chunk->getShardId()) {
+            shardChunkRuns.push_back(ShardChunkRun{i, chunk->getShardId()});
+        }
 
-        // Tracks the max shard version for the shard on which the current range will reside
-        auto shardVersionIt = shardVersions.find(firstChunkInRange->getShardId());
+        // Tracks the max shard version for the shard on which the chunk resides
+        auto shardVersionIt = shardVersions.find(chunk->getShardId());
         if (shardVersionIt == shardVersions.end()) {
             shardVersionIt =
-                shardVersions.emplace(firstChunkInRange->getShardId(), ChunkVersion(0, 0, epoch))
-                    .first;
+                shardVersions.emplace(chunk->getShardId(), ChunkVersion(0, 0, epoch)).first;
         }
 
         auto& maxShardVersion = shardVersionIt->second;
-
-        current = std::find_if(
-            current,
-            chunkMap.cend(),
-            [&firstChunkInRange, &maxShardVersion](const ChunkMap::value_type& chunkMapEntry) {
-                const auto& currentChunk = chunkMapEntry.second;
-
-                if (currentChunk->getShardId() != firstChunkInRange->getShardId())
-                    return true;
-
-                if (currentChunk->getLastmod() > maxShardVersion)
-                    maxShardVersion = currentChunk->getLastmod();
-
-                return false;
-            });
-
-        const auto rangeLast = std::prev(current);
-
-        const BSONObj rangeMin = firstChunkInRange->getMin();
-        const BSONObj rangeMax = rangeLast->second->getMax();
-
-        const auto oldSize = chunkRangeMap.size();
-        const auto insertIterator = chunkRangeMap.insert(
-            chunkRangeMap.end(),
-            std::make_pair(
-                rangeMax,
-                ShardAndChunkRange{{rangeMin, rangeMax}, firstChunkInRange->getShardId()}));
-        uassert(ErrorCodes::ConflictingOperationInProgress,
-                str::stream() << "Metadata contains two chunks with the same max value "
-                              << rangeMax,
-                oldSize + 1 == chunkRangeMap.size());
-
-
-        if (insertIterator != chunkRangeMap.begin()) {
-            // Make sure there are no gaps in the ranges
-            uassert(ErrorCodes::ConflictingOperationInProgress,
-                    str::stream() << "Gap or an overlap between ranges "
-                                  << insertIterator->second.range.toString()
-                                  << " and "
-                                  << std::prev(insertIterator)->second.range.toString(),
-                    SimpleBSONObjComparator::kInstance.evaluate(std::prev(insertIterator)->first ==
-                                                                rangeMin));
+        if (chunk->getLastmod() > maxShardVersion) {
+            maxShardVersion = chunk->getLastmod();
         }
-
-        // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
-        // somewhere, which should have been caught at chunk load time
-        invariant(maxShardVersion.isSet());
     }
 
-    if (!chunkMap.empty()) {
-        invariant(!chunkRangeMap.empty());
+    if (!chunks.empty()) {
+        invariant(!shardChunkRuns.empty());
         invariant(!shardVersions.empty());
 
-        checkAllElementsAreOfType(MinKey, chunkRangeMap.begin()->second.min());
-        checkAllElementsAreOfType(MaxKey, chunkRangeMap.rbegin()->first);
+        checkAllElementsAreOfType(MinKey, chunks.front()->getMin());
+        checkAllElementsAreOfType(MaxKey, chunks.back()->getMax());
+    }
+
+    // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
+    // somewhere, which should have been caught at chunk load time
+    for (const auto& shardVersion : shardVersions) {
+        invariant(shardVersion.second.isSet());
     }
 
-    return {std::move(chunkRangeMap), std::move(shardVersions)};
+    shardChunkRuns.shrink_to_fit();
+
+    return {std::move(shardChunkRuns), std::move(shardVersions)};
 }
 
 std::shared_ptr<ChunkManager> ChunkManager::makeNew(
@@ -433,20 +514,24 @@ std::shared_ptr<ChunkManager> ChunkManager::makeNew(
     OID epoch,
     const std::vector<ChunkType>& chunks) {
 
-    return ChunkManager(
-               std::move(nss),
-               std::move(shardKeyPattern),
-               std::move(defaultCollator),
-               std::move(unique),
-               SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::shared_ptr<Chunk>>(),
-               {0, 0, epoch})
+    return ChunkManager(std::move(nss),
+                        std::move(shardKeyPattern),
+                        std::move(defaultCollator),
+                        std::move(unique),
+                        ChunkVector(),
+                        ChunkKeyIndex(),
+                        {0, 0, epoch})
         .makeUpdated(chunks);
 }
 
 std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
     const std::vector<ChunkType>& changedChunks) {
     const auto startingCollectionVersion = getVersion();
-    auto chunkMap = _chunkMap;
+
+    // Apply the changes among themselves first, so that only the latest version of a chunk, which
+    // was changed more than once, takes part in the merge with the existing chunks below
+    auto changedChunkMap =
+        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::shared_ptr<Chunk>>();
 
     ChunkVersion collectionVersion = startingCollectionVersion;
     for (const auto& chunk : changedChunks) {
@@ -464,17 +549,17 @@ std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
 
         // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
         // min
-        const auto low = chunkMap.upper_bound(chunk.getMin());
+        const auto low = changedChunkMap.upper_bound(chunk.getMin());
 
         // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
         // not overlap max
-        const auto high = chunkMap.upper_bound(chunk.getMax());
+        const auto high = changedChunkMap.upper_bound(chunk.getMax());
 
         // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
+        changedChunkMap.erase(low, high);
 
         // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunk.getMax(), std::make_shared<Chunk>(chunk)));
+        changedChunkMap.insert(std::make_pair(chunk.getMax(), std::make_shared<Chunk>(chunk)));
     }
 
     // If at least one diff was applied, the metadata is correct, but it might not have changed so
@@ -488,12 +573,50 @@ std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
         return shared_from_this();
     }
 
+    // Merge the changed chunks into the existing ones in a single pass, leaving out the existing
+    // chunks which overlap any changed chunk. The entries and the encoded max keys of the
+    // unchanged chunks are reused as they are.
+    ChunkVector chunks;
+    ChunkKeyIndex chunkMaxKeys;
+    chunks.reserve(_chunks.size() + changedChunkMap.size());
+    chunkMaxKeys.reserve(_chunks.size() + changedChunkMap.size(), _chunkMaxKeys.sizeBytes());
+
+    size_t existingPos = 0;
+    auto changedIt = changedChunkMap.begin();
+
+    while (existingPos < _chunks.size() || changedIt != changedChunkMap.end()) {
+        if (existingPos < _chunks.size()) {
+            const auto& existingChunk = _chunks[existingPos];
+
+            if (changedIt == changedChunkMap.end() ||
+                existingChunk->getMax().woCompare(changedIt->second->getMin()) <= 0) {
+                // The existing chunk is entirely before the next changed chunk
+                chunks.push_back(existingChunk);
+                chunkMaxKeys.append(_chunkMaxKeys.get(existingPos));
+                ++existingPos;
+                continue;
+            }
+
+            if (existingChunk->getMin().woCompare(changedIt->second->getMax()) < 0) {
+                // The existing chunk overlaps the next changed chunk, which replaces it
+                ++existingPos;
+                continue;
+            }
+        }
+
+        // The changed chunk is entirely before the next existing chunk
+        chunks.push_back(changedIt->second);
+        chunkMaxKeys.append(ChunkKeyIndex::encode(changedIt->second->getMax()));
+        ++changedIt;
+    }
+
     return std::shared_ptr<ChunkManager>(
         new ChunkManager(_nss,
                          KeyPattern(getShardKeyPattern().getKeyPattern()),
                          CollatorInterface::cloneCollator(getDefaultCollator()),
                          isUnique(),
-                         std::move(chunkMap),
+                         std::move(chunks),
+                         std::move(chunkMaxKeys),
                          collectionVersion));
 }
 }  // namespace mongo
@@ -31,8 +31,10 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/s/chunk.h"
@@ -47,8 +49,9 @@ class CanonicalQuery;
 struct QuerySolutionNode;
 class OperationContext;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkMap = BSONObjIndexedMap<std::shared_ptr<Chunk>>;
+// Entries describing the chunks of a collection, sorted by the max (and therefore also the min) key
+// of each chunk
+using ChunkVector = std::vector<std::shared_ptr<Chunk>>;
 
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
@@ -63,7 +66,7 @@ public:
     class ConstChunkIterator {
     public:
         ConstChunkIterator() = default;
-        explicit ConstChunkIterator(ChunkMap::const_iterator iter) : _iter{iter} {}
+        explicit ConstChunkIterator(ChunkVector::const_iterator iter) : _iter{iter} {}
 
         ConstChunkIterator& operator++() {
             ++_iter;
@@ -78,12 +81,12 @@ public:
         bool operator!=(const ConstChunkIterator& other) const {
             return !(*this == other);
         }
-        const ChunkMap::mapped_type& operator*() const {
-            return _iter->second;
+        const ChunkVector::value_type& operator*() const {
+            return *_iter;
         }
 
     private:
-        ChunkMap::const_iterator _iter;
+        ChunkVector::const_iterator _iter;
     };
 
     class ConstRangeOfChunks {
@@ -127,6 +130,10 @@ public:
      *
      * The changes in "changedChunks" must be sorted in ascending order by chunk version, and adhere
      * to the requirements of the routing table update algorithm.
+     *
+     * The unchanged chunks and their encoded keys are shared with, or copied from, this instance in
+     * a single merge pass, so the cost of an update does not depend on the number of chunks beyond
+     * that pass.
      */
     std::shared_ptr<ChunkManager> makeUpdated(const std::vector<ChunkType>& changedChunks);
 
@@ -160,13 +167,19 @@ public:
     ChunkVersion getVersion(const ShardId& shardId) const;
 
     ConstRangeOfChunks chunks() const {
-        return {ConstChunkIterator{_chunkMap.cbegin()}, ConstChunkIterator{_chunkMap.cend()}};
+        return {ConstChunkIterator{_chunks.cbegin()}, ConstChunkIterator{_chunks.cend()}};
     }
 
     int numChunks() const {
-        return _chunkMap.size();
+        return _chunks.size();
     }
 
+    /**
+     * Returns an estimate of the memory used by the routing table of this collection, including
+     * the chunk entries and the bounds they reference.
+     */
+    size_t getMemoryUsageBytes() const;
+
     /**
      * Given a shard key (or a prefix) that has been extracted from a document, returns the chunk
      * that contains that key.
@@ -187,6 +200,18 @@ public:
      */
     std::shared_ptr<Chunk> findIntersectingChunkWithSimpleCollation(const BSONObj& shardKey) const;
 
+    /**
+     * Same as findIntersectingChunkWithSimpleCollation, but for a batch of shard keys, which are
+     * all expected to be complete. Returns the intersecting chunks in the order of 'shardKeys'.
+     *
+     * The keys are sorted first, so that the lookups into the routing table only happen for the
+     * first key in each distinct chunk, instead of once for every key.
+     *
+     * Throws a DBException with the ShardKeyNotFound code if any key can not be targeted.
+     */
+    std::vector<std::shared_ptr<Chunk>> findIntersectingChunksWithSimpleCollation(
+        const std::vector<BSONObj>& shardKeys) const;
+
     /**
      * Finds the shard IDs for a given filter and collation. If collation is empty, we use the
      * collection default collation for targeting.
@@ -237,32 +262,73 @@ public:
 
 private:
     /**
-     * Represents a range of chunk keys [getMin(), getMax()) and the id of the shard on which they
-     * reside according to the metadata.
+     * Sorted, flat array of the KeyString encodings of the max keys of the chunks, in the same
+     * order as the chunk vector. The encodings are stored back to back in a single buffer, so
+     * finding the chunk for a key is a binary search with byte comparisons, which does not touch
+     * the chunk entries themselves.
      */
-    struct ShardAndChunkRange {
-        const BSONObj& min() const {
-            return range.getMin();
+    class ChunkKeyIndex {
+    public:
+        ChunkKeyIndex() = default;
+
+        /**
+         * Returns the encoding of 'key', which is comparable with the encodings in the index.
+         */
+        static std::string encode(const BSONObj& key);
+
+        void reserve(size_t numKeys, size_t numBytes);
+
+        /**
+         * Appends an encoded key. The keys must be appended in increasing order, which holds for
+         * the max keys of contiguous chunks.
+         */
+        void append(StringData encodedKey);
+
+        StringData get(size_t pos) const {
+            return StringData(_buffer.data() + _offsets[pos], _offsets[pos + 1] - _offsets[pos]);
         }
 
-        const BSONObj& max() const {
-            return range.getMax();
+        size_t size() const {
+            return _offsets.size() - 1;
         }
 
-        ChunkRange range;
-        ShardId shardId;
+        size_t sizeBytes() const {
+            return _buffer.size();
+        }
+
+        /**
+         * Returns the position of the first key in [from, size()), which is greater than
+         * 'encodedKey', or size() if there is no such key.
+         */
+        size_t upperBound(StringData encodedKey, size_t from = 0) const;
+
+        size_t getMemoryUsageBytes() const {
+            return _buffer.capacity() + _offsets.capacity() * sizeof(uint32_t);
+        }
+
+    private:
+        std::vector<char> _buffer;
+
+        // The key at position i occupies bytes [_offsets[i], _offsets[i + 1]) of the buffer
+        std::vector<uint32_t> _offsets{0};
     };
 
-    using ChunkRangeMap = BSONObjIndexedMap<ShardAndChunkRange>;
+    /**
+     * Represents a run of consecutive chunks, which reside on the same shard according to the
+     * metadata, starting with the chunk at position 'firstChunk' in the chunk vector.
+     */
+    struct ShardChunkRun {
+        size_t firstChunk;
+        ShardId shardId;
+    };
 
     /**
-     * Contains different transformations of the chunk map for efficient querying
+     * Contains different transformations of the chunk vector for efficient querying
      */
     struct ChunkMapViews {
-        // Transformation of the chunk map containing what range of keys reside on which shard. The
-        // index is the max key of the respective range and the union of all ranges in a such
-        // constructed map must cover the complete space from [MinKey, MaxKey).
-        const ChunkRangeMap chunkRangeMap;
+        // Runs of consecutive chunks residing on the same shard, in the order of the chunk vector.
+        // The union of all runs must cover the complete space from [MinKey, MaxKey).
+        const std::vector<ShardChunkRun> shardChunkRuns;
 
         // Map from shard id to the maximum chunk version for that shard. If a shard contains no
         // chunks, it won't be present in this map.
@@ -270,17 +336,25 @@ private:
     };
 
     /**
-     * Does a single pass over the chunkMap and constructs the ChunkMapViews object.
+     * Does a single pass over the chunk vector, validates that the chunks are contiguous and
+     * constructs the ChunkMapViews object.
      */
-    static ChunkMapViews _constructChunkMapViews(const OID& epoch, const ChunkMap& chunkMap);
+    static ChunkMapViews _constructChunkMapViews(const OID& epoch, const ChunkVector& chunks);
 
     ChunkManager(NamespaceString nss,
                  KeyPattern shardKeyPattern,
                  std::unique_ptr<CollatorInterface> defaultCollator,
                  bool unique,
-                 ChunkMap chunkMap,
+                 ChunkVector chunks,
+                 ChunkKeyIndex chunkMaxKeys,
                  ChunkVersion collectionVersion);
 
+    /**
+     * Returns the position in the chunk vector of the chunk, which contains 'shardKey' according
+     * to the chunk max key index, or the number of chunks if there is none.
+     */
+    size_t _findChunkPosition(const BSONObj& shardKey) const;
+
     // The shard versioning mechanism hinges on keeping track of the number of times we reload
     // ChunkManagers.
     const unsigned long long _sequenceNumber;
@@ -297,9 +371,12 @@ private:
     // Whether the sharding key is unique
     const bool _unique;
 
-    // Map from the max for each chunk to an entry describing the chunk. The union of all chunks'
-    // ranges must cover the complete space from [MinKey, MaxKey).
-    const ChunkMap _chunkMap;
+    // Entries describing the chunks, sorted by their max keys. The union of all chunks' ranges
+    // must cover the complete space from [MinKey, MaxKey).
+    const ChunkVector _chunks;
+
+    // KeyString encodings of the max keys of '_chunks', used to search for the chunk of a key
+    const ChunkKeyIndex _chunkMaxKeys;
 
     // Different transformations of the chunk map for efficient querying
     const ChunkMapViews _chunkMapViews;
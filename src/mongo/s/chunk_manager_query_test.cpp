@@ -438,5 +438,80 @@ TEST_F(ChunkManagerQueryTest, SimpleCollationNumbersMultiShard) {
         {ShardId("0")});
 }
 
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunksForUnsortedBatchOfKeys) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(
+        kNss, shardKeyPattern, nullptr, false, {BSON("a" << 10), BSON("a" << 20), BSON("a" << 30)});
+
+    const std::vector<BSONObj> shardKeys{BSON("a" << 25),
+                                         BSON("a" << 5),
+                                         BSON("a" << 30),
+                                         BSON("a" << 10),
+                                         BSON("a" << 7.5),
+                                         BSON("a" << 25),
+                                         BSON("a" << MINKEY),
+                                         BSON("a"
+                                              << "str")};
+    const std::vector<ShardId> expectedShardIds{ShardId("2"),
+                                                ShardId("0"),
+                                                ShardId("3"),
+                                                ShardId("1"),
+                                                ShardId("0"),
+                                                ShardId("2"),
+                                                ShardId("0"),
+                                                ShardId("3")};
+
+    const auto chunks = chunkManager->findIntersectingChunksWithSimpleCollation(shardKeys);
+    ASSERT_EQ(shardKeys.size(), chunks.size());
+    for (size_t i = 0; i < shardKeys.size(); ++i) {
+        ASSERT_EQ(expectedShardIds[i], chunks[i]->getShardId());
+        ASSERT_EQ(chunkManager->findIntersectingChunkWithSimpleCollation(shardKeys[i]),
+                  chunks[i]);
+    }
+}
+
+TEST_F(ChunkManagerQueryTest, FindIntersectingChunksForEmptyBatchOfKeys) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(kNss, shardKeyPattern, nullptr, false, {BSON("a" << 10)});
+
+    ASSERT(chunkManager->findIntersectingChunksWithSimpleCollation({}).empty());
+}
+
+TEST_F(ChunkManagerQueryTest, UpdatedRoutingTableReusesUnchangedChunks) {
+    const ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+    auto chunkManager = makeChunkManager(
+        kNss, shardKeyPattern, nullptr, false, {BSON("a" << 10), BSON("a" << 20), BSON("a" << 30)});
+    ASSERT_GT(chunkManager->getMemoryUsageBytes(), 0U);
+
+    // Split the chunk [10, 20) and move its upper half to shard "3"
+    ChunkVersion version = chunkManager->getVersion();
+    version.incMajor();
+    ChunkType lowerHalf(kNss, ChunkRange(BSON("a" << 10), BSON("a" << 15)), version, ShardId("1"));
+    version.incMinor();
+    ChunkType upperHalf(kNss, ChunkRange(BSON("a" << 15), BSON("a" << 20)), version, ShardId("3"));
+
+    auto updatedChunkManager = chunkManager->makeUpdated({lowerHalf, upperHalf});
+    ASSERT_EQ(5, updatedChunkManager->numChunks());
+    ASSERT_EQ(version, updatedChunkManager->getVersion());
+
+    for (const auto& key : {BSON("a" << 5), BSON("a" << 25), BSON("a" << 35)}) {
+        ASSERT_EQ(chunkManager->findIntersectingChunkWithSimpleCollation(key),
+                  updatedChunkManager->findIntersectingChunkWithSimpleCollation(key));
+    }
+
+    ASSERT_EQ(ShardId("1"),
+              updatedChunkManager->findIntersectingChunkWithSimpleCollation(BSON("a" << 12))
+                  ->getShardId());
+    ASSERT_EQ(ShardId("3"),
+              updatedChunkManager->findIntersectingChunkWithSimpleCollation(BSON("a" << 15))
+                  ->getShardId());
+
+    std::set<ShardId> shardIds;
+    updatedChunkManager->getShardIdsForRange(BSON("a" << 12), BSON("a" << 17), &shardIds);
+    ASSERT_EQ(2U, shardIds.size());
+    ASSERT_EQ(1U, shardIds.count(ShardId("1")));
+    ASSERT_EQ(1U, shardIds.count(ShardId("3")));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -58,6 +58,14 @@ public:
                 static_cast<long long>(stats.cursorsMultiTarget + stats.cursorsSingleTarget));
             openBob.doneFast();
         }
+        {
+            BSONObjBuilder lockBob(cursorBob.subobjStart("lockStats"));
+            auto stats = grid.getCursorManager()->stats();
+            lockBob.append("acquisitions", stats.lockAcquisitions);
+            lockBob.append("waits", stats.lockWaits);
+            lockBob.append("totalWaitMicros", stats.lockWaitMicros);
+            lockBob.doneFast();
+        }
         cursorBob.done();
     }
 
@@ -279,26 +279,11 @@ Status ChunkManagerTargeter::targetInsert(OperationContext* opCtx,
     BSONObj shardKey;
 
     if (_routingInfo->cm()) {
-        //
-        // Sharded collections have the following requirements for targeting:
-        //
-        // Inserts must contain the exact shard key.
-        //
-
-        shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
+        auto swShardKey = extractShardKeyForInsert(doc);
+        if (!swShardKey.isOK())
+            return swShardKey.getStatus();
 
-        // Check shard key exists
-        if (shardKey.isEmpty()) {
-            return {ErrorCodes::ShardKeyNotFound,
-                    str::stream() << "document " << doc
-                                  << " does not contain shard key for pattern "
-                                  << _routingInfo->cm()->getShardKeyPattern().toString()};
-        }
-
-        // Check shard key size on insert
-        Status status = ShardKeyPattern::checkShardKeySize(shardKey);
-        if (!status.isOK())
-            return status;
+        shardKey = std::move(swShardKey.getValue());
     }
 
     // Target the shard key or database primary
@@ -317,6 +302,73 @@ Status ChunkManagerTargeter::targetInsert(OperationContext* opCtx,
     return Status::OK();
 }
 
+std::vector<StatusWith<ShardEndpoint>> ChunkManagerTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    if (!_routingInfo->cm()) {
+        return NSTargeter::targetInserts(opCtx, docs);
+    }
+
+    std::vector<StatusWith<ShardEndpoint>> endpoints(
+        docs.size(), Status(ErrorCodes::InternalError, "document was not targeted"));
+
+    // Only the documents with a valid shard key take part in the chunk lookup
+    std::vector<BSONObj> shardKeys;
+    std::vector<size_t> shardKeyDocs;
+    shardKeys.reserve(docs.size());
+    shardKeyDocs.reserve(docs.size());
+
+    for (size_t i = 0; i < docs.size(); ++i) {
+        auto swShardKey = extractShardKeyForInsert(docs[i]);
+        if (!swShardKey.isOK()) {
+            endpoints[i] = swShardKey.getStatus();
+            continue;
+        }
+
+        shardKeys.push_back(std::move(swShardKey.getValue()));
+        shardKeyDocs.push_back(i);
+    }
+
+    const auto chunks = _routingInfo->cm()->findIntersectingChunksWithSimpleCollation(shardKeys);
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const auto& chunk = chunks[i];
+        const auto& doc = docs[shardKeyDocs[i]];
+
+        // Track autosplit stats for sharded collections
+        // Note: this is only best effort accounting and is not accurate.
+        _stats->chunkSizeDelta[chunk->getMin()] += doc.objsize();
+
+        endpoints[shardKeyDocs[i]] = ShardEndpoint(
+            chunk->getShardId(), _routingInfo->cm()->getVersion(chunk->getShardId()));
+    }
+
+    return endpoints;
+}
+
+StatusWith<BSONObj> ChunkManagerTargeter::extractShardKeyForInsert(const BSONObj& doc) const {
+    //
+    // Sharded collections have the following requirements for targeting:
+    //
+    // Inserts must contain the exact shard key.
+    //
+
+    BSONObj shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
+
+    // Check shard key exists
+    if (shardKey.isEmpty()) {
+        return {ErrorCodes::ShardKeyNotFound,
+                str::stream() << "document " << doc << " does not contain shard key for pattern "
+                              << _routingInfo->cm()->getShardKeyPattern().toString()};
+    }
+
+    // Check shard key size on insert
+    Status status = ShardKeyPattern::checkShardKeySize(shardKey);
+    if (!status.isOK())
+        return status;
+
+    return shardKey;
+}
+
 Status ChunkManagerTargeter::targetUpdate(
     OperationContext* opCtx,
     const write_ops::UpdateOpEntry& updateDoc,
@@ -80,6 +80,11 @@ public:
                         const BSONObj& doc,
                         ShardEndpoint** endpoint) const;
 
+    // Extracts the shard keys of all the documents first and then looks up their chunks as one
+    // sorted batch.
+    std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const override;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     Status targetUpdate(OperationContext* opCtx,
                         const write_ops::UpdateOpEntry& updateDoc,
@@ -117,6 +122,12 @@ private:
      */
     Status refreshNow(OperationContext* opCtx);
 
+    /**
+     * Returns the shard key of a document to insert into a sharded collection, or
+     * ShardKeyNotFound if the document does not contain the full shard key.
+     */
+    StatusWith<BSONObj> extractShardKeyForInsert(const BSONObj& doc) const;
+
     /**
      * Returns a vector of ShardEndpoints where a document might need to be placed.
      *
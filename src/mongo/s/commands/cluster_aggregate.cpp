@@ -415,7 +415,8 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
     // any $lookups, etc. will be able to have a resolved view definition. It's okay that this is
     // incorrect, we will repopulate the real resolved namespace map on the mongod. Note that we
     // need to check if any involved collections are sharded before forwarding an aggregation
-    // command on an unsharded collection.
+    // command on an unsharded collection. A sharded involved collection is only accepted if every
+    // stage reading from it is able to query the shards that own it.
     StringMap<ExpressionContext::ResolvedNamespace> resolvedNamespaces;
     LiteParsedPipeline liteParsedPipeline(request);
 
@@ -427,8 +428,10 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
     for (auto&& nss : liteParsedPipeline.getInvolvedNamespaces()) {
         const auto resolvedNsRoutingInfo =
             uassertStatusOK(catalogCache->getCollectionRoutingInfo(opCtx, nss));
-        uassert(
-            28769, str::stream() << nss.ns() << " cannot be sharded", !resolvedNsRoutingInfo.cm());
+        uassert(28769,
+                str::stream() << nss.ns() << " cannot be sharded",
+                !resolvedNsRoutingInfo.cm() ||
+                    liteParsedPipeline.allowShardedForeignCollection(nss));
         resolvedNamespaces.try_emplace(nss.coll(), nss, std::vector<BSONObj>{});
     }
 
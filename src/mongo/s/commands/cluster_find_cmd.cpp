@@ -218,6 +218,7 @@ public:
 
         // Build the response document.
         CursorResponseBuilder firstBatch(/*firstBatch*/ true, &result);
+        firstBatch.reserveForBatch(batch);
         for (const auto& obj : batch) {
             firstBatch.append(obj);
         }
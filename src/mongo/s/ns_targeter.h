@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/namespace_string.h"
@@ -88,6 +89,16 @@ public:
                                 const BSONObj& doc,
                                 ShardEndpoint** endpoint) const = 0;
 
+    /**
+     * Returns a ShardEndpoint for each document of a batch of single document writes, in the
+     * order of 'docs'. Each document is targeted independently of the others and the result for
+     * a document which could not be targeted is the error status targetInsert would return.
+     *
+     * The default implementation calls targetInsert for each document.
+     */
+    virtual std::vector<StatusWith<ShardEndpoint>> targetInserts(
+        OperationContext* opCtx, const std::vector<BSONObj>& docs) const;
+
     /**
      * Returns a vector of ShardEndpoints for a potentially multi-shard update.
      *
@@ -168,4 +179,24 @@ struct ShardEndpoint {
     ChunkVersion shardVersion;
 };
 
+inline std::vector<StatusWith<ShardEndpoint>> NSTargeter::targetInserts(
+    OperationContext* opCtx, const std::vector<BSONObj>& docs) const {
+    std::vector<StatusWith<ShardEndpoint>> endpoints;
+    endpoints.reserve(docs.size());
+
+    for (const auto& doc : docs) {
+        ShardEndpoint* endpoint = nullptr;
+        Status status = targetInsert(opCtx, doc, &endpoint);
+        if (!status.isOK()) {
+            endpoints.emplace_back(std::move(status));
+            continue;
+        }
+
+        std::unique_ptr<ShardEndpoint> endpointOwned(endpoint);
+        endpoints.emplace_back(*endpointOwned);
+    }
+
+    return endpoints;
+}
+
 }  // namespace mongo
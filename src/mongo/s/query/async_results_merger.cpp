@@ -32,10 +32,13 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include <algorithm>
+
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/client/shard_registry.h"
@@ -50,6 +53,14 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Smallest batchSize requested by a read-ahead getMore, so that a remote which has only just
+// started being consumed does not get flooded with tiny requests.
+const long long kMinPrefetchBatchSize = 16;
+
+// Per-remote budget, in bytes, of results the ARM may buffer ahead of the caller. Zero disables
+// read-ahead, in which case getMores are only issued once a remote's buffer is empty.
+MONGO_EXPORT_SERVER_PARAMETER(asyncResultsMergerPrefetchBufferBytes, int, 0);
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -58,7 +69,8 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
     : _opCtx(opCtx),
       _executor(executor),
       _params(params),
-      _mergeQueue(MergingComparator(_remotes, _params->sort)) {
+      _mergeQueue(MergingComparator(_remotes, _params->sort)),
+      _prefetchBufferBytes(std::max(0, asyncResultsMergerPrefetchBufferBytes.load())) {
     size_t remoteIndex = 0;
     for (const auto& remote : _params->remotes) {
         _remotes.emplace_back(remote.hostAndPort,
@@ -82,6 +94,15 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
 AsyncResultsMerger::~AsyncResultsMerger() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     invariant(remotesExhausted_inlock() || _lifecycleState == kKillComplete);
+
+    if (shouldLog(logger::LogSeverity::Debug(2))) {
+        for (const auto& remote : _remotes) {
+            LOG(2) << "Remote cursor " << remote.cursorNss.ns() << " on "
+                   << remote.shardHostAndPort << ": " << remote.numGetMores << " getMores ("
+                   << remote.numPrefetchGetMores << " read-ahead), waited "
+                   << remote.waitTime;
+        }
+    }
 }
 
 bool AsyncResultsMerger::remotesExhausted() {
@@ -117,6 +138,7 @@ bool AsyncResultsMerger::ready() {
 }
 
 void AsyncResultsMerger::detachFromOperationContext() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
     _opCtx = nullptr;
     // If we were about ready to return a boost::none because a tailable cursor reached the end of
     // the batch, that should no longer apply to the next use - when we are reattached to a
@@ -126,6 +148,7 @@ void AsyncResultsMerger::detachFromOperationContext() {
 }
 
 void AsyncResultsMerger::reattachToOperationContext(OperationContext* opCtx) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
     invariant(!_opCtx);
     _opCtx = opCtx;
 }
@@ -215,8 +238,7 @@ ClusterQueryResult AsyncResultsMerger::nextReadySorted() {
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    ClusterQueryResult front = popFromBuffer_inlock(smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -234,8 +256,7 @@ ClusterQueryResult AsyncResultsMerger::nextReadyUnsorted() {
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            ClusterQueryResult front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            ClusterQueryResult front = popFromBuffer_inlock(_gettingFromRemote);
 
             if (_params->isTailable && !_remotes[_gettingFromRemote].hasNext()) {
                 // The cursor is tailable and we're about to return the last buffered result. This
@@ -257,7 +278,64 @@ ClusterQueryResult AsyncResultsMerger::nextReadyUnsorted() {
     return {};
 }
 
-Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
+ClusterQueryResult AsyncResultsMerger::popFromBuffer_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    ClusterQueryResult front = std::move(remote.docBuffer.front());
+    remote.docBuffer.pop();
+    if (auto result = front.getResult()) {
+        remote.bufferedBytes -= result->objsize();
+    }
+    ++remote.consumedSinceLastRequest;
+
+    maybePrefetch_inlock(remoteIndex);
+    return front;
+}
+
+void AsyncResultsMerger::maybePrefetch_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    // Read-ahead is only done on behalf of an attached caller, so that the getMore carries that
+    // operation's metadata. Tailable cursors are excluded, because each of their batches must be
+    // passed through to the client before the next one is requested.
+    if (!_prefetchBufferBytes || !_opCtx || _params->isTailable || _lifecycleState != kAlive) {
+        return;
+    }
+
+    if (!remote.status.isOK() || remote.exhausted() || remote.cbHandle.isValid()) {
+        return;
+    }
+
+    // Only refill once the buffer has drained below half of its budget, so that a steadily
+    // consumed remote sees a few well-sized getMores rather than one per consumed result.
+    if (remote.bufferedBytes >= _prefetchBufferBytes / 2) {
+        return;
+    }
+
+    remote.status = askForNextBatch_inlock(remoteIndex, true /* isPrefetch */);
+}
+
+long long AsyncResultsMerger::prefetchBatchSize_inlock(const RemoteCursorData& remote) const {
+    // Ask for twice what the caller consumed during the previous round trip, which lets the batch
+    // size grow geometrically for a fast consumer and shrink again for a slow one.
+    long long batchSize = std::max(kMinPrefetchBatchSize, 2 * remote.consumedSinceLastRequest);
+
+    if (remote.fetchedCount > 0) {
+        const long long avgDocBytes = std::max(1LL, remote.fetchedBytes / remote.fetchedCount);
+        const long long budgetDocs =
+            std::max(1LL, (_prefetchBufferBytes - remote.bufferedBytes) / avgDocBytes);
+        batchSize = std::min(batchSize, budgetDocs);
+    }
+
+    // Never ask for more than the client itself asked for.
+    if (_params->batchSize) {
+        batchSize = std::min(batchSize, *_params->batchSize);
+    }
+
+    return batchSize;
+}
+
+Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex, bool isPrefetch) {
     auto& remote = _remotes[remoteIndex];
 
     invariant(!remote.cbHandle.isValid());
@@ -270,6 +348,9 @@ Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
     if (_params->batchSize && *_params->batchSize > remote.fetchedCount) {
         adjustedBatchSize = *_params->batchSize - remote.fetchedCount;
     }
+    if (isPrefetch) {
+        adjustedBatchSize = prefetchBatchSize_inlock(remote);
+    }
 
     BSONObj cmdObj = GetMoreRequest(remote.cursorNss,
                                     remote.cursorId,
@@ -291,6 +372,12 @@ Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    remote.requestSentAt = _executor->now();
+    remote.consumedSinceLastRequest = 0;
+    ++remote.numGetMores;
+    if (isPrefetch) {
+        ++remote.numPrefetchGetMores;
+    }
     return Status::OK();
 }
 
@@ -342,6 +429,7 @@ StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent()
     }
     auto eventToReturn = eventStatus.getValue();
     _currentEvent = eventToReturn;
+    _waitStartedAt = _executor->now();
 
     // It's possible that after we told the caller we had no ready results but before we replaced
     // _currentEvent with a new event, new results became available. In this case we have to signal
@@ -381,6 +469,16 @@ void AsyncResultsMerger::handleBatchResponse(
     // 'remote'.
     remote.cbHandle = executor::TaskExecutor::CallbackHandle();
 
+    // If the caller is blocked on '_currentEvent', it has been waiting on this remote for as long
+    // as both the request and the wait have been outstanding.
+    if (_currentEvent.isValid()) {
+        const auto now = _executor->now();
+        const auto waitStart = std::max(remote.requestSentAt, _waitStartedAt);
+        if (now > waitStart) {
+            remote.waitTime += now - waitStart;
+        }
+    }
+
     // If we're in the process of shutting down then there's no need to process the batch.
     if (_lifecycleState != kAlive) {
         invariant(_lifecycleState == kKillStarted);
@@ -422,6 +520,7 @@ void AsyncResultsMerger::handleBatchResponse(
             // Clear the results buffer and cursor id.
             std::queue<ClusterQueryResult> emptyBuffer;
             std::swap(remote.docBuffer, emptyBuffer);
+            remote.bufferedBytes = 0;
             remote.cursorId = 0;
         }
 
@@ -460,6 +559,12 @@ void AsyncResultsMerger::handleBatchResponse(
         }
     }
 
+    // Otherwise keep reading ahead while the caller is consuming and the buffer is not yet full.
+    maybePrefetch_inlock(remoteIndex);
+    if (!remote.status.isOK()) {
+        return;
+    }
+
     // ScopeGuard requires dismiss on success, but we want waiter to be signalled on success as
     // well as failure.
     signaller.Dismiss();
@@ -468,6 +573,7 @@ void AsyncResultsMerger::handleBatchResponse(
 
 bool AsyncResultsMerger::addBatchToBuffer(size_t remoteIndex, const std::vector<BSONObj>& batch) {
     auto& remote = _remotes[remoteIndex];
+    const bool wasBufferEmpty = remote.docBuffer.empty();
     for (const auto& obj : batch) {
         // If there's a sort, we're expecting the remote node to have given us back a sort key.
         if (!_params->sort.isEmpty() &&
@@ -483,11 +589,14 @@ bool AsyncResultsMerger::addBatchToBuffer(size_t remoteIndex, const std::vector<
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
+        remote.fetchedBytes += obj.objsize();
+        remote.bufferedBytes += obj.objsize();
     }
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the
-    // merge queue.
-    if (!_params->sort.isEmpty() && !batch.empty()) {
+    // merge queue. A remote with buffered results is already on the queue, which is the case when
+    // a read-ahead batch arrives before the previous one was consumed.
+    if (!_params->sort.isEmpty() && wasBufferEmpty && !batch.empty()) {
         _mergeQueue.push(remoteIndex);
     }
     return true;
@@ -579,6 +688,24 @@ executor::TaskExecutor::EventHandle AsyncResultsMerger::kill(OperationContext* o
     return _killCursorsScheduledEvent;
 }
 
+std::vector<AsyncResultsMerger::RemoteCursorStats> AsyncResultsMerger::getRemoteCursorStats() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    std::vector<RemoteCursorStats> stats;
+    stats.reserve(_remotes.size());
+    for (const auto& remote : _remotes) {
+        RemoteCursorStats remoteStats;
+        remoteStats.host = remote.shardHostAndPort;
+        remoteStats.numGetMores = remote.numGetMores;
+        remoteStats.numPrefetchGetMores = remote.numPrefetchGetMores;
+        remoteStats.bufferedBytes = remote.bufferedBytes;
+        remoteStats.waitTime = remote.waitTime;
+        stats.push_back(std::move(remoteStats));
+    }
+
+    return stats;
+}
+
 //
 // AsyncResultsMerger::RemoteCursorData
 //
@@ -66,6 +66,12 @@ class CursorResponse;
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * If the 'asyncResultsMergerPrefetchBufferBytes' server parameter is non-zero, the ARM also reads
+ * ahead on non-tailable cursors: whenever a remote's buffered results drop below half of that
+ * budget while the caller is consuming them, a getMore is issued in the background so that the
+ * next batch is already in flight by the time the buffer runs dry. The size of these read-ahead
+ * batches adapts to the rate at which results from that remote are being consumed.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -74,6 +80,25 @@ class AsyncResultsMerger {
     MONGO_DISALLOW_COPYING(AsyncResultsMerger);
 
 public:
+    /**
+     * Statistics about the communication with a single remote cursor, reported for diagnostics.
+     */
+    struct RemoteCursorStats {
+        HostAndPort host;
+
+        // Total number of getMore requests sent to the remote, including read-ahead requests.
+        long long numGetMores = 0;
+
+        // Number of getMore requests which were issued ahead of demand.
+        long long numPrefetchGetMores = 0;
+
+        // Size of the results currently buffered from this remote.
+        long long bufferedBytes = 0;
+
+        // Total time the caller spent blocked waiting for a response from this remote.
+        Milliseconds waitTime{0};
+    };
+
     /**
      * Takes ownership of the cursors from ClusterClientCursorParams by storing their cursorIds and
      * the hosts on which they exist in _remotes.
@@ -195,6 +220,12 @@ public:
      */
     executor::TaskExecutor::EventHandle kill(OperationContext* opCtx);
 
+    /**
+     * Returns per-remote statistics in the same order as the remotes in the
+     * ClusterClientCursorParams.
+     */
+    std::vector<RemoteCursorStats> getRemoteCursorStats();
+
 private:
     /**
      * We instantiate one of these per remote host. It contains the buffer of results we've
@@ -252,6 +283,23 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // Total size of all documents ever fetched from this remote. Together with 'fetchedCount'
+        // gives the average document size used to size read-ahead batches.
+        long long fetchedBytes = 0;
+
+        // Size of the documents currently held in 'docBuffer'.
+        long long bufferedBytes = 0;
+
+        // Number of results handed out from this remote since the last getMore was scheduled.
+        long long consumedSinceLastRequest = 0;
+
+        // When the currently outstanding request (if any) was scheduled.
+        Date_t requestSentAt;
+
+        long long numGetMores = 0;
+        long long numPrefetchGetMores = 0;
+        Milliseconds waitTime{0};
     };
 
     class MergingComparator {
@@ -289,9 +337,32 @@ private:
      * The 'remoteIndex' gives the position of the remote node from which we are retrieving the
      * batch in '_remotes'.
      *
+     * If 'isPrefetch' is true, the batch is being requested ahead of demand and its size is
+     * chosen by prefetchBatchSize_inlock() rather than taken from the cursor parameters.
+     *
      * Returns success if the command to retrieve the next batch was scheduled successfully.
      */
-    Status askForNextBatch_inlock(size_t remoteIndex);
+    Status askForNextBatch_inlock(size_t remoteIndex, bool isPrefetch = false);
+
+    /**
+     * Schedules a read-ahead getMore on the given remote if read-ahead is enabled, the remote has
+     * no outstanding request and its buffered results are below the low watermark. An error
+     * scheduling the request is stored in the remote's status.
+     */
+    void maybePrefetch_inlock(size_t remoteIndex);
+
+    /**
+     * Returns the batchSize to use for a read-ahead getMore on 'remote', based on how many results
+     * were consumed from it since its last request and how many of its average-sized documents
+     * still fit in the per-remote buffer budget.
+     */
+    long long prefetchBatchSize_inlock(const RemoteCursorData& remote) const;
+
+    /**
+     * Removes and returns the first buffered result of the given remote, updating the buffer
+     * accounting and possibly triggering read-ahead.
+     */
+    ClusterQueryResult popFromBuffer_inlock(size_t remoteIndex);
 
     /**
      * Checks whether or not the remote cursors are all exhausted.
@@ -381,6 +452,14 @@ private:
 
     boost::optional<Milliseconds> _awaitDataTimeout;
 
+    // Per-remote read-ahead buffer budget, captured from the server parameter at construction.
+    // Zero disables read-ahead.
+    const long long _prefetchBufferBytes;
+
+    // When the caller last started waiting on '_currentEvent'. Used to attribute wait time to the
+    // remotes whose responses were outstanding.
+    Date_t _waitStartedAt;
+
     //
     // Killing
     //
@@ -36,6 +36,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface_mock.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/executor/thread_pool_task_executor_test_fixture.h"
@@ -44,6 +45,7 @@
 #include "mongo/s/sharding_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -1212,6 +1214,104 @@ TEST_F(AsyncResultsMergerTest, GetMoreBatchSizes) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, PrefetchesNextBatchWhileConsuming) {
+    auto prefetchParam =
+        ServerParameterSet::getGlobal()->getMap().find("asyncResultsMergerPrefetchBufferBytes");
+    ASSERT(prefetchParam != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(prefetchParam->second->setFromString("1024"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(prefetchParam->second->setFromString("0")); });
+
+    std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
+    std::vector<BSONObj> firstBatch = {fromjson("{_id: 1}"), fromjson("{_id: 2}")};
+    cursors.emplace_back(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(_nss, 1, std::move(firstBatch)));
+    makeCursorFromExistingCursors(std::move(cursors));
+
+    // Consuming the first result drains the buffer below the low watermark, so the next batch is
+    // requested before the caller runs out of results.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()).getResult());
+
+    BSONObj scheduledCmd = getFirstPendingRequest().cmdObj;
+    auto request = GetMoreRequest::parseFromBSON("anydbname", scheduledCmd);
+    ASSERT_OK(request.getStatus());
+    ASSERT_EQ(request.getValue().cursorid, 1LL);
+    ASSERT_EQ(*request.getValue().batchSize, 16LL);
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{_id: 3}")};
+    responses.emplace_back(_nss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 3}"), *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+
+    auto stats = arm->getRemoteCursorStats();
+    ASSERT_EQ(1U, stats.size());
+    ASSERT_EQ(kTestShardHosts[0], stats[0].host);
+    ASSERT_EQ(1, stats[0].numGetMores);
+    ASSERT_EQ(1, stats[0].numPrefetchGetMores);
+    ASSERT_EQ(0, stats[0].bufferedBytes);
+    ASSERT_EQ(Milliseconds(0), stats[0].waitTime);
+}
+
+TEST_F(AsyncResultsMergerTest, SortedPrefetchDoesNotRequeueBufferedRemote) {
+    auto prefetchParam =
+        ServerParameterSet::getGlobal()->getMap().find("asyncResultsMergerPrefetchBufferBytes");
+    ASSERT(prefetchParam != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(prefetchParam->second->setFromString("1024"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(prefetchParam->second->setFromString("0")); });
+
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
+    std::vector<BSONObj> firstBatch = {fromjson("{$sortKey: {'': 5}}"),
+                                       fromjson("{$sortKey: {'': 6}}")};
+    cursors.emplace_back(
+        kTestShardIds[0], kTestShardHosts[0], CursorResponse(_nss, 1, std::move(firstBatch)));
+    makeCursorFromExistingCursors(std::move(cursors), findCmd);
+
+    // Consuming the first result requests the next batch while the remote still has a buffered
+    // result, and so is still on the merge queue.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 5}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+
+    BSONObj scheduledCmd = getFirstPendingRequest().cmdObj;
+    auto request = GetMoreRequest::parseFromBSON("anydbname", scheduledCmd);
+    ASSERT_OK(request.getStatus());
+    ASSERT_EQ(request.getValue().cursorid, 1LL);
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch = {fromjson("{$sortKey: {'': 7}}"),
+                                  fromjson("{$sortKey: {'': 8}}")};
+    responses.emplace_back(_nss, CursorId(0), batch);
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+
+    // The remote is merged once per buffered result, and is off the merge queue once drained.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 6}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 7}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_BSONOBJ_EQ(fromjson("{$sortKey: {'': 8}}"),
+                      *unittest::assertGet(arm->nextReady()).getResult());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+
+    auto stats = arm->getRemoteCursorStats();
+    ASSERT_EQ(1U, stats.size());
+    ASSERT_EQ(1, stats[0].numPrefetchGetMores);
+    ASSERT_EQ(0, stats[0].bufferedBytes);
+}
+
 TEST_F(AsyncResultsMergerTest, SendsSecondaryOkAsMetadata) {
     std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
     cursors.emplace_back(kTestShardIds[0], kTestShardHosts[0], CursorResponse(_nss, 1, {}));
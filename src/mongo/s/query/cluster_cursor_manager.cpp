@@ -37,9 +37,11 @@
 
 #include "mongo/db/kill_sessions_common.h"
 #include "mongo/db/logical_session_cache.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/clock_source.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -184,21 +186,30 @@ void ClusterCursorManager::PinnedCursor::returnAndKillCursor() {
     returnCursor(CursorState::NotExhausted);
 }
 
-ClusterCursorManager::ClusterCursorManager(ClockSource* clockSource)
-    : _clockSource(clockSource),
-      _pseudoRandom(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {
+constexpr size_t ClusterCursorManager::kNumPartitions;
+
+ClusterCursorManager::ClusterCursorManager(ClockSource* clockSource) : _clockSource(clockSource) {
     invariant(_clockSource);
+
+    std::unique_ptr<SecureRandom> secureRandom(SecureRandom::create());
+    _partitions.reserve(kNumPartitions);
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        _partitions.emplace_back(stdx::make_unique<Partition>(secureRandom->nextInt64()));
+    }
 }
 
 ClusterCursorManager::~ClusterCursorManager() {
-    invariant(_cursorIdPrefixToNamespaceMap.empty());
-    invariant(_namespaceToContainerMap.empty());
+    for (const auto& partition : _partitions) {
+        invariant(partition->cursorIdPrefixToNamespaceMap.empty());
+        invariant(partition->namespaceToContainerMap.empty());
+    }
 }
 
 void ClusterCursorManager::shutdown(OperationContext* opCtx) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    _inShutdown = true;
-    lk.unlock();
+    for (const auto& partition : _partitions) {
+        auto lk = lockPartition(*partition);
+        partition->inShutdown = true;
+    }
 
     killAllCursors();
     reapZombieCursors(opCtx);
@@ -213,9 +224,13 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    // Spread the cursors across the partitions in turn, so that the cursors on a single busy
+    // namespace do not all contend on the same partition lock.
+    const size_t partitionId = _nextPartition.fetchAndAdd(1) % kNumPartitions;
+    Partition& partition = *_partitions[partitionId];
+    auto lk = lockPartition(partition);
 
-    if (_inShutdown) {
+    if (partition.inShutdown) {
         lk.unlock();
         cursor->kill(opCtx);
         return Status(ErrorCodes::ShutdownInProgress,
@@ -225,21 +240,27 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     invariant(cursor);
 
     // Find the CursorEntryContainer for this namespace.  If none exists, create one.
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+    auto& namespaceToContainerMap = partition.namespaceToContainerMap;
+    auto& cursorIdPrefixToNamespaceMap = partition.cursorIdPrefixToNamespaceMap;
+    auto nsToContainerIt = namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == namespaceToContainerMap.end()) {
         uint32_t containerPrefix = 0;
         do {
             // The server has always generated positive values for CursorId (which is a signed
             // type), so we use std::abs() here on the prefix for consistency with this historical
             // behavior.
-            containerPrefix = static_cast<uint32_t>(std::abs(_pseudoRandom.nextInt32()));
-        } while (_cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
-        _cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
+            containerPrefix = static_cast<uint32_t>(std::abs(partition.pseudoRandom.nextInt32()));
+
+            // Encode the owning partition in the low bits of the prefix, so that cursor ids
+            // generated by different partitions can never collide.
+            containerPrefix = containerPrefix - (containerPrefix % kNumPartitions) + partitionId;
+        } while (cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
+        cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
 
         auto emplaceResult =
-            _namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
+            namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
         invariant(emplaceResult.second);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        invariant(namespaceToContainerMap.size() == cursorIdPrefixToNamespaceMap.size());
 
         nsToContainerIt = emplaceResult.first;
     } else {
@@ -251,7 +272,7 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     CursorEntryMap& entryMap = container.entryMap;
     CursorId cursorId = 0;
     do {
-        const uint32_t cursorSuffix = static_cast<uint32_t>(_pseudoRandom.nextInt32());
+        const uint32_t cursorSuffix = static_cast<uint32_t>(partition.pseudoRandom.nextInt32());
         cursorId = createCursorId(container.containerPrefix, cursorSuffix);
     } while (cursorId == 0 || entryMap.count(cursorId) > 0);
 
@@ -265,14 +286,15 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
 
 StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCursor(
     const NamespaceString& nss, CursorId cursorId, OperationContext* opCtx) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition& partition = partitionForCursorId(cursorId);
+    auto lk = lockPartition(partition);
 
-    if (_inShutdown) {
+    if (partition.inShutdown) {
         return Status(ErrorCodes::ShutdownInProgress,
                       "Cannot check out cursor as we are in the process of shutting down");
     }
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -290,6 +312,10 @@ StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCur
         return cursorPrivilegeStatus;
     }
 
+    // The cursor is now pinned and the entry only needs to be revisited at check-in time, so the
+    // partition need not remain locked while talking to the logical session cache.
+    lk.unlock();
+
     // We use pinning of a cursor as a proxy for active, user-initiated use of a cursor.  Therefore,
     // we pass down to the logical session cache and vivify the record (updating last use).
     if (cursor->getLsid()) {
@@ -308,13 +334,14 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    Partition& partition = partitionForCursorId(cursorId);
+    auto lk = lockPartition(partition);
 
     invariant(cursor);
 
     const bool remotesExhausted = cursor->remotesExhausted();
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     invariant(entry);
 
     entry->setLastActive(now);
@@ -333,7 +360,7 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 
     // The cursor is exhausted, is not already scheduled for deletion, and does not have any
     // remote cursor state left to clean up. We can delete the cursor right away.
-    auto detachedCursor = detachCursor_inlock(nss, cursorId);
+    auto detachedCursor = detachCursor_inlock(partition, nss, cursorId);
     invariantOK(detachedCursor.getStatus());
 
     // Deletion of the cursor can happen out of the lock.
@@ -342,9 +369,10 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 }
 
 Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cursorId) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition& partition = partitionForCursorId(cursorId);
+    auto lk = lockPartition(partition);
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -355,28 +383,32 @@ Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cur
 }
 
 void ClusterCursorManager::killMortalCursorsInactiveSince(Date_t cutoff) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorEntry& entry = cursorIdEntryPair.second;
-            if (entry.getLifetimeType() == CursorLifetime::Mortal && entry.isCursorOwned() &&
-                entry.getLastActive() <= cutoff) {
-                entry.setInactive();
-                log() << "Marking cursor id " << cursorIdEntryPair.first
-                      << " for deletion, idle since " << entry.getLastActive().toString();
-                entry.setKillPending();
+    for (const auto& partition : _partitions) {
+        auto lk = lockPartition(*partition);
+
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorEntry& entry = cursorIdEntryPair.second;
+                if (entry.getLifetimeType() == CursorLifetime::Mortal && entry.isCursorOwned() &&
+                    entry.getLastActive() <= cutoff) {
+                    entry.setInactive();
+                    log() << "Marking cursor id " << cursorIdEntryPair.first
+                          << " for deletion, idle since " << entry.getLastActive().toString();
+                    entry.setKillPending();
+                }
             }
         }
     }
 }
 
 void ClusterCursorManager::killAllCursors() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& partition : _partitions) {
+        auto lk = lockPartition(*partition);
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            cursorIdEntryPair.second.setKillPending();
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                cursorIdEntryPair.second.setKillPending();
+            }
         }
     }
 }
@@ -391,74 +423,82 @@ std::size_t ClusterCursorManager::reapZombieCursors(OperationContext* opCtx) {
         bool isInactive;
     };
 
-    // List all zombie cursors under the manager lock, and kill them one-by-one while not holding
-    // the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a lock while
-    // issuing the kill).
-
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    std::vector<CursorDescriptor> zombieCursorDescriptors;
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        const NamespaceString& nss = nsContainerPair.first;
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorId cursorId = cursorIdEntryPair.first;
-            const CursorEntry& entry = cursorIdEntryPair.second;
-            if (!entry.getKillPending()) {
-                continue;
-            }
-            zombieCursorDescriptors.emplace_back(nss, cursorId, entry.isInactive());
-        }
-    }
-
     std::size_t cursorsTimedOut = 0;
 
-    for (auto& cursorDescriptor : zombieCursorDescriptors) {
-        StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor =
-            detachCursor_inlock(cursorDescriptor.ns, cursorDescriptor.cursorId);
-        if (!zombieCursor.isOK()) {
-            // Cursor in use, or has already been deleted.
-            continue;
+    for (const auto& partition : _partitions) {
+        // List all zombie cursors under the partition lock, and kill them one-by-one while not
+        // holding the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a
+        // lock while issuing the kill).
+
+        auto lk = lockPartition(*partition);
+        std::vector<CursorDescriptor> zombieCursorDescriptors;
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            const NamespaceString& nss = nsContainerPair.first;
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorId cursorId = cursorIdEntryPair.first;
+                const CursorEntry& entry = cursorIdEntryPair.second;
+                if (!entry.getKillPending()) {
+                    continue;
+                }
+                zombieCursorDescriptors.emplace_back(nss, cursorId, entry.isInactive());
+            }
         }
 
-        lk.unlock();
-        // Pass opCtx to kill(), since a cursor which wraps an underlying aggregation pipeline is
-        // obliged to call Pipeline::dispose with a valid OperationContext prior to deletion.
-        zombieCursor.getValue()->kill(opCtx);
-        zombieCursor.getValue().reset();
-        lk.lock();
+        for (auto& cursorDescriptor : zombieCursorDescriptors) {
+            StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor =
+                detachCursor_inlock(*partition, cursorDescriptor.ns, cursorDescriptor.cursorId);
+            if (!zombieCursor.isOK()) {
+                // Cursor in use, or has already been deleted.
+                continue;
+            }
+
+            lk.unlock();
+            // Pass opCtx to kill(), since a cursor which wraps an underlying aggregation pipeline
+            // is obliged to call Pipeline::dispose with a valid OperationContext prior to deletion.
+            zombieCursor.getValue()->kill(opCtx);
+            zombieCursor.getValue().reset();
+            lk = lockPartition(*partition);
 
-        if (cursorDescriptor.isInactive) {
-            ++cursorsTimedOut;
+            if (cursorDescriptor.isInactive) {
+                ++cursorsTimedOut;
+            }
         }
     }
     return cursorsTimedOut;
 }
 
 ClusterCursorManager::Stats ClusterCursorManager::stats() const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
     Stats stats;
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                // Killed cursors do not count towards the number of pinned cursors or the number of
-                // open cursors.
-                continue;
-            }
-
-            if (!entry.isCursorOwned()) {
-                ++stats.cursorsPinned;
-            }
-
-            switch (entry.getCursorType()) {
-                case CursorType::SingleTarget:
-                    ++stats.cursorsSingleTarget;
-                    break;
-                case CursorType::MultiTarget:
-                    ++stats.cursorsMultiTarget;
-                    break;
+    for (const auto& partition : _partitions) {
+        auto lk = lockPartition(*partition);
+
+        stats.lockAcquisitions += partition->lockAcquisitions.load();
+        stats.lockWaits += partition->lockWaits.load();
+        stats.lockWaitMicros += partition->lockWaitMicros.load();
+
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Killed cursors do not count towards the number of pinned cursors or the
+                    // number of open cursors.
+                    continue;
+                }
+
+                if (!entry.isCursorOwned()) {
+                    ++stats.cursorsPinned;
+                }
+
+                switch (entry.getCursorType()) {
+                    case CursorType::SingleTarget:
+                        ++stats.cursorsSingleTarget;
+                        break;
+                    case CursorType::MultiTarget:
+                        ++stats.cursorsMultiTarget;
+                        break;
+                }
             }
         }
     }
@@ -467,20 +507,22 @@ ClusterCursorManager::Stats ClusterCursorManager::stats() const {
 }
 
 void ClusterCursorManager::appendActiveSessions(LogicalSessionIdSet* lsids) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    for (const auto& nsContainerPair : _namespaceToContainerMap) {
-        for (const auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                // Don't include sessions for killed cursors.
-                continue;
-            }
-
-            auto lsid = entry.getLsid();
-            if (lsid) {
-                lsids->insert(*lsid);
+    for (const auto& partition : _partitions) {
+        auto lk = lockPartition(*partition);
+
+        for (const auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (const auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Don't include sessions for killed cursors.
+                    continue;
+                }
+
+                auto lsid = entry.getLsid();
+                if (lsid) {
+                    lsids->insert(*lsid);
+                }
             }
         }
     }
@@ -499,22 +541,24 @@ Status ClusterCursorManager::killCursorsWithMatchingSessions(
 
 stdx::unordered_set<CursorId> ClusterCursorManager::getCursorsForSession(
     LogicalSessionId lsid) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
     stdx::unordered_set<CursorId> cursorIds;
 
-    for (auto&& nsContainerPair : _namespaceToContainerMap) {
-        for (auto&& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
+    for (const auto& partition : _partitions) {
+        auto lk = lockPartition(*partition);
 
-            if (entry.getKillPending()) {
-                // Don't include sessions for killed cursors.
-                continue;
-            }
+        for (auto&& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto&& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Don't include sessions for killed cursors.
+                    continue;
+                }
 
-            auto cursorLsid = entry.getLsid();
-            if (lsid == cursorLsid) {
-                cursorIds.insert(cursorIdEntryPair.first);
+                auto cursorLsid = entry.getLsid();
+                if (lsid == cursorLsid) {
+                    cursorIds.insert(cursorIdEntryPair.first);
+                }
             }
         }
     }
@@ -524,19 +568,42 @@ stdx::unordered_set<CursorId> ClusterCursorManager::getCursorsForSession(
 
 boost::optional<NamespaceString> ClusterCursorManager::getNamespaceForCursorId(
     CursorId cursorId) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const Partition& partition = partitionForCursorId(cursorId);
+    auto lk = lockPartition(partition);
 
-    const auto it = _cursorIdPrefixToNamespaceMap.find(extractPrefixFromCursorId(cursorId));
-    if (it == _cursorIdPrefixToNamespaceMap.end()) {
+    const auto it =
+        partition.cursorIdPrefixToNamespaceMap.find(extractPrefixFromCursorId(cursorId));
+    if (it == partition.cursorIdPrefixToNamespaceMap.end()) {
         return boost::none;
     }
     return it->second;
 }
 
-ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(const NamespaceString& nss,
-                                                                         CursorId cursorId) {
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+ClusterCursorManager::Partition& ClusterCursorManager::partitionForCursorId(
+    CursorId cursorId) const {
+    return *_partitions[extractPrefixFromCursorId(cursorId) % kNumPartitions];
+}
+
+stdx::unique_lock<stdx::mutex> ClusterCursorManager::lockPartition(
+    const Partition& partition) const {
+    partition.lockAcquisitions.addAndFetch(1);
+
+    stdx::unique_lock<stdx::mutex> lk(partition.mutex, stdx::try_to_lock);
+    if (!lk.owns_lock()) {
+        // Only time contended acquisitions, so that the uncontended path stays cheap.
+        Timer waitTimer;
+        lk.lock();
+        partition.lockWaits.addAndFetch(1);
+        partition.lockWaitMicros.addAndFetch(waitTimer.micros());
+    }
+
+    return lk;
+}
+
+ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(
+    Partition& partition, const NamespaceString& nss, CursorId cursorId) {
+    auto nsToContainerIt = partition.namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == partition.namespaceToContainerMap.end()) {
         return nullptr;
     }
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
@@ -549,8 +616,8 @@ ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(const N
 }
 
 StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCursor_inlock(
-    const NamespaceString& nss, CursorId cursorId) {
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    Partition& partition, const NamespaceString& nss, CursorId cursorId) {
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -560,8 +627,9 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCur
         return cursorInUseStatus(nss, cursorId);
     }
 
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    invariant(nsToContainerIt != _namespaceToContainerMap.end());
+    auto& namespaceToContainerMap = partition.namespaceToContainerMap;
+    auto nsToContainerIt = namespaceToContainerMap.find(nss);
+    invariant(nsToContainerIt != namespaceToContainerMap.end());
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
     size_t eraseResult = entryMap.erase(cursorId);
     invariant(1 == eraseResult);
@@ -569,10 +637,11 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCur
         // This was the last cursor remaining in the given namespace.  Erase all state associated
         // with this namespace.
         size_t numDeleted =
-            _cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
+            partition.cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
         invariant(numDeleted == 1);
-        _namespaceToContainerMap.erase(nsToContainerIt);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        namespaceToContainerMap.erase(nsToContainerIt);
+        invariant(namespaceToContainerMap.size() ==
+                  partition.cursorIdPrefixToNamespaceMap.size());
     }
 
     return std::move(cursor);
@@ -35,6 +35,7 @@
 #include "mongo/db/kill_sessions.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/query/cluster_client_cursor.h"
 #include "mongo/stdx/mutex.h"
@@ -110,6 +111,16 @@ public:
 
         // Count of pinned cursors.
         size_t cursorsPinned = 0;
+
+        // Number of times a partition lock was acquired.
+        long long lockAcquisitions = 0;
+
+        // Number of partition lock acquisitions which had to wait for another thread to release
+        // the lock.
+        long long lockWaits = 0;
+
+        // Total time spent waiting to acquire partition locks, in microseconds.
+        long long lockWaitMicros = 0;
     };
 
     /**
@@ -344,7 +355,8 @@ public:
     std::size_t reapZombieCursors(OperationContext* opCtx);
 
     /**
-     * Returns the number of open cursors on a ClusterCursorManager, broken down by type.
+     * Returns the number of open cursors on a ClusterCursorManager, broken down by type, along with
+     * the partition lock acquisition statistics.
      *
      * Does not block.
      */
@@ -386,8 +398,25 @@ public:
 
 private:
     class CursorEntry;
+    struct Partition;
     using CursorEntryMap = stdx::unordered_map<CursorId, CursorEntry>;
 
+    // Number of partitions the registered cursors are striped across. Must be a power of two, so
+    // that forcing the partition bits of a cursor id prefix keeps the prefix positive.
+    static constexpr size_t kNumPartitions = 16;
+
+    /**
+     * Returns the partition which owns the cursor with the given id, determined by the 'namespace
+     * prefix' portion of the cursor id. A cursor with the given cursor id need not actually exist.
+     */
+    Partition& partitionForCursorId(CursorId cursorId) const;
+
+    /**
+     * Acquires the lock of the given partition, recording whether and for how long the caller had
+     * to wait for it.
+     */
+    stdx::unique_lock<stdx::mutex> lockPartition(const Partition& partition) const;
+
     /**
      * Transfers ownership of the given pinned cursor back to the manager, and moves the cursor to
      * the 'idle' state.
@@ -411,9 +440,11 @@ private:
      * Returns a pointer to the CursorEntry for the given cursor.  If the given cursor is not
      * registered, returns null.
      *
-     * Not thread-safe.
+     * Not thread-safe. The lock of 'partition', which must own 'cursorId', must be held.
      */
-    CursorEntry* getEntry_inlock(const NamespaceString& nss, CursorId cursorId);
+    static CursorEntry* getEntry_inlock(Partition& partition,
+                                        const NamespaceString& nss,
+                                        CursorId cursorId);
 
     /**
      * De-registers the given cursor, and returns an owned pointer to the underlying
@@ -422,10 +453,10 @@ private:
      * If the given cursor is pinned, returns an error Status with code CursorInUse.  If the given
      * cursor is not registered, returns an error Status with code CursorNotFound.
      *
-     * Not thread-safe.
+     * Not thread-safe. The lock of 'partition', which must own 'cursorId', must be held.
      */
-    StatusWith<std::unique_ptr<ClusterClientCursor>> detachCursor_inlock(const NamespaceString& nss,
-                                                                         CursorId cursorId);
+    static StatusWith<std::unique_ptr<ClusterClientCursor>> detachCursor_inlock(
+        Partition& partition, const NamespaceString& nss, CursorId cursorId);
 
     /**
      * CursorEntry is a moveable, non-copyable container for a single cursor.
@@ -537,36 +568,64 @@ private:
         CursorEntryMap entryMap;
     };
 
+    /**
+     * A Partition owns the cursors whose ids it generated, along with the bookkeeping necessary to
+     * generate cursor ids. New cursors are spread across the partitions regardless of their
+     * namespace, so cursors on different partitions, even on the same namespace, can be
+     * registered, pinned and returned concurrently.
+     */
+    struct Partition {
+        MONGO_DISALLOW_COPYING(Partition);
+
+        explicit Partition(int64_t seed) : pseudoRandom(seed) {}
+
+        // Synchronizes access to all state variables of this partition below.
+        mutable stdx::mutex mutex;
+
+        bool inShutdown{false};
+
+        // Randomness source.  Used for cursor id generation.
+        PseudoRandom pseudoRandom;
+
+        // Map from cursor id prefix to associated namespace.  Exists only to provide namespace
+        // lookup for (deprecated) getNamespaceForCursorId() method.
+        //
+        // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the
+        // first cursor on a given namespace is registered in this partition, it is given a
+        // CursorId with a prefix that is unique to that namespace, and an arbitrary suffix.
+        // Cursors subsequently registered on that namespace in this partition will all share the
+        // same prefix.  The low bits of the prefix identify the partition, which keeps prefixes
+        // unique across partitions and lets a cursor id be routed to its partition.
+        //
+        // Entries are added when the first cursor on the given namespace is registered in this
+        // partition, and removed when the last such cursor is destroyed.
+        stdx::unordered_map<uint32_t, NamespaceString> cursorIdPrefixToNamespaceMap;
+
+        // Map from namespace to the CursorEntryContainer for that namespace.
+        //
+        // Entries are added when the first cursor on the given namespace is registered, and
+        // removed when the last cursor on the given namespace is destroyed.
+        stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
+            namespaceToContainerMap;
+
+        // Lock statistics of this partition, reported through stats().  Kept apart from the other
+        // partitions' statistics, so that uncontended partitions do not share their cache lines.
+        mutable AtomicInt64 lockAcquisitions;
+        mutable AtomicInt64 lockWaits;
+        mutable AtomicInt64 lockWaitMicros;
+    };
+
     // Clock source.  Used when the 'last active' time for a cursor needs to be set/updated.  May be
     // concurrently accessed by multiple threads.
     ClockSource* _clockSource;
 
-    // Synchronizes access to all private state variables below.
-    mutable stdx::mutex _mutex;
-
-    bool _inShutdown{false};
+    // The registered cursors, striped by cursor id.  The vector itself is immutable after
+    // construction; each Partition is protected by its own mutex.  Operations which span all
+    // cursors lock the partitions one at a time, in ascending order.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
-    // Randomness source.  Used for cursor id generation.
-    PseudoRandom _pseudoRandom;
-
-    // Map from cursor id prefix to associated namespace.  Exists only to provide namespace lookup
-    // for (deprecated) getNamespaceForCursorId() method.
-    //
-    // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the first
-    // cursor on a given namespace is registered, it is given a CursorId with a prefix that is
-    // unique to that namespace, and an arbitrary suffix.  Cursors subsequently registered on that
-    // namespace will all share the same prefix.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<uint32_t, NamespaceString> _cursorIdPrefixToNamespaceMap;
-
-    // Map from namespace to the CursorEntryContainer for that namespace.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
-        _namespaceToContainerMap;
+    // Used to assign new cursors to the partitions in turn.
+    AtomicUInt32 _nextPartition;
 
     size_t _cursorsTimedOut = 0;
 };
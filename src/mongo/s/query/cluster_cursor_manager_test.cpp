@@ -30,6 +30,7 @@
 
 #include "mongo/s/query/cluster_cursor_manager.h"
 
+#include <set>
 #include <vector>
 
 #include "mongo/db/logical_session_cache.h"
@@ -776,6 +777,87 @@ TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdUnknown) {
     ASSERT_FALSE(cursorNamespace);
 }
 
+// Test that cursors registered on many namespaces, which are spread across the manager's
+// partitions, can each be checked out on their own namespace and only on their own namespace.
+TEST_F(ClusterCursorManagerTest, CheckOutCursorManyNamespaces) {
+    const size_t numCursors = 100;
+    std::vector<std::pair<NamespaceString, CursorId>> cursors(numCursors);
+    for (size_t i = 0; i < numCursors; ++i) {
+        NamespaceString cursorNamespace(std::string(str::stream() << "test.collection" << i));
+        auto cursorId =
+            assertGet(getManager()->registerCursor(nullptr,
+                                                   allocateMockCursor(),
+                                                   cursorNamespace,
+                                                   ClusterCursorManager::CursorType::SingleTarget,
+                                                   ClusterCursorManager::CursorLifetime::Mortal));
+        ASSERT_GT(cursorId, 0);
+        cursors[i] = {cursorNamespace, cursorId};
+    }
+    for (size_t i = 0; i < numCursors; ++i) {
+        const auto& otherNamespace = cursors[(i + 1) % numCursors].first;
+        ASSERT_EQ(ErrorCodes::CursorNotFound,
+                  getManager()
+                      ->checkOutCursor(otherNamespace, cursors[i].second, _opCtx.get())
+                      .getStatus());
+
+        auto pinnedCursor =
+            getManager()->checkOutCursor(cursors[i].first, cursors[i].second, _opCtx.get());
+        ASSERT_OK(pinnedCursor.getStatus());
+        ASSERT_EQ(cursors[i].second, pinnedCursor.getValue().getCursorId());
+        pinnedCursor.getValue().returnCursor(ClusterCursorManager::CursorState::Exhausted);
+        ASSERT_FALSE(getManager()->getNamespaceForCursorId(cursors[i].second));
+    }
+    ASSERT_EQ(0U, getManager()->stats().cursorsSingleTarget);
+}
+
+// Test that the cursors on a single namespace are spread across the manager's partitions, which
+// are encoded in the cursor id prefix, and can all be found on that namespace.
+TEST_F(ClusterCursorManagerTest, CursorsOnOneNamespaceAreSpreadAcrossPartitions) {
+    const size_t numCursors = 64;
+    std::vector<CursorId> cursorIds;
+    std::set<uint32_t> cursorIdPrefixes;
+    for (size_t i = 0; i < numCursors; ++i) {
+        auto cursorId =
+            assertGet(getManager()->registerCursor(nullptr,
+                                                   allocateMockCursor(),
+                                                   nss,
+                                                   ClusterCursorManager::CursorType::SingleTarget,
+                                                   ClusterCursorManager::CursorLifetime::Mortal));
+        cursorIds.push_back(cursorId);
+        cursorIdPrefixes.insert(static_cast<uint64_t>(cursorId) >> 32);
+    }
+    ASSERT_GT(cursorIdPrefixes.size(), 1U);
+    ASSERT_EQ(numCursors, getManager()->stats().cursorsSingleTarget);
+
+    for (auto cursorId : cursorIds) {
+        ASSERT(getManager()->getNamespaceForCursorId(cursorId) == nss);
+
+        auto pinnedCursor = getManager()->checkOutCursor(nss, cursorId, _opCtx.get());
+        ASSERT_OK(pinnedCursor.getStatus());
+        pinnedCursor.getValue().returnCursor(ClusterCursorManager::CursorState::Exhausted);
+    }
+    ASSERT_EQ(0U, getManager()->stats().cursorsSingleTarget);
+}
+
+// Test that operations on the manager are counted as partition lock acquisitions.
+TEST_F(ClusterCursorManagerTest, StatsCountLockAcquisitions) {
+    const auto acquisitionsBefore = getManager()->stats().lockAcquisitions;
+    auto cursorId =
+        assertGet(getManager()->registerCursor(nullptr,
+                                               allocateMockCursor(),
+                                               nss,
+                                               ClusterCursorManager::CursorType::SingleTarget,
+                                               ClusterCursorManager::CursorLifetime::Mortal));
+    auto pinnedCursor = getManager()->checkOutCursor(nss, cursorId, _opCtx.get());
+    ASSERT_OK(pinnedCursor.getStatus());
+    pinnedCursor.getValue().returnCursor(ClusterCursorManager::CursorState::NotExhausted);
+
+    auto stats = getManager()->stats();
+    ASSERT_GTE(stats.lockAcquisitions, acquisitionsBefore + 3);
+    ASSERT_LTE(stats.lockWaits, stats.lockAcquisitions);
+    ASSERT_GTE(stats.lockWaitMicros, 0);
+}
+
 // Test that the PinnedCursor default constructor creates a pin that owns no cursor.
 TEST_F(ClusterCursorManagerTest, PinnedCursorDefaultConstructor) {
     ClusterCursorManager::PinnedCursor pinnedCursor;
@@ -32,6 +32,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/s/balancer_configuration.h"
+#include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
 
@@ -65,8 +66,25 @@ public:
     }
 };
 
+class ShardingStatisticsServerStatus final : public ServerStatusSection {
+public:
+    ShardingStatisticsServerStatus() : ServerStatusSection("shardingStatistics") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder result;
+        Grid::get(opCtx)->catalogCache()->report(&result);
+        return result.obj();
+    }
+};
+
 MONGO_INITIALIZER(ShardingServerStatusSection)(InitializerContext* context) {
     new ShardingServerStatus();
+    new ShardingStatisticsServerStatus();
 
     return Status::OK();
 }
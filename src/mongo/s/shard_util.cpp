@@ -87,6 +87,37 @@ StatusWith<long long> retrieveTotalShardSize(OperationContext* opCtx, const Shar
     return totalSizeElem.numberLong();
 }
 
+StatusWith<long long> retrieveCollectionDataSize(OperationContext* opCtx,
+                                                 const ShardId& shardId,
+                                                 const NamespaceString& nss) {
+    auto shardStatus = Grid::get(opCtx)->shardRegistry()->getShard(opCtx, shardId);
+    if (!shardStatus.isOK()) {
+        return shardStatus.getStatus();
+    }
+
+    auto collStatsStatus = shardStatus.getValue()->runCommandWithFixedRetryAttempts(
+        opCtx,
+        ReadPreferenceSetting{ReadPreference::PrimaryPreferred},
+        nss.db().toString(),
+        BSON("collStats" << nss.coll() << "scale" << 1),
+        Shard::RetryPolicy::kIdempotent);
+
+    if (!collStatsStatus.isOK()) {
+        return std::move(collStatsStatus.getStatus());
+    }
+
+    if (!collStatsStatus.getValue().commandStatus.isOK()) {
+        return std::move(collStatsStatus.getValue().commandStatus);
+    }
+
+    BSONElement sizeElem = collStatsStatus.getValue().response["size"];
+    if (!sizeElem.isNumber()) {
+        return {ErrorCodes::NoSuchKey, "size field not found in collStats"};
+    }
+
+    return sizeElem.safeNumberLong();
+}
+
 StatusWith<std::vector<BSONObj>> selectChunkSplitPoints(OperationContext* opCtx,
                                                         const ShardId& shardId,
                                                         const NamespaceString& nss,
@@ -60,6 +60,18 @@ namespace shardutil {
  */
 StatusWith<long long> retrieveTotalShardSize(OperationContext* opCtx, const ShardId& shardId);
 
+/**
+ * Executes the collStats command against the specified shard and obtains the size in bytes of the
+ * data of the specified collection on that shard (essentially, the size field).
+ *
+ * Returns OK with the collection size or an error. Known errors are:
+ *  ShardNotFound if shard by that id is not available on the registry
+ *  NoSuchKey if the collection size could not be retrieved
+ */
+StatusWith<long long> retrieveCollectionDataSize(OperationContext* opCtx,
+                                                 const ShardId& shardId,
+                                                 const NamespaceString& nss);
+
 /**
  * Ask the specified shard to figure out the split points for a given chunk.
  *
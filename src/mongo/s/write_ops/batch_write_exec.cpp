@@ -328,6 +328,11 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
             warning() << "could not refresh targeter" << causedBy(refreshStatus.reason());
         }
 
+        if (targeterChanged) {
+            // The inserts targeted ahead of this round's writes went by the old routing info
+            batchOp.forgetTargetedInserts();
+        }
+
         //
         // Ensure progress is being made toward completing the batch op
         //
@@ -30,6 +30,7 @@
 
 #include "mongo/s/write_ops/batch_write_op.h"
 
+#include <algorithm>
 #include <numeric>
 
 #include "mongo/base/error_codes.h"
@@ -68,6 +69,11 @@ struct WriteErrorDetailComp {
 const int kEstUpdateOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 const int kEstDeleteOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 
+// Number of inserts of an ordered batch, which are targeted together at first. Ordered batches
+// stop at the first write to a different shard, so their inserts are targeted in windows of
+// doubling size, in order not to target the whole rest of the batch to send only a few writes.
+const size_t kOrderedInsertTargetingWindow = 16;
+
 /**
  * Returns a new write concern that has the copy of every field from the original
  * document but with a w set to 1. This is intended for upgrading { w: 0 } write
@@ -214,7 +220,11 @@ void trackErrors(const ShardEndpoint& endpoint,
 }  // namespace
 
 BatchWriteOp::BatchWriteOp(OperationContext* opCtx, const BatchedCommandRequest& clientRequest)
-    : _opCtx(opCtx), _clientRequest(clientRequest) {
+    : _opCtx(opCtx),
+      _clientRequest(clientRequest),
+      _insertTargetingWindow(_clientRequest.getWriteCommandBase().getOrdered()
+                                 ? kOrderedInsertTargetingWindow
+                                 : _clientRequest.sizeWriteOps()) {
     _writeOps.reserve(_clientRequest.sizeWriteOps());
 
     for (size_t i = 0; i < _clientRequest.sizeWriteOps(); ++i) {
@@ -272,6 +282,39 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    // Inserts are targeted in bulk, so that the targeter can look up the chunks for all their
+    // shard keys in a single sorted pass instead of once per document
+    const bool isBulkInsert =
+        _clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert &&
+        !_clientRequest.isInsertIndexRequest();
+
+    if (isBulkInsert) {
+        _insertEndpoints.resize(numWriteOps);
+    }
+
+    // Targets the ready inserts from 'begin' on, which were not targeted yet
+    auto targetInsertsFrom = [&](size_t begin) {
+        const size_t end = std::min(numWriteOps, begin + _insertTargetingWindow);
+
+        vector<BSONObj> docs;
+        vector<size_t> docOps;
+        for (size_t i = begin; i < end; ++i) {
+            if (_writeOps[i].getWriteState() != WriteOpState_Ready || _insertEndpoints[i])
+                continue;
+
+            docs.push_back(_writeOps[i].getWriteItem().getDocument());
+            docOps.push_back(i);
+        }
+
+        auto endpoints = targeter.targetInserts(_opCtx, docs);
+        invariant(endpoints.size() == docOps.size());
+        for (size_t i = 0; i < endpoints.size(); ++i) {
+            _insertEndpoints[docOps[i]] = std::move(endpoints[i]);
+        }
+
+        _insertTargetingWindow *= 2;
+    };
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -287,7 +330,16 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        Status targetStatus = Status::OK();
+        if (isBulkInsert) {
+            if (!_insertEndpoints[i]) {
+                targetInsertsFrom(i);
+            }
+
+            targetStatus = writeOp.targetWrites(*_insertEndpoints[i], &writes);
+        } else {
+            targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        }
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
@@ -369,6 +421,11 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         // Relinquish ownership of TargetedWrites, now the TargetedBatches own them
         writesOwned.mutableVector().clear();
 
+        // The insert is sent now, so if it is retried it must be targeted again
+        if (isBulkInsert) {
+            _insertEndpoints[i] = boost::none;
+        }
+
         //
         // Break if we're ordered and we have more than one endpoint - later writes cannot be
         // enforced as ordered across multiple shard endpoints.
@@ -757,6 +814,10 @@ int BatchWriteOp::numWriteOpsIn(WriteOpState opState) const {
         });
 }
 
+void BatchWriteOp::forgetTargetedInserts() {
+    _insertEndpoints.clear();
+}
+
 void BatchWriteOp::_incBatchStats(const BatchedCommandResponse& response) {
     const auto batchType = _clientRequest.getBatchType();
 
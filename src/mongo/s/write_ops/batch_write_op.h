@@ -31,9 +31,12 @@
 #include <set>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/platform/unordered_map.h"
 #include "mongo/rpc/write_concern_error_detail.h"
 #include "mongo/s/ns_targeter.h"
@@ -186,6 +189,13 @@ public:
      */
     int numWriteOpsIn(WriteOpState state) const;
 
+    /**
+     * Discards the insert endpoints which were targeted ahead of the writes actually sent. Must be
+     * called whenever the targeter's routing information changes, so that the remaining inserts
+     * are targeted again against the new routing information.
+     */
+    void forgetTargetedInserts();
+
 private:
     /**
      * Maintains the batch execution statistics when a response is received.
@@ -205,6 +215,14 @@ private:
     // Array of ops being processed from the client request
     std::vector<WriteOp> _writeOps;
 
+    // Endpoints of the inserts, which were targeted but not yet sent. Ordered batches target their
+    // inserts ahead of the point where the batch is broken, so these are kept across rounds in
+    // order to target (and account in the targeter's stats) each insert only once.
+    std::vector<boost::optional<StatusWith<ShardEndpoint>>> _insertEndpoints;
+
+    // Number of inserts of an ordered batch to target together next time
+    size_t _insertTargetingWindow;
+
     // Current outstanding batch op write requests
     // Not owned here but tracked for reporting
     std::set<const TargetedWriteBatch*> _targeted;
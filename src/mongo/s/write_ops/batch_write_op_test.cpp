@@ -468,6 +468,74 @@ TEST_F(BatchWriteOpTest, MultiOpTwoShardsOrdered) {
     ASSERT_EQUALS(clientResponse.getN(), 2);
 }
 
+/**
+ * Mock targeter, which counts how many times the shard key value of each insert was targeted.
+ */
+class CountingInsertsTargeter : public MockNSTargeter {
+public:
+    Status targetInsert(OperationContext* opCtx,
+                        const BSONObj& doc,
+                        ShardEndpoint** endpoint) const override {
+        ++targetedInserts[doc["x"].numberInt()];
+        return MockNSTargeter::targetInsert(opCtx, doc, endpoint);
+    }
+
+    mutable std::map<int, int> targetedInserts;
+};
+
+// Ordered inserts are targeted ahead of the point where the batch is broken, but each of them must
+// still be targeted only once over all the rounds of the batch.
+TEST_F(BatchWriteOpTest, MultiRoundOrderedInsertsAreTargetedOnce) {
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    CountingInsertsTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    // Inserts to shardA, then shardB, then shardA again, which take three rounds
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setDocuments({BSON("x" << -1),
+                               BSON("x" << -2),
+                               BSON("x" << 1),
+                               BSON("x" << 2),
+                               BSON("x" << -3),
+                               BSON("x" << -4)});
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    const std::vector<std::pair<ShardEndpoint, size_t>> expectedRounds{
+        {endpointA, 2u}, {endpointB, 2u}, {endpointA, 2u}};
+
+    for (const auto& expectedRound : expectedRounds) {
+        ASSERT(!batchOp.isFinished());
+
+        OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+        std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+        ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+        ASSERT_EQUALS(targeted.size(), 1u);
+        assertEndpointsEqual(targeted.begin()->second->getEndpoint(), expectedRound.first);
+        ASSERT_EQUALS(targeted.begin()->second->getWrites().size(), expectedRound.second);
+
+        BatchedCommandResponse response;
+        buildResponse(expectedRound.second, &response);
+        batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    }
+
+    ASSERT(batchOp.isFinished());
+
+    const std::map<int, int> expectedTargetedInserts{
+        {-1, 1}, {-2, 1}, {1, 1}, {2, 1}, {-3, 1}, {-4, 1}};
+    ASSERT(targeter.targetedInserts == expectedTargetedInserts);
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), 6);
+}
+
 void verifyTargetedBatches(std::map<ShardId, size_t> expected,
                            const std::map<ShardId, TargetedWriteBatch*>& targeted) {
     // 'expected' contains each ShardId that was expected to be targeted and the size of the batch
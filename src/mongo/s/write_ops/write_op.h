@@ -121,6 +121,13 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as above, but for a single document insert whose endpoint was already determined
+     * along with the other inserts of the batch through NSTargeter::targetInserts.
+     */
+    Status targetWrites(const StatusWith<ShardEndpoint>& swEndpoint,
+                        std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -159,6 +166,13 @@ public:
     void setOpError(const WriteErrorDetail& error);
 
 private:
+    /**
+     * Creates a ChildWriteOp and a TargetedWrite for each of the endpoints and moves the op to
+     * state _Pending.
+     */
+    void _addTargetedWrites(const std::vector<std::unique_ptr<ShardEndpoint>>& endpoints,
+                            std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Updates the op state after new information is received.
      */
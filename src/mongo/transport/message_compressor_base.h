@@ -40,6 +40,8 @@ enum class MessageCompressor : uint8_t {
     kNoop = 0,
     kSnappy = 1,
     kZlib = 2,
+    kZstd = 3,
+    kLz4 = 4,
     kExtended = 255,
 };
 
@@ -114,6 +116,50 @@ public:
         return _decompressBytesOut.loadRelaxed();
     }
 
+    /*
+     * This returns the number of messages compressed with this compressor
+     */
+    int64_t getCompressedMessages() const {
+        return _compressMessages.loadRelaxed();
+    }
+
+    /*
+     * This returns the number of messages decompressed with this compressor
+     */
+    int64_t getDecompressedMessages() const {
+        return _decompressMessages.loadRelaxed();
+    }
+
+    /*
+     * This returns the total time spent in compressData, in microseconds
+     */
+    int64_t getCompressTimeMicros() const {
+        return _compressMicros.loadRelaxed();
+    }
+
+    /*
+     * This returns the total time spent in decompressData, in microseconds
+     */
+    int64_t getDecompressTimeMicros() const {
+        return _decompressMicros.loadRelaxed();
+    }
+
+    /*
+     * Called by the MessageCompressorManager to account for a single call to compressData
+     */
+    void counterHitCompressTime(int64_t micros) {
+        _compressMessages.addAndFetch(1);
+        _compressMicros.addAndFetch(micros);
+    }
+
+    /*
+     * Called by the MessageCompressorManager to account for a single call to decompressData
+     */
+    void counterHitDecompressTime(int64_t micros) {
+        _decompressMessages.addAndFetch(1);
+        _decompressMicros.addAndFetch(micros);
+    }
+
 
 protected:
     /*
@@ -148,5 +194,11 @@ private:
 
     AtomicInt64 _decompressBytesIn;
     AtomicInt64 _decompressBytesOut;
+
+    AtomicInt64 _compressMessages;
+    AtomicInt64 _compressMicros;
+
+    AtomicInt64 _decompressMessages;
+    AtomicInt64 _decompressMicros;
 };
 }  // namespace mongo
@@ -0,0 +1,73 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_lz4.h"
+
+#include <string>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(Lz4MessageCompressor, RoundTrip) {
+    std::string input;
+    for (int i = 0; i < 1000; ++i) {
+        input += "{ insert: \"collection\", documents: [ { _id: " + std::to_string(i) + " } ] }";
+    }
+
+    Lz4MessageCompressor compressor;
+    std::string compressed(compressor.getMaxCompressedSize(input.size()), '\0');
+    auto sw = compressor.compressData(ConstDataRange(input.data(), input.size()),
+                                      DataRange(&compressed[0], compressed.size()));
+    ASSERT_OK(sw.getStatus());
+    ASSERT_LT(sw.getValue(), input.size());
+    compressed.resize(sw.getValue());
+
+    std::string output(input.size(), '\0');
+    sw = compressor.decompressData(ConstDataRange(compressed.data(), compressed.size()),
+                                   DataRange(&output[0], output.size()));
+    ASSERT_OK(sw.getStatus());
+    ASSERT_EQ(input.size(), sw.getValue());
+    ASSERT_EQ(input, output);
+    ASSERT_EQ(input.size(), static_cast<size_t>(compressor.getCompressedBytesIn()));
+}
+
+TEST(Lz4MessageCompressor, CorruptInputIsRejected) {
+    Lz4MessageCompressor compressor;
+    std::string garbage(64, '\xff');
+    std::string output(1024, '\0');
+    auto sw = compressor.decompressData(ConstDataRange(garbage.data(), garbage.size()),
+                                        DataRange(&output[0], output.size()));
+    ASSERT_EQ(ErrorCodes::BadValue, sw.getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
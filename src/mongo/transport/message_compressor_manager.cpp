@@ -36,14 +36,24 @@
 #include "mongo/base/data_type_endian.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(networkMessageCompressionMinSizeBytes, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(networkMessageCompressionLargeMessageSizeBytes, int, 0);
+
 namespace {
 
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(networkMessageCompressorForLargeMessages, std::string, "");
+
+
 // TODO(JBR): This should be changed so it 's closer to the MSGHEADER View/ConstView classes
 // than this little struct.
 struct CompressionHeader {
@@ -81,8 +91,12 @@ MessageCompressorManager::MessageCompressorManager()
 MessageCompressorManager::MessageCompressorManager(MessageCompressorRegistry* factory)
     : _registry{factory} {}
 
-StatusWith<Message> MessageCompressorManager::compressMessage(
-    const Message& msg, const MessageCompressorId* compressorId) {
+MessageCompressorBase* MessageCompressorManager::_selectCompressor(
+    size_t messageSize, const MessageCompressorId* compressorId) {
+    const auto minSize = networkMessageCompressionMinSizeBytes.load();
+    if (minSize > 0 && messageSize < static_cast<size_t>(minSize)) {
+        return nullptr;
+    }
 
     MessageCompressorBase* compressor = nullptr;
     if (compressorId) {
@@ -91,6 +105,30 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
     } else if (!_negotiated.empty()) {
         compressor = _negotiated[0];
     } else {
+        return nullptr;
+    }
+
+    const auto largeSize = networkMessageCompressionLargeMessageSizeBytes.load();
+    if (largeSize > 0 && messageSize >= static_cast<size_t>(largeSize)) {
+        // Only switch to a compressor the peer has agreed to, so that it is able to decompress
+        // the message.
+        const auto& largeName = networkMessageCompressorForLargeMessages;
+        auto it = std::find_if(_negotiated.begin(),
+                               _negotiated.end(),
+                               [&](MessageCompressorBase* c) { return c->getName() == largeName; });
+        if (it != _negotiated.end()) {
+            compressor = *it;
+        }
+    }
+
+    return compressor;
+}
+
+StatusWith<Message> MessageCompressorManager::compressMessage(
+    const Message& msg, const MessageCompressorId* compressorId) {
+
+    MessageCompressorBase* compressor = _selectCompressor(msg.dataSize(), compressorId);
+    if (!compressor) {
         return {msg};
     }
 
@@ -121,11 +159,14 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
+    Timer compressTimer;
     auto sws = compressor->compressData(input, output);
 
     if (!sws.isOK())
         return sws.getStatus();
 
+    compressor->counterHitCompressTime(compressTimer.micros());
+
     auto realCompressedSize = sws.getValue();
     outMessage.setLen(realCompressedSize + CompressionHeader::size() + MsgData::MsgDataHeaderSize);
 
@@ -160,11 +201,14 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
 
     DataRangeCursor output(outMessage.data(), outMessage.data() + outMessage.dataLen());
 
+    Timer decompressTimer;
     auto sws = compressor->decompressData(input, output);
 
     if (!sws.isOK())
         return sws.getStatus();
 
+    compressor->counterHitDecompressTime(decompressTimer.micros());
+
     if (sws.getValue() != static_cast<std::size_t>(compressionHeader.uncompressedSize)) {
         return {ErrorCodes::BadValue, "Decompressing message returned less data than expected"};
     }
@@ -30,6 +30,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/transport/message_compressor_base.h"
 #include "mongo/transport/session.h"
 
@@ -42,6 +43,14 @@ class BSONObjBuilder;
 class Message;
 class MessageCompressorRegistry;
 
+// Messages whose body is smaller than this many bytes are sent uncompressed.
+extern AtomicInt32 networkMessageCompressionMinSizeBytes;
+
+// Messages whose body is at least this many bytes are compressed with the compressor named by
+// the networkMessageCompressorForLargeMessages startup parameter, if it was negotiated.  Zero
+// disables the per-size compressor selection.
+extern AtomicInt32 networkMessageCompressionLargeMessageSizeBytes;
+
 class MessageCompressorManager {
     MONGO_DISALLOW_COPYING(MessageCompressorManager);
 
@@ -95,6 +104,11 @@ public:
      * given identifier. It is intended that this value echo back a value returned as the out
      * parameter value for compressorId from a call to decompressMessage.
      *
+     * The choice is made per message: messages smaller than networkMessageCompressionMinSizeBytes
+     * are not compressed at all, and messages of at least
+     * networkMessageCompressionLargeMessageSizeBytes use the compressor configured for large
+     * messages when the peer negotiated it.
+     *
      * If _negotiated is empty (meaning compression was not negotiated or is not supported), then
      * it will return a ref-count bumped copy of the input message.
      *
@@ -126,6 +140,14 @@ public:
     static MessageCompressorManager& forSession(const transport::SessionHandle& session);
 
 private:
+    /*
+     * Returns the compressor to use for a message with a body of 'messageSize' bytes, or nullptr
+     * if the message should be sent uncompressed. See compressMessage for the meaning of
+     * 'compressorId'.
+     */
+    MessageCompressorBase* _selectCompressor(size_t messageSize,
+                                             const MessageCompressorId* compressorId);
+
     std::vector<MessageCompressorBase*> _negotiated;
     MessageCompressorRegistry* _registry;
 };
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
@@ -37,6 +38,7 @@
 #include "mongo/transport/message_compressor_zlib.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/scopeguard.h"
 
 #include <string>
 #include <vector>
@@ -248,5 +250,83 @@ TEST(MessageCompressorManager, SERVER_28008) {
     ASSERT_EQ(compressorId, zlibId);
 }
 
+TEST(MessageCompressorManager, MessagesBelowMinSizeAreNotCompressed) {
+    auto registry = buildRegistry();
+    MessageCompressorManager manager(&registry);
+    BSONObjBuilder negotiatorOut;
+    manager.serverNegotiate(BSON("isMaster" << 1 << "compression" << BSON_ARRAY("noop")),
+                            &negotiatorOut);
+
+    networkMessageCompressionMinSizeBytes.store(1024);
+    ON_BLOCK_EXIT([] { networkMessageCompressionMinSizeBytes.store(0); });
+
+    auto compressed = assertOk(manager.compressMessage(buildMessage()));
+    ASSERT_EQ(compressed.operation(), dbQuery);
+
+    networkMessageCompressionMinSizeBytes.store(0);
+    compressed = assertOk(manager.compressMessage(buildMessage()));
+    ASSERT_EQ(compressed.operation(), dbCompressed);
+}
+
+TEST(MessageCompressorManager, LargeMessagesUseConfiguredCompressor) {
+    std::unique_ptr<MessageCompressorBase> zlibCompressor =
+        stdx::make_unique<ZlibMessageCompressor>();
+    const auto zlibId = zlibCompressor->getId();
+
+    std::unique_ptr<MessageCompressorBase> snappyCompressor =
+        stdx::make_unique<SnappyMessageCompressor>();
+    const auto snappyId = snappyCompressor->getId();
+
+    MessageCompressorRegistry registry;
+    registry.setSupportedCompressors({snappyCompressor->getName(), zlibCompressor->getName()});
+    registry.registerImplementation(std::move(zlibCompressor));
+    registry.registerImplementation(std::move(snappyCompressor));
+    ASSERT_OK(registry.finalizeSupportedCompressors());
+
+    MessageCompressorManager clientManager(&registry);
+    MessageCompressorManager serverManager(&registry);
+
+    BSONObjBuilder clientOutput;
+    clientManager.clientBegin(&clientOutput);
+    BSONObjBuilder serverOutput;
+    serverManager.serverNegotiate(clientOutput.done(), &serverOutput);
+    clientManager.clientFinish(serverOutput.done());
+
+    auto largeCompressorParam = ServerParameterSet::getGlobal()->getMap().find(
+        "networkMessageCompressorForLargeMessages");
+    ASSERT(largeCompressorParam != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(largeCompressorParam->second->setFromString("zlib"));
+    ON_BLOCK_EXIT([&] {
+        networkMessageCompressionLargeMessageSizeBytes.store(0);
+        largeCompressorParam->second->setFromString("").transitional_ignore();
+    });
+
+    // The test message has a 13 byte body, so it is only a large message for thresholds up to 13.
+    networkMessageCompressionLargeMessageSizeBytes.store(13);
+    MessageCompressorId compressorId;
+    auto toSend = assertOk(clientManager.compressMessage(buildMessage(), nullptr));
+    auto recvd = assertOk(serverManager.decompressMessage(toSend, &compressorId));
+    ASSERT_EQ(compressorId, zlibId);
+
+    // Below the threshold, a reply echoes the compressor that the request was sent with, and a
+    // new request uses the preferred compressor.
+    networkMessageCompressionLargeMessageSizeBytes.store(14);
+    toSend = assertOk(serverManager.compressMessage(recvd, &compressorId));
+    recvd = assertOk(clientManager.decompressMessage(toSend, &compressorId));
+    ASSERT_EQ(compressorId, zlibId);
+
+    toSend = assertOk(clientManager.compressMessage(buildMessage(), nullptr));
+    recvd = assertOk(serverManager.decompressMessage(toSend, &compressorId));
+    ASSERT_EQ(compressorId, snappyId);
+
+    // Each compression and decompression was accounted to the compressor which performed it.
+    auto zlib = registry.getCompressor(zlibId);
+    ASSERT_EQ(zlib->getCompressedMessages(), 2);
+    ASSERT_EQ(zlib->getDecompressedMessages(), 2);
+    auto snappy = registry.getCompressor(snappyId);
+    ASSERT_EQ(snappy->getCompressedMessages(), 1);
+    ASSERT_EQ(snappy->getDecompressedMessages(), 1);
+}
+
 }  // namespace mongo
 }  // namespace
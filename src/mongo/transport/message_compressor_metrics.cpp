@@ -35,6 +35,17 @@ namespace mongo {
 namespace {
 const auto kBytesIn = "bytesIn"_sd;
 const auto kBytesOut = "bytesOut"_sd;
+const auto kMessages = "messages"_sd;
+const auto kTimeMicros = "timeMicros"_sd;
+const auto kRatio = "ratio"_sd;
+
+// Returns the ratio of uncompressed to compressed bytes, or zero if nothing was processed yet.
+double compressionRatio(int64_t uncompressedBytes, int64_t compressedBytes) {
+    if (compressedBytes == 0) {
+        return 0;
+    }
+    return static_cast<double>(uncompressedBytes) / compressedBytes;
+}
 }  // namespace
 
 void appendMessageCompressionStats(BSONObjBuilder* b) {
@@ -51,12 +62,20 @@ void appendMessageCompressionStats(BSONObjBuilder* b) {
 
         BSONObjBuilder compressed(base.subobjStart("compressed"));
         compressed << kBytesIn << compressor->getCompressedBytesIn() << kBytesOut
-                   << compressor->getCompressedBytesOut();
+                   << compressor->getCompressedBytesOut() << kMessages
+                   << compressor->getCompressedMessages() << kTimeMicros
+                   << compressor->getCompressTimeMicros() << kRatio
+                   << compressionRatio(compressor->getCompressedBytesIn(),
+                                       compressor->getCompressedBytesOut());
         compressed.doneFast();
 
         BSONObjBuilder decompressed(base.subobjStart("decompressed"));
         decompressed << kBytesIn << compressor->getDecompressedBytesIn() << kBytesOut
-                     << compressor->getDecompressedBytesOut();
+                     << compressor->getDecompressedBytesOut() << kMessages
+                     << compressor->getDecompressedMessages() << kTimeMicros
+                     << compressor->getDecompressTimeMicros() << kRatio
+                     << compressionRatio(compressor->getDecompressedBytesOut(),
+                                         compressor->getDecompressedBytesIn());
         decompressed.doneFast();
         base.doneFast();
     }
@@ -0,0 +1,187 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd.h"
+
+#include <fstream>
+#include <iterator>
+
+#include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+#include <zstd.h>
+
+namespace mongo {
+namespace {
+
+// Compression level used by the zstd compressor. Lower levels are faster, higher levels compress
+// better; 1 to 3 are generally the right trade-off for network traffic.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(zstdMessageCompressorLevel, int, 1);
+
+// Path to a zstd dictionary trained on representative messages (for example with
+// "zstd --train"). Dictionaries substantially improve the compression of small command and
+// reply messages, but every peer must be started with the same dictionary.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(zstdMessageCompressorDictionaryFile, std::string, "");
+
+}  // namespace
+
+ZstdMessageCompressor::ZstdMessageCompressor(int level, const std::string& dictionary)
+    : MessageCompressorBase(MessageCompressor::kZstd), _level(level) {
+    if (dictionary.empty()) {
+        return;
+    }
+
+    _cdict = ZSTD_createCDict(dictionary.data(), dictionary.size(), _level);
+    _ddict = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    fassert(40620, _cdict && _ddict);
+
+    // Raw content dictionaries have no id, and frames compressed with them could not be told apart
+    // from frames compressed without a dictionary.
+    _dictId = ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size());
+    fassert(40621, _dictId != 0);
+}
+
+ZstdMessageCompressor::~ZstdMessageCompressor() {
+    ZSTD_freeCDict(_cdict);
+    ZSTD_freeDDict(_ddict);
+}
+
+std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
+                                                            DataRange output) {
+    size_t ret;
+    if (_cdict) {
+        std::unique_ptr<ZSTD_CCtx, size_t (*)(ZSTD_CCtx*)> cctx(ZSTD_createCCtx(), ZSTD_freeCCtx);
+        if (!cctx) {
+            return Status{ErrorCodes::ExceededMemoryLimit, "Could not allocate zstd context"};
+        }
+        ret = ZSTD_compress_usingCDict(cctx.get(),
+                                       const_cast<char*>(output.data()),
+                                       output.length(),
+                                       input.data(),
+                                       input.length(),
+                                       _cdict);
+    } else {
+        ret = ZSTD_compress(const_cast<char*>(output.data()),
+                            output.length(),
+                            input.data(),
+                            input.length(),
+                            _level);
+    }
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
+                                                              DataRange output) {
+    size_t ret;
+    const unsigned frameDictId = ZSTD_getDictID_fromFrame(input.data(), input.length());
+    if (frameDictId != 0) {
+        if (!_ddict || frameDictId != _dictId) {
+            return Status{ErrorCodes::BadValue,
+                          str::stream() << "Compressed message requires zstd dictionary "
+                                        << frameDictId
+                                        << ", which is not configured"};
+        }
+
+        std::unique_ptr<ZSTD_DCtx, size_t (*)(ZSTD_DCtx*)> dctx(ZSTD_createDCtx(), ZSTD_freeDCtx);
+        if (!dctx) {
+            return Status{ErrorCodes::ExceededMemoryLimit, "Could not allocate zstd context"};
+        }
+        ret = ZSTD_decompress_usingDDict(dctx.get(),
+                                         const_cast<char*>(output.data()),
+                                         output.length(),
+                                         input.data(),
+                                         input.length(),
+                                         _ddict);
+    } else {
+        ret = ZSTD_decompress(
+            const_cast<char*>(output.data()), output.length(), input.data(), input.length());
+    }
+
+    if (ZSTD_isError(ret)) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    counterHitDecompress(input.length(), ret);
+    return {ret};
+}
+
+
+MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    const int level = zstdMessageCompressorLevel;
+    if (level < 1 || level > ZSTD_maxCLevel()) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "zstdMessageCompressorLevel must be between 1 and "
+                                    << ZSTD_maxCLevel());
+    }
+
+    std::string dictionary;
+    const std::string& dictionaryFile = zstdMessageCompressorDictionaryFile;
+    if (!dictionaryFile.empty()) {
+        std::ifstream in(dictionaryFile, std::ios::binary);
+        if (!in) {
+            return Status(ErrorCodes::FileNotOpen,
+                          str::stream() << "Could not open zstd dictionary file "
+                                        << dictionaryFile);
+        }
+        dictionary.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        if (ZSTD_getDictID_fromDict(dictionary.data(), dictionary.size()) == 0) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << dictionaryFile << " is not a zstd dictionary");
+        }
+        log() << "Loaded " << dictionary.size() << " byte zstd message compression dictionary from "
+              << dictionaryFile;
+    }
+
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    compressorRegistry.registerImplementation(
+        stdx::make_unique<ZstdMessageCompressor>(level, dictionary));
+    return Status::OK();
+}
+}  // namespace mongo
@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+#include <zdict.h>
+
+namespace mongo {
+namespace {
+
+using unittest::assertGet;
+
+// Returns a small message resembling a command, with the given sequence number mixed in.
+std::string buildCommand(int i) {
+    return str::stream() << "{ find: \"collection" << i % 7 << "\", filter: { _id: " << i
+                         << ", status: \"" << (i % 3 ? "active" : "inactive")
+                         << "\" }, limit: " << i % 11 << ", $db: \"test\" }";
+}
+
+// Trains a dictionary from a set of commands built by buildCommand().
+std::string trainDictionary() {
+    std::string samples;
+    std::vector<size_t> sampleSizes;
+    for (int i = 0; i < 2000; ++i) {
+        auto sample = buildCommand(i);
+        samples += sample;
+        sampleSizes.push_back(sample.size());
+    }
+
+    std::string dictionary(4096, '\0');
+    size_t ret = ZDICT_trainFromBuffer(
+        &dictionary[0], dictionary.size(), samples.data(), sampleSizes.data(), sampleSizes.size());
+    ASSERT_FALSE(ZDICT_isError(ret));
+    dictionary.resize(ret);
+    return dictionary;
+}
+
+// Compresses 'input' with 'compressor' and returns the compressed bytes.
+std::string compress(ZstdMessageCompressor* compressor, const std::string& input) {
+    std::string output(compressor->getMaxCompressedSize(input.size()), '\0');
+    auto sw = compressor->compressData(ConstDataRange(input.data(), input.size()),
+                                       DataRange(&output[0], output.size()));
+    ASSERT_OK(sw.getStatus());
+    output.resize(sw.getValue());
+    return output;
+}
+
+// Decompresses 'input', which must decompress to 'size' bytes, with 'compressor'.
+StatusWith<std::string> decompress(ZstdMessageCompressor* compressor,
+                                   const std::string& input,
+                                   size_t size) {
+    std::string output(size, '\0');
+    auto sw = compressor->decompressData(ConstDataRange(input.data(), input.size()),
+                                         DataRange(&output[0], output.size()));
+    if (!sw.isOK()) {
+        return sw.getStatus();
+    }
+    ASSERT_EQ(size, sw.getValue());
+    return output;
+}
+
+TEST(ZstdMessageCompressor, RoundTripAtDifferentLevels) {
+    std::string input;
+    for (int i = 0; i < 100; ++i) {
+        input += buildCommand(i);
+    }
+
+    for (int level : {1, 3, 19}) {
+        ZstdMessageCompressor compressor(level);
+        auto compressed = compress(&compressor, input);
+        ASSERT_LT(compressed.size(), input.size());
+        ASSERT_EQ(input, assertGet(decompress(&compressor, compressed, input.size())));
+    }
+}
+
+TEST(ZstdMessageCompressor, DictionaryImprovesSmallMessages) {
+    const auto dictionary = trainDictionary();
+    ZstdMessageCompressor plain(1);
+    ZstdMessageCompressor withDictionary(1, dictionary);
+
+    const auto input = buildCommand(12345);
+    auto compressedPlain = compress(&plain, input);
+    auto compressedWithDictionary = compress(&withDictionary, input);
+    ASSERT_LT(compressedWithDictionary.size(), compressedPlain.size());
+
+    ASSERT_EQ(input,
+              assertGet(decompress(&withDictionary, compressedWithDictionary, input.size())));
+
+    // Messages compressed without a dictionary can still be read by a peer which has one.
+    ASSERT_EQ(input, assertGet(decompress(&withDictionary, compressedPlain, input.size())));
+
+    // A peer which lacks the dictionary reports an error instead of returning garbage.
+    ASSERT_EQ(ErrorCodes::BadValue,
+              decompress(&plain, compressedWithDictionary, input.size()).getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,444 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_thread_per_core.h"
+
+#include <algorithm>
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/scopeguard.h"
+
+#include <asio.hpp>
+
+namespace mongo {
+namespace transport {
+namespace {
+// The number of worker threads to run. If the value is -1 (the default), then it will be set to
+// the number of available cores.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(threadPerCoreServiceExecutorCores, int, -1);
+
+// Idle workers check the run queues for work to steal at least this often.
+MONGO_EXPORT_SERVER_PARAMETER(threadPerCoreServiceExecutorIdleWaitMillis, int, 10);
+
+// stuck detection
+MONGO_EXPORT_SERVER_PARAMETER(threadPerCoreServiceExecutorStuckThreadTimeoutMillis, int, 250);
+
+// The most reserve threads which may run at the same time to unblock stuck workers.
+MONGO_EXPORT_SERVER_PARAMETER(threadPerCoreServiceExecutorMaxReserveThreads, int, 8);
+
+// Identifies the worker, if any, which runs on the current thread.
+thread_local const ServiceExecutorThreadPerCore* localExecutor = nullptr;
+thread_local size_t localCoreId = 0;
+
+constexpr auto kTotalQueued = "totalQueued"_sd;
+constexpr auto kTotalExecuted = "totalExecuted"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
+constexpr auto kReserveThreadsStarted = "reserveThreadsStarted"_sd;
+constexpr auto kReserveThreadsRunning = "reserveThreadsRunning"_sd;
+constexpr auto kTasksQueued = "tasksQueued"_sd;
+constexpr auto kTasksExecuting = "tasksExecuting"_sd;
+constexpr auto kTotalTimeExecutingUs = "totalTimeExecutingMicros"_sd;
+constexpr auto kCores = "cores"_sd;
+constexpr auto kQueueDepth = "queueDepth"_sd;
+constexpr auto kExecuted = "executed"_sd;
+constexpr auto kStolen = "stolen"_sd;
+constexpr auto kStolenFrom = "stolenFrom"_sd;
+constexpr auto kExecutorLabel = "executor"_sd;
+constexpr auto kExecutorName = "threadPerCore"_sd;
+
+int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
+    invariant(tickSource->getTicksPerSecond() >= 1000000);
+    static const auto ticksPerMicro = tickSource->getTicksPerSecond() / 1000000;
+    return ticks / ticksPerMicro;
+}
+
+struct ServerParameterOptions : public ServiceExecutorThreadPerCore::Options {
+    int numCores() const final {
+        int value = threadPerCoreServiceExecutorCores;
+        if (value == -1) {
+            ProcessInfo pi;
+            value = pi.getNumAvailableCores().value_or(pi.getNumCores());
+            value = std::max(value, 1);
+            log() << "No core count configured for executor. Using number of cores: " << value;
+        }
+        return value;
+    }
+
+    Milliseconds idleWaitTime() const final {
+        return Milliseconds{threadPerCoreServiceExecutorIdleWaitMillis.load()};
+    }
+
+    Milliseconds stuckThreadTimeout() const final {
+        return Milliseconds{threadPerCoreServiceExecutorStuckThreadTimeoutMillis.load()};
+    }
+
+    int maxReserveThreads() const final {
+        return std::max(threadPerCoreServiceExecutorMaxReserveThreads.load(), 1);
+    }
+};
+
+}  // namespace
+
+ServiceExecutorThreadPerCore::ServiceExecutorThreadPerCore(ServiceContext* ctx,
+                                                           std::shared_ptr<asio::io_context> ioCtx)
+    : ServiceExecutorThreadPerCore(
+          ctx, std::move(ioCtx), stdx::make_unique<ServerParameterOptions>()) {}
+
+ServiceExecutorThreadPerCore::ServiceExecutorThreadPerCore(ServiceContext* ctx,
+                                                           std::shared_ptr<asio::io_context> ioCtx,
+                                                           std::unique_ptr<Options> config)
+    : _ioContext(std::move(ioCtx)), _config(std::move(config)), _tickSource(ctx->getTickSource()) {}
+
+ServiceExecutorThreadPerCore::~ServiceExecutorThreadPerCore() {
+    invariant(!_isRunning.load());
+}
+
+Status ServiceExecutorThreadPerCore::start() {
+    invariant(!_isRunning.load());
+    invariant(_cores.empty());
+
+    const int numCores = _config->numCores();
+    if (numCores < 1) {
+        return {ErrorCodes::BadValue, "threadPerCore service executor needs at least one core"};
+    }
+
+    for (int i = 0; i < numCores; ++i) {
+        _cores.emplace_back(stdx::make_unique<Core>());
+    }
+
+    _isRunning.store(true);
+    for (size_t i = 0; i < _cores.size(); ++i) {
+        _cores[i]->thread =
+            stdx::thread(&ServiceExecutorThreadPerCore::_workerThreadRoutine, this, i);
+    }
+    _controllerThread = stdx::thread(&ServiceExecutorThreadPerCore::_controllerThreadRoutine, this);
+
+    return Status::OK();
+}
+
+Status ServiceExecutorThreadPerCore::shutdown() {
+    if (!_isRunning.load())
+        return Status::OK();
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_controllerMutex);
+        _isRunning.store(false);
+    }
+    _controllerCondition.notify_one();
+    _controllerThread.join();
+
+    _ioContext->stop();
+
+    // No reserve threads are started once the controller has stopped.
+    for (auto& reserveThread : _reserveThreads) {
+        reserveThread->thread.join();
+    }
+    _reserveThreads.clear();
+    _reserveThreadsRunning.store(0);
+
+    for (auto& core : _cores) {
+        core->thread.join();
+
+        // Outstanding tasks are dropped.
+        stdx::lock_guard<stdx::mutex> lk(core->mutex);
+        core->queue.clear();
+        core->queueDepth.store(0);
+    }
+
+    return Status::OK();
+}
+
+Status ServiceExecutorThreadPerCore::schedule(Task task, ScheduleFlags flags) {
+    invariant(!_cores.empty());
+
+    // Keep tasks scheduled by a worker on that worker's core, so that each connection tends to
+    // stay on one core for as long as the load is balanced.
+    const bool fromWorker = (localExecutor == this);
+    const size_t coreId = fromWorker ? localCoreId : _nextCore.fetchAndAdd(1) % _cores.size();
+    Core* core = _cores[coreId].get();
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(core->mutex);
+        core->queue.emplace_back(std::move(task));
+        core->queueDepth.addAndFetch(1);
+    }
+    _totalQueued.addAndFetch(1);
+
+    // A worker checks its own run queue before it waits on the io_context again, but other workers
+    // may all be waiting for network activity. Wake one of them up so that it either runs the task
+    // on its own core or steals it.
+    if (!fromWorker && !(flags & DeferredTask)) {
+        _ioContext->post([] {});
+    }
+
+    return Status::OK();
+}
+
+ServiceExecutorThreadPerCore::Task ServiceExecutorThreadPerCore::_popLocalTask(Core* core) {
+    stdx::lock_guard<stdx::mutex> lk(core->mutex);
+    if (core->queue.empty()) {
+        return Task();
+    }
+
+    auto task = std::move(core->queue.front());
+    core->queue.pop_front();
+    core->queueDepth.subtractAndFetch(1);
+    return task;
+}
+
+ServiceExecutorThreadPerCore::Task ServiceExecutorThreadPerCore::_stealTask(size_t thiefId) {
+    for (size_t i = 1; i < _cores.size(); ++i) {
+        Core* victim = _cores[(thiefId + i) % _cores.size()].get();
+        if (victim->queueDepth.load() == 0) {
+            continue;
+        }
+
+        // Don't wait on a core which is busy with its own queue, try the next one instead.
+        stdx::unique_lock<stdx::mutex> lk(victim->mutex, stdx::try_to_lock);
+        if (!lk.owns_lock() || victim->queue.empty()) {
+            continue;
+        }
+
+        // Take the newest task, leaving the older ones to the core that owns them.
+        auto task = std::move(victim->queue.back());
+        victim->queue.pop_back();
+        victim->queueDepth.subtractAndFetch(1);
+        lk.unlock();
+
+        victim->stolenFrom.addAndFetch(1);
+        _cores[thiefId]->stolen.addAndFetch(1);
+        return task;
+    }
+
+    return Task();
+}
+
+ServiceExecutorThreadPerCore::Task ServiceExecutorThreadPerCore::_popAnyTask() {
+    for (auto& core : _cores) {
+        if (core->queueDepth.load() == 0) {
+            continue;
+        }
+
+        // The owner of this core may be blocked, so take its oldest task, which has waited longest.
+        auto task = _popLocalTask(core.get());
+        if (task) {
+            return task;
+        }
+    }
+
+    return Task();
+}
+
+void ServiceExecutorThreadPerCore::_runTask(Core* core, const Task& task) {
+    auto start = _tickSource->getTicks();
+    _tasksExecuting.addAndFetch(1);
+
+    const auto guard = MakeGuard([this, core, start] {
+        _tasksExecuting.subtractAndFetch(1);
+        if (core) {
+            core->executed.addAndFetch(1);
+        } else {
+            _reserveExecuted.addAndFetch(1);
+        }
+        _totalSpentExecuting.addAndFetch(_tickSource->getTicks() - start);
+    });
+
+    task();
+}
+
+void ServiceExecutorThreadPerCore::_workerThreadRoutine(size_t coreId) {
+    {
+        std::string threadName = str::stream() << "worker-core-" << coreId;
+        setThreadName(threadName);
+    }
+
+    log() << "Starting database worker thread for core " << coreId;
+
+    localExecutor = this;
+    localCoreId = coreId;
+    const auto guard = MakeGuard([] { localExecutor = nullptr; });
+
+    Core* core = _cores[coreId].get();
+    asio::io_context::work work(*_ioContext);
+
+    while (_isRunning.load()) {
+        try {
+            auto task = _popLocalTask(core);
+            if (!task) {
+                task = _stealTask(coreId);
+            }
+
+            if (task) {
+                _runTask(core, task);
+
+                // Let network completions make progress between tasks, so that a busy run queue
+                // cannot starve them.
+                _ioContext->poll_one();
+            } else {
+                _ioContext->run_one_for(_config->idleWaitTime().toSystemDuration());
+            }
+
+            if (_ioContext->stopped() && _isRunning.load())
+                _ioContext->restart();
+        } catch (const std::exception& e) {
+            log() << "Exception escaped worker thread for core " << coreId << ": " << e.what();
+        } catch (...) {
+            log() << "Unknown exception escaped worker thread for core " << coreId;
+        }
+    }
+}
+
+bool ServiceExecutorThreadPerCore::_isStuck(int64_t* lastExecuted) const {
+    int64_t executed = _reserveExecuted.load();
+    int tasksQueued = 0;
+    for (const auto& core : _cores) {
+        executed += core->executed.load();
+        tasksQueued += core->queueDepth.load();
+    }
+
+    // Idle workers pick up queued tasks within their idle wait time, so tasks which stay queued
+    // while no task completes mean that every thread is blocked in a task.
+    const bool isStuck = (tasksQueued > 0) && (executed == *lastExecuted);
+    *lastExecuted = executed;
+    return isStuck;
+}
+
+void ServiceExecutorThreadPerCore::_controllerThreadRoutine() {
+    setThreadName("worker-controller"_sd);
+
+    int64_t lastExecuted = -1;
+    stdx::unique_lock<stdx::mutex> lk(_controllerMutex);
+    while (_isRunning.load()) {
+        _controllerCondition.wait_for(lk,
+                                      _config->stuckThreadTimeout().toSystemDuration(),
+                                      [this] { return !_isRunning.load(); });
+
+        // If the executor has stopped, then stop the controller altogether
+        if (!_isRunning.load())
+            break;
+
+        _reapReserveThreads_inlock();
+
+        if (!_isStuck(&lastExecuted))
+            continue;
+
+        const int maxReserveThreads = _config->maxReserveThreads();
+        if (_reserveThreads.size() >= static_cast<size_t>(maxReserveThreads)) {
+            LOG(1) << "Detected blocked worker threads, but " << maxReserveThreads
+                   << " reserve threads are already running";
+            continue;
+        }
+
+        log() << "Detected blocked worker threads, "
+              << "starting a reserve thread to unblock service executor";
+        _reserveThreadsStarted.addAndFetch(1);
+        auto reserveThread = stdx::make_unique<ReserveThread>();
+        reserveThread->thread = stdx::thread(
+            &ServiceExecutorThreadPerCore::_reserveThreadRoutine, this, reserveThread.get());
+        _reserveThreads.emplace_back(std::move(reserveThread));
+        _reserveThreadsRunning.store(static_cast<int>(_reserveThreads.size()));
+    }
+}
+
+void ServiceExecutorThreadPerCore::_reapReserveThreads_inlock() {
+    auto finishedBegin = std::partition(
+        _reserveThreads.begin(),
+        _reserveThreads.end(),
+        [](const std::unique_ptr<ReserveThread>& reserveThread) {
+            return !reserveThread->finished.load();
+        });
+    for (auto it = finishedBegin; it != _reserveThreads.end(); ++it) {
+        (*it)->thread.join();
+    }
+    _reserveThreads.erase(finishedBegin, _reserveThreads.end());
+    _reserveThreadsRunning.store(static_cast<int>(_reserveThreads.size()));
+}
+
+void ServiceExecutorThreadPerCore::_reserveThreadRoutine(ReserveThread* reserveThread) {
+    setThreadName("worker-reserve"_sd);
+    const auto guard = MakeGuard([reserveThread] { reserveThread->finished.store(true); });
+
+    // Run the queued tasks until they are drained. If the tasks run here block as well, the
+    // controller starts another reserve thread, unless too many are running already.
+    while (_isRunning.load()) {
+        try {
+            auto task = _popAnyTask();
+            if (!task)
+                break;
+
+            _runTask(nullptr, task);
+            _ioContext->poll_one();
+        } catch (const std::exception& e) {
+            log() << "Exception escaped reserve worker thread: " << e.what();
+        } catch (...) {
+            log() << "Unknown exception escaped reserve worker thread";
+        }
+    }
+}
+
+void ServiceExecutorThreadPerCore::appendStats(BSONObjBuilder* bob) const {
+    int64_t totalExecuted = _reserveExecuted.load();
+    int64_t totalStolen = 0;
+    int tasksQueued = 0;
+    for (const auto& core : _cores) {
+        totalExecuted += core->executed.load();
+        totalStolen += core->stolen.load();
+        tasksQueued += core->queueDepth.load();
+    }
+
+    BSONObjBuilder section(bob->subobjStart("serviceExecutorTaskStats"));
+    section << kExecutorLabel << kExecutorName  //
+            << kTotalQueued << _totalQueued.load() << kTotalExecuted << totalExecuted
+            << kTotalStolen << totalStolen << kReserveThreadsStarted
+            << _reserveThreadsStarted.load() << kReserveThreadsRunning
+            << _reserveThreadsRunning.load() << kTasksQueued << tasksQueued << kTasksExecuting
+            << _tasksExecuting.load() << kTotalTimeExecutingUs
+            << ticksToMicros(_totalSpentExecuting.load(), _tickSource);
+
+    BSONArrayBuilder coresBuilder(section.subarrayStart(kCores));
+    for (const auto& core : _cores) {
+        BSONObjBuilder coreBuilder(coresBuilder.subobjStart());
+        coreBuilder << kQueueDepth << core->queueDepth.load() << kExecuted << core->executed.load()
+                    << kStolen << core->stolen.load() << kStolenFrom << core->stolenFrom.load();
+        coreBuilder.doneFast();
+    }
+    coresBuilder.doneFast();
+
+    section.doneFast();
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,208 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/util/tick_source.h"
+
+#include <asio.hpp>
+
+namespace mongo {
+namespace transport {
+
+/**
+ * This is an ASIO-based ServiceExecutor which runs a fixed set of worker threads, one per core,
+ * each with its own run queue.
+ *
+ * Tasks scheduled from a worker thread are queued on that worker's own run queue, so a connection
+ * whose state machine keeps rescheduling itself stays on the core it started on. Tasks scheduled
+ * from any other thread (for example the listener) are spread over the run queues round-robin.
+ * A worker whose run queue is empty steals queued tasks from the other workers before it goes back
+ * to waiting on the shared io_context for network completions.
+ *
+ * Since the number of workers is fixed, tasks which block their worker could leave the queued
+ * tasks, including the ones which would unblock them, without a thread to run them. A controller
+ * thread therefore watches for rounds in which tasks stay queued but none completes, and then
+ * starts a reserve thread, which runs the queued tasks until the queues are drained. The number of
+ * reserve threads running at once is capped, and the controller joins the ones which have exited.
+ */
+class ServiceExecutorThreadPerCore : public ServiceExecutor {
+public:
+    struct Options {
+        virtual ~Options() = default;
+
+        // The number of worker threads (and run queues) the executor runs.
+        virtual int numCores() const = 0;
+
+        // The longest time an idle worker waits on the io_context before checking the run queues
+        // again.
+        virtual Milliseconds idleWaitTime() const = 0;
+
+        // How long tasks may stay queued without any task completing before the workers are
+        // considered stuck, and a reserve thread is started.
+        virtual Milliseconds stuckThreadTimeout() const = 0;
+
+        // The most reserve threads which may run at the same time.
+        virtual int maxReserveThreads() const = 0;
+    };
+
+    explicit ServiceExecutorThreadPerCore(ServiceContext* ctx,
+                                          std::shared_ptr<asio::io_context> ioCtx);
+    explicit ServiceExecutorThreadPerCore(ServiceContext* ctx,
+                                          std::shared_ptr<asio::io_context> ioCtx,
+                                          std::unique_ptr<Options> config);
+
+    virtual ~ServiceExecutorThreadPerCore();
+
+    Status start() final;
+    Status shutdown() final;
+    Status schedule(Task task, ScheduleFlags flags) final;
+
+    void appendStats(BSONObjBuilder* bob) const final;
+
+    size_t numCores() const {
+        return _cores.size();
+    }
+
+private:
+    /**
+     * The run queue and statistics of a single worker thread.
+     */
+    struct Core {
+        // Synchronizes access to 'queue'.
+        stdx::mutex mutex;
+        std::deque<Task> queue;
+
+        stdx::thread thread;
+
+        // Number of tasks in 'queue', readable without the mutex for reporting.
+        AtomicWord<int> queueDepth{0};
+
+        // Number of tasks executed by this worker, including the stolen ones.
+        AtomicWord<int64_t> executed{0};
+
+        // Number of tasks this worker stole from other workers.
+        AtomicWord<int64_t> stolen{0};
+
+        // Number of tasks other workers stole from this worker's queue.
+        AtomicWord<int64_t> stolenFrom{0};
+    };
+
+    /**
+     * A reserve thread, which flags when it is about to exit so that the controller can join it.
+     */
+    struct ReserveThread {
+        stdx::thread thread;
+        AtomicWord<bool> finished{false};
+    };
+
+    void _workerThreadRoutine(size_t coreId);
+    void _controllerThreadRoutine();
+    void _reserveThreadRoutine(ReserveThread* reserveThread);
+
+    /**
+     * Joins the reserve threads which have exited and forgets about them.
+     */
+    void _reapReserveThreads_inlock();
+
+    /**
+     * Returns whether tasks are queued while the workers and reserve threads completed no task
+     * since 'lastExecuted' tasks were completed, and updates 'lastExecuted'.
+     */
+    bool _isStuck(int64_t* lastExecuted) const;
+
+    /**
+     * Pops the oldest task from the given core's queue. Returns an empty task if there is none.
+     */
+    Task _popLocalTask(Core* core);
+
+    /**
+     * Pops the newest task from the queue of another core, without waiting for a core that is
+     * busy. Returns an empty task if there is nothing to steal.
+     */
+    Task _stealTask(size_t thiefId);
+
+    /**
+     * Pops the oldest task queued on any core, for a reserve thread. Returns an empty task if all
+     * the queues are empty.
+     */
+    Task _popAnyTask();
+
+    /**
+     * Runs the task, accounting it to the given core, or to the reserve threads if 'core' is null.
+     */
+    void _runTask(Core* core, const Task& task);
+
+    std::shared_ptr<asio::io_context> _ioContext;
+
+    std::unique_ptr<Options> _config;
+
+    TickSource* const _tickSource;
+    AtomicWord<bool> _isRunning{false};
+
+    // The cores are created on start() and never change afterwards, so the vector itself can be
+    // read without synchronization.
+    std::vector<std::unique_ptr<Core>> _cores;
+
+    // Used to spread tasks scheduled from threads other than the workers.
+    AtomicWord<unsigned> _nextCore{0};
+
+    stdx::thread _controllerThread;
+
+    // Synchronizes access to '_reserveThreads', and lets shutdown() wake up the controller.
+    stdx::mutex _controllerMutex;
+    stdx::condition_variable _controllerCondition;
+
+    // Reserve threads started to unblock the workers. They exit once the queues are drained, and
+    // are joined by the controller after that or on shutdown.
+    std::vector<std::unique_ptr<ReserveThread>> _reserveThreads;
+
+    // Number of tasks executed by the reserve threads, number of reserve threads started, and
+    // number of reserve threads which have not been joined yet.
+    AtomicWord<int64_t> _reserveExecuted{0};
+    AtomicWord<int64_t> _reserveThreadsStarted{0};
+    AtomicWord<int> _reserveThreadsRunning{0};
+
+    // These counters are only used for reporting in serverStatus.
+    AtomicWord<int64_t> _totalQueued{0};
+    AtomicWord<int> _tasksExecuting{0};
+    AtomicWord<TickSource::Tick> _totalSpentExecuting{0};
+};
+
+}  // namespace transport
+}  // namespace mongo
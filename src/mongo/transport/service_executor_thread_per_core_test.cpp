@@ -0,0 +1,265 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault;
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/transport/service_executor_thread_per_core.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+#include <asio.hpp>
+
+namespace mongo {
+namespace {
+using namespace transport;
+
+struct TestOptions : public ServiceExecutorThreadPerCore::Options {
+    int numCores() const final {
+        return 2;
+    }
+
+    Milliseconds idleWaitTime() const final {
+        return Milliseconds{5};
+    }
+
+    Milliseconds stuckThreadTimeout() const final {
+        return Milliseconds{50};
+    }
+
+    int maxReserveThreads() const final {
+        return 1;
+    }
+};
+
+class ServiceExecutorThreadPerCoreFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        auto scOwned = stdx::make_unique<ServiceContextNoop>();
+        setGlobalServiceContext(std::move(scOwned));
+        asioIoCtx = std::make_shared<asio::io_context>();
+    }
+
+    std::unique_ptr<ServiceExecutorThreadPerCore> makeAndStartExecutor() {
+        auto exec = stdx::make_unique<ServiceExecutorThreadPerCore>(
+            getGlobalServiceContext(), asioIoCtx, stdx::make_unique<TestOptions>());
+        ASSERT_OK(exec->start());
+        ASSERT_EQ(exec->numCores(), 2U);
+        return exec;
+    }
+
+    BSONObj getStats(ServiceExecutor* exec) {
+        BSONObjBuilder bob;
+        exec->appendStats(&bob);
+        return bob.obj().getObjectField("serviceExecutorTaskStats").getOwned();
+    }
+
+    std::shared_ptr<asio::io_context> asioIoCtx;
+};
+
+/*
+ * This tests that tasks scheduled from outside of the executor's threads are run.
+ */
+TEST_F(ServiceExecutorThreadPerCoreFixture, TestScheduleFromOutside) {
+    auto exec = makeAndStartExecutor();
+    auto guard = MakeGuard([&] { ASSERT_OK(exec->shutdown()); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    int remaining = 10;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_OK(exec->schedule(
+            [&] {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                --remaining;
+                cond.notify_one();
+            },
+            ServiceExecutor::EmptyFlags));
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    cond.wait(lk, [&] { return remaining == 0; });
+    lk.unlock();
+
+    auto stats = getStats(exec.get());
+    ASSERT_EQ(stats.getStringField("executor"), std::string("threadPerCore"));
+    ASSERT_EQ(stats.getIntField("totalQueued"), 10);
+    ASSERT_EQ(stats.getObjectField("cores").nFields(), 2);
+}
+
+/*
+ * This tests that a task queued on a core whose worker is blocked gets stolen and run by the
+ * other worker.
+ */
+TEST_F(ServiceExecutorThreadPerCoreFixture, TestWorkStealing) {
+    auto exec = makeAndStartExecutor();
+    auto guard = MakeGuard([&] { ASSERT_OK(exec->shutdown()); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    bool stolenTaskRan = false;
+
+    // The outer task schedules the inner one from a worker thread, which queues it on that
+    // worker's own core, and then blocks that worker until the inner task has run. The inner task
+    // can therefore only run if the other worker steals it.
+    ASSERT_OK(exec->schedule(
+        [&] {
+            ASSERT_OK(exec->schedule(
+                [&] {
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    stolenTaskRan = true;
+                    cond.notify_all();
+                },
+                ServiceExecutor::EmptyFlags));
+
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            cond.wait(lk, [&] { return stolenTaskRan; });
+        },
+        ServiceExecutor::EmptyFlags));
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return stolenTaskRan; });
+    }
+
+    auto stats = getStats(exec.get());
+    ASSERT_EQ(stats.getIntField("totalStolen"), 1);
+}
+
+/*
+ * This tests that a task, which is queued while every worker is blocked waiting for it, is run by
+ * a reserve thread.
+ */
+TEST_F(ServiceExecutorThreadPerCoreFixture, TestStuckWorkersStartReserveThread) {
+    auto exec = makeAndStartExecutor();
+    auto guard = MakeGuard([&] { ASSERT_OK(exec->shutdown()); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    int blockedWorkers = 0;
+    bool unblocked = false;
+
+    // Block both workers until the unblocking task has run.
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_OK(exec->schedule(
+            [&] {
+                stdx::unique_lock<stdx::mutex> lk(mutex);
+                ++blockedWorkers;
+                cond.notify_all();
+                cond.wait(lk, [&] { return unblocked; });
+            },
+            ServiceExecutor::EmptyFlags));
+    }
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return blockedWorkers == 2; });
+    }
+
+    ASSERT_OK(exec->schedule(
+        [&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            unblocked = true;
+            cond.notify_all();
+        },
+        ServiceExecutor::EmptyFlags));
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return unblocked; });
+    }
+
+    auto stats = getStats(exec.get());
+    ASSERT_GTE(stats.getIntField("reserveThreadsStarted"), 1);
+}
+
+TEST_F(ServiceExecutorThreadPerCoreFixture, TestReserveThreadsAreCappedAndJoined) {
+    auto exec = makeAndStartExecutor();
+    auto guard = MakeGuard([&] { ASSERT_OK(exec->shutdown()); });
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    int blockedThreads = 0;
+    bool unblocked = false;
+    bool lastTaskRan = false;
+
+    // Block both workers and the reserve thread started to run the third task.
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_OK(exec->schedule(
+            [&] {
+                stdx::unique_lock<stdx::mutex> lk(mutex);
+                ++blockedThreads;
+                cond.notify_all();
+                cond.wait(lk, [&] { return unblocked; });
+            },
+            ServiceExecutor::EmptyFlags));
+    }
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return blockedThreads == 3; });
+    }
+
+    ASSERT_OK(exec->schedule(
+        [&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            lastTaskRan = true;
+            cond.notify_all();
+        },
+        ServiceExecutor::EmptyFlags));
+
+    // The threads stay stuck for many controller rounds, but no more than one reserve thread runs.
+    sleepmillis(500);
+    auto stats = getStats(exec.get());
+    ASSERT_EQ(stats.getIntField("reserveThreadsStarted"), 1);
+    ASSERT_EQ(stats.getIntField("reserveThreadsRunning"), 1);
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        ASSERT_FALSE(lastTaskRan);
+        unblocked = true;
+        cond.notify_all();
+        cond.wait(lk, [&] { return lastTaskRan; });
+    }
+
+    // The reserve thread exits once the queues are drained, and the controller joins it.
+    for (int i = 0; i < 100; ++i) {
+        if (getStats(exec.get()).getIntField("reserveThreadsRunning") == 0) {
+            break;
+        }
+        sleepmillis(50);
+    }
+    ASSERT_EQ(getStats(exec.get()).getIntField("reserveThreadsRunning"), 0);
+}
+
+}  // namespace
+}  // namespace mongo
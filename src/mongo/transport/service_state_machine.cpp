@@ -48,6 +48,7 @@
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/op_msg.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/net/thread_idle_callback.h"
 #include "mongo/util/quick_exit.h"
@@ -87,6 +88,22 @@ bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
     return true;
 }
 
+// Rebuild the OP_MSG getMore that produces the next batch of an OP_MSG exhaust stream. The id of
+// the rebuilt request is that of the reply just sent, so each reply answers the one before it.
+void setOpMsgExhaustMessage(Message* m, const DbResponse& dbresponse) {
+    invariant(dbresponse.shouldRunAgainForExhaust);
+    invariant(!dbresponse.nextInvocation.isEmpty());
+
+    OpMsgBuilder builder;
+    builder.setBody(dbresponse.nextInvocation);
+    auto exhaustMessage = builder.finish();
+    OpMsg::setFlag(&exhaustMessage, OpMsg::kExhaustAllowed);
+    exhaustMessage.header().setId(dbresponse.response.header().getId());
+    exhaustMessage.header().setResponseToMsgId(dbresponse.response.header().getResponseToMsgId());
+
+    *m = std::move(exhaustMessage);
+}
+
 }  // namespace
 
 using transport::TransportLayer;
@@ -330,6 +347,9 @@ void ServiceStateMachine::_processMessage(ThreadGuard& guard) {
         // If this is an exhaust cursor, don't source more Messages
         if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&_inMessage, dbresponse)) {
             _inExhaust = true;
+        } else if (dbresponse.shouldRunAgainForExhaust) {
+            setOpMsgExhaustMessage(&_inMessage, dbresponse);
+            _inExhaust = true;
         } else {
             _inExhaust = false;
             _inMessage.reset();
@@ -62,6 +62,11 @@ public:
         ASSERT_TRUE(haveClient());
 
         auto req = OpMsgRequest::parse(request);
+        if (_exhaustRepliesLeft) {
+            ASSERT_BSONOBJ_EQ(kExhaustCmd, req.body);
+            ASSERT_TRUE(OpMsg::isFlagSet(request, OpMsg::kExhaustAllowed));
+            return _makeExhaustReply();
+        }
         ASSERT_BSONOBJ_EQ(BSON("ping" << 1), req.body);
 
         // Build out a dummy reply
@@ -80,6 +85,13 @@ public:
         _uassertInHandler = true;
     }
 
+    // Answer the next 'count' requests as an OP_MSG exhaust stream of kExhaustCmd.
+    void setExhaustReplies(int count) {
+        _exhaustRepliesLeft = count;
+    }
+
+    static const BSONObj kExhaustCmd;
+
     bool ranHandler() {
         bool ret = _ranHandler;
         _ranHandler = false;
@@ -87,10 +99,30 @@ public:
     }
 
 private:
+    DbResponse _makeExhaustReply() {
+        --_exhaustRepliesLeft;
+
+        OpMsgBuilder builder;
+        builder.setBody(BSON("ok" << 1));
+        DbResponse dbResponse{builder.finish()};
+        if (_exhaustRepliesLeft) {
+            OpMsg::setFlag(&dbResponse.response, OpMsg::kMoreToCome);
+            dbResponse.shouldRunAgainForExhaust = true;
+            dbResponse.nextInvocation = kExhaustCmd;
+        }
+        return dbResponse;
+    }
+
     bool _uassertInHandler = false;
     bool _ranHandler = false;
+    int _exhaustRepliesLeft = 0;
 };
 
+const BSONObj MockSEP::kExhaustCmd = BSON("getMore" << 1LL << "collection"
+                                                    << "oplog.rs"
+                                                    << "$db"
+                                                    << "local");
+
 using namespace transport;
 class MockTL : public TransportLayerMock {
 public:
@@ -177,6 +209,10 @@ public:
         return _ranSource;
     }
 
+    void resetRanSource() {
+        _ranSource = false;
+    }
+
 private:
     bool _lastTicketSource = true;
     bool _ranSink = false;
@@ -283,6 +319,30 @@ TEST_F(ServiceStateMachineFixture, TestSinkError) {
     ASSERT_TRUE(_tl->ranSink());
 }
 
+TEST_F(ServiceStateMachineFixture, TestOpMsgExhaustRunsWithoutSourcing) {
+    _sep->setExhaustReplies(3);
+    auto request = buildRequest(MockSEP::kExhaustCmd);
+    OpMsg::setFlag(&request, OpMsg::kExhaustAllowed);
+    _tl->setNextMessage(std::move(request));
+
+    // The first reply streams, so the state machine goes straight back to processing.
+    _ssm->runNext();
+    ASSERT_EQ(ServiceStateMachine::State::Process, _ssm->state());
+    ASSERT_TRUE(OpMsg::isFlagSet(_tl->getLastSunk(), OpMsg::kMoreToCome));
+
+    _tl->resetRanSource();
+    _ssm->runNext();
+    ASSERT_EQ(ServiceStateMachine::State::Process, _ssm->state());
+    ASSERT_FALSE(_tl->ranSource());
+    ASSERT_TRUE(OpMsg::isFlagSet(_tl->getLastSunk(), OpMsg::kMoreToCome));
+
+    // The last reply ends the stream and the next request is read from the client.
+    _ssm->runNext();
+    ASSERT_EQ(ServiceStateMachine::State::Source, _ssm->state());
+    ASSERT_FALSE(_tl->ranSource());
+    ASSERT_FALSE(OpMsg::isFlagSet(_tl->getLastSunk(), OpMsg::kMoreToCome));
+}
+
 // This test checks that after the SSM has been cleaned up, the SessionHandle that it passed
 // into the Client doesn't have any dangling shared_ptr copies.
 TEST_F(ServiceStateMachineFixture, TestSessionCleanupOnDestroy) {
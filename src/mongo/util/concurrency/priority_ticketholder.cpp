@@ -0,0 +1,341 @@
+/*    Copyright 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/priority_ticketholder.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/system_clock_source.h"
+
+namespace mongo {
+
+namespace {
+
+// A saturated sizing window whose throughput is more than this fraction below that of the
+// previous saturated window counts as congested.
+const double kThroughputDropTolerance = 0.1;
+
+// Factor by which the limit is cut after a congested sizing window.
+const double kLimitDecreaseFactor = 0.75;
+
+}  // namespace
+
+constexpr int PriorityTicketHolder::kNumPriorities;
+constexpr size_t PriorityTicketHolder::kNumQueueTimeBuckets;
+const Milliseconds PriorityTicketHolder::kDefaultAgingInterval(100);
+const Milliseconds PriorityTicketHolder::kSizingWindow(500);
+const std::array<int, PriorityTicketHolder::kNumQueueTimeBuckets - 1>
+    PriorityTicketHolder::kQueueTimeBucketBoundsMillis{{1, 2, 5, 10, 50, 100, 1000}};
+
+StatusWith<AdmissionPriority> parseAdmissionPriority(StringData value) {
+    if (value == "low") {
+        return AdmissionPriority::kLow;
+    }
+    if (value == "normal") {
+        return AdmissionPriority::kNormal;
+    }
+    if (value == "high") {
+        return AdmissionPriority::kHigh;
+    }
+    return Status(ErrorCodes::BadValue,
+                  str::stream() << "Unknown priority '" << value
+                                << "'; must be one of 'low', 'normal' or 'high'");
+}
+
+StringData toString(AdmissionPriority priority) {
+    switch (priority) {
+        case AdmissionPriority::kLow:
+            return "low";
+        case AdmissionPriority::kNormal:
+            return "normal";
+        case AdmissionPriority::kHigh:
+            return "high";
+    }
+    MONGO_UNREACHABLE;
+}
+
+PriorityTicketHolder::PriorityTicketHolder(int num,
+                                           ClockSource* clockSource,
+                                           Milliseconds agingInterval)
+    : _clockSource(clockSource ? clockSource : SystemClockSource::get()),
+      _agingInterval(agingInterval),
+      _maxTickets(num),
+      _limit(num) {
+    invariant(_agingInterval > Milliseconds(0));
+}
+
+bool PriorityTicketHolder::tryAcquire() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_queued > 0 || _used >= _limit) {
+        return false;
+    }
+
+    ++_used;
+    _recordQueueTime_inlock(Milliseconds(0));
+    return true;
+}
+
+void PriorityTicketHolder::waitForTicket(AdmissionPriority priority) {
+    invariant(_acquire(priority, Date_t::max()));
+}
+
+bool PriorityTicketHolder::waitForTicketUntil(Date_t until, AdmissionPriority priority) {
+    return _acquire(priority, until);
+}
+
+bool PriorityTicketHolder::_acquire(AdmissionPriority priority, Date_t until) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    // Don't overtake anybody who is already queued, whatever their priority.
+    if (_queued == 0 && _used < _limit) {
+        ++_used;
+        _recordQueueTime_inlock(Milliseconds(0));
+        return true;
+    }
+
+    Waiter waiter(priority, _clockSource->now());
+    auto& queue = _queues[static_cast<int>(priority)];
+    waiter.position = queue.insert(queue.end(), &waiter);
+    ++_queued;
+
+    while (!waiter.granted) {
+        if (until == Date_t::max()) {
+            waiter.cv.wait(lk);
+        } else if (waiter.cv.wait_until(lk, until.toSystemTimePoint()) ==
+                       stdx::cv_status::timeout &&
+                   !waiter.granted) {
+            queue.erase(waiter.position);
+            --_queued;
+            return false;
+        }
+    }
+
+    // Whoever granted the ticket has already dequeued us and counted the ticket as used.
+    _recordQueueTime_inlock(_clockSource->now() - waiter.enqueuedAt);
+    return true;
+}
+
+void PriorityTicketHolder::release() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_used > 0);
+    --_used;
+
+    _updateLimit_inlock();
+    _grantTickets_inlock();
+}
+
+Status PriorityTicketHolder::resize(int newSize) {
+    if (newSize <= 0) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Number of tickets has to be > 0; given " << newSize);
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _maxTickets = newSize;
+    _limit = _dynamicSizing ? std::min(std::max(_limit, _minTickets), _maxTickets) : _maxTickets;
+
+    _grantTickets_inlock();
+    return Status::OK();
+}
+
+void PriorityTicketHolder::setDynamicSizing(bool enabled, int minTickets) {
+    invariant(minTickets > 0);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _dynamicSizing = enabled;
+    _minTickets = minTickets;
+    _limit = _maxTickets;
+
+    _windowStart = _clockSource->now();
+    _releasedInWindow = 0;
+    _saturatedInWindow = false;
+    _lastAdjustmentWasDecrease = false;
+    _lastThroughput = 0;
+
+    _grantTickets_inlock();
+}
+
+int PriorityTicketHolder::available() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return std::max(_limit - _used, 0);
+}
+
+int PriorityTicketHolder::used() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _used;
+}
+
+int PriorityTicketHolder::outof() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _limit;
+}
+
+int PriorityTicketHolder::maxTickets() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _maxTickets;
+}
+
+int PriorityTicketHolder::queued() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _queued;
+}
+
+void PriorityTicketHolder::appendStats(BSONObjBuilder* b) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    b->append("out", _used);
+    b->append("available", std::max(_limit - _used, 0));
+    b->append("totalTickets", _limit);
+    if (_dynamicSizing) {
+        b->append("maxTickets", _maxTickets);
+    }
+
+    {
+        BSONObjBuilder queuedBuilder(b->subobjStart("queued"));
+        for (int i = 0; i < kNumPriorities; ++i) {
+            queuedBuilder.append(toString(static_cast<AdmissionPriority>(i)),
+                                 static_cast<int>(_queues[i].size()));
+        }
+    }
+
+    BSONObjBuilder histogramBuilder(b->subobjStart("queueTimes"));
+    long long totalCount = 0;
+    for (size_t i = 0; i < kNumQueueTimeBuckets; ++i) {
+        const std::string bucketName = i < kQueueTimeBucketBoundsMillis.size()
+            ? str::stream() << "lt" << kQueueTimeBucketBoundsMillis[i] << "ms"
+            : str::stream() << "gte" << kQueueTimeBucketBoundsMillis.back() << "ms";
+        histogramBuilder.appendNumber(bucketName, _queueTimeBuckets[i]);
+        totalCount += _queueTimeBuckets[i];
+    }
+    histogramBuilder.appendNumber("totalCount", totalCount);
+    histogramBuilder.appendNumber("totalQueueTimeMillis", _totalQueueTimeMillis);
+}
+
+void PriorityTicketHolder::_grantTickets_inlock() {
+    if (_queued == 0) {
+        return;
+    }
+
+    const Date_t now = _clockSource->now();
+    while (_queued > 0 && _used < _limit) {
+        auto& queue = _nextQueue_inlock(now);
+        Waiter* waiter = queue.front();
+        queue.pop_front();
+        --_queued;
+
+        ++_used;
+        waiter->granted = true;
+        waiter->cv.notify_one();
+    }
+}
+
+std::list<PriorityTicketHolder::Waiter*>& PriorityTicketHolder::_nextQueue_inlock(Date_t now) {
+    // Only the oldest waiter of each priority can be next. Its effective priority is its own plus
+    // one for every aging interval it has waited, without an upper bound, so that a low priority
+    // waiter eventually overtakes any stream of higher priority ones.
+    std::list<Waiter*>* next = nullptr;
+    long long nextEffectivePriority = 0;
+    for (auto& queue : _queues) {
+        if (queue.empty()) {
+            continue;
+        }
+
+        const Waiter* waiter = queue.front();
+        const long long effectivePriority = static_cast<int>(waiter->priority) +
+            durationCount<Milliseconds>(now - waiter->enqueuedAt) /
+                durationCount<Milliseconds>(_agingInterval);
+        if (!next || effectivePriority > nextEffectivePriority ||
+            (effectivePriority == nextEffectivePriority &&
+             waiter->enqueuedAt < next->front()->enqueuedAt)) {
+            next = &queue;
+            nextEffectivePriority = effectivePriority;
+        }
+    }
+
+    invariant(next);
+    return *next;
+}
+
+void PriorityTicketHolder::_recordQueueTime_inlock(Milliseconds queueTime) {
+    const auto millis = durationCount<Milliseconds>(queueTime);
+    const auto bucket = std::upper_bound(kQueueTimeBucketBoundsMillis.begin(),
+                                         kQueueTimeBucketBoundsMillis.end(),
+                                         millis) -
+        kQueueTimeBucketBoundsMillis.begin();
+    ++_queueTimeBuckets[bucket];
+    _totalQueueTimeMillis += millis;
+}
+
+void PriorityTicketHolder::_updateLimit_inlock() {
+    if (!_dynamicSizing) {
+        return;
+    }
+
+    ++_releasedInWindow;
+    if (_queued > 0) {
+        _saturatedInWindow = true;
+    }
+
+    const Date_t now = _clockSource->now();
+    const Milliseconds elapsed = now - _windowStart;
+    if (elapsed < kSizingWindow) {
+        return;
+    }
+
+    const double throughput =
+        static_cast<double>(_releasedInWindow) / durationCount<Milliseconds>(elapsed);
+
+    if (!_saturatedInWindow) {
+        // The limit wasn't what held operations back, so there is nothing to learn from this
+        // window, and its throughput can't be compared with that of a saturated one.
+        _lastAdjustmentWasDecrease = false;
+        _lastThroughput = 0;
+    } else {
+        // Don't cut the limit twice in a row, as a lower throughput is expected right after a
+        // decrease.
+        if (!_lastAdjustmentWasDecrease && _lastThroughput > 0 &&
+            throughput < _lastThroughput * (1 - kThroughputDropTolerance)) {
+            _limit = std::max(static_cast<int>(_limit * kLimitDecreaseFactor), _minTickets);
+            _lastAdjustmentWasDecrease = true;
+        } else {
+            _limit = std::min(_limit + 1, _maxTickets);
+            _lastAdjustmentWasDecrease = false;
+        }
+        _lastThroughput = throughput;
+    }
+
+    _windowStart = now;
+    _releasedInWindow = 0;
+    _saturatedInWindow = false;
+}
+
+}  // namespace mongo
@@ -0,0 +1,195 @@
+/*    Copyright 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <list>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ClockSource;
+
+/**
+ * The class of service an operation asks for when it queues for a ticket. Operations default to
+ * kNormal.
+ */
+enum class AdmissionPriority { kLow = 0, kNormal = 1, kHigh = 2 };
+
+StatusWith<AdmissionPriority> parseAdmissionPriority(StringData value);
+StringData toString(AdmissionPriority priority);
+
+/**
+ * A TicketHolder which, once all tickets are in use, hands released tickets to waiters by
+ * priority rather than in arrival order, so that latency sensitive operations don't queue behind
+ * batch work.
+ *
+ * To prevent starvation, a waiter's effective priority rises by one class for every
+ * 'agingInterval' it has spent queued, and waiters with the same effective priority are served
+ * oldest first.
+ *
+ * Optionally, the number of tickets handed out can be sized dynamically between a floor and the
+ * configured number of tickets, following the throughput observed while all tickets are in use
+ * (AIMD): the limit grows by one ticket per sizing window as long as throughput holds up, and is
+ * cut by a quarter when throughput drops.
+ */
+class PriorityTicketHolder {
+    MONGO_DISALLOW_COPYING(PriorityTicketHolder);
+
+public:
+    static constexpr int kNumPriorities = 3;
+    static const Milliseconds kDefaultAgingInterval;
+    static const Milliseconds kSizingWindow;
+
+    /**
+     * Number of buckets in the queue time histogram and their exclusive upper bounds. The last
+     * bucket counts every wait of kQueueTimeBucketBoundsMillis.back() or more.
+     */
+    static constexpr size_t kNumQueueTimeBuckets = 8;
+    static const std::array<int, kNumQueueTimeBuckets - 1> kQueueTimeBucketBoundsMillis;
+
+    explicit PriorityTicketHolder(int num,
+                                  ClockSource* clockSource = nullptr,
+                                  Milliseconds agingInterval = kDefaultAgingInterval);
+
+    /**
+     * Takes a ticket if one is available and nobody is queued for one.
+     */
+    bool tryAcquire();
+
+    void waitForTicket(AdmissionPriority priority = AdmissionPriority::kNormal);
+
+    bool waitForTicketUntil(Date_t until, AdmissionPriority priority = AdmissionPriority::kNormal);
+
+    void release();
+
+    /**
+     * Sets the number of tickets. Shrinking never blocks: if more tickets are in use than the new
+     * size, released tickets are not handed out again until usage has dropped below it.
+     */
+    Status resize(int newSize);
+
+    /**
+     * Turns dynamic sizing of the number of tickets handed out on or off. When turned off, the
+     * limit goes back to the configured number of tickets.
+     */
+    void setDynamicSizing(bool enabled, int minTickets);
+
+    /**
+     * Number of tickets which can currently be acquired without waiting.
+     */
+    int available() const;
+
+    int used() const;
+
+    /**
+     * The current limit on the number of tickets in use. Only differs from maxTickets() when
+     * dynamic sizing is enabled.
+     */
+    int outof() const;
+
+    /**
+     * The configured number of tickets.
+     */
+    int maxTickets() const;
+
+    /**
+     * Number of operations waiting for a ticket.
+     */
+    int queued() const;
+
+    /**
+     * Appends the ticket counts, the waiters per priority and a histogram of the time spent
+     * waiting for tickets.
+     */
+    void appendStats(BSONObjBuilder* b) const;
+
+private:
+    struct Waiter {
+        Waiter(AdmissionPriority priority, Date_t enqueuedAt)
+            : priority(priority), enqueuedAt(enqueuedAt) {}
+
+        const AdmissionPriority priority;
+        const Date_t enqueuedAt;
+        std::list<Waiter*>::iterator position;
+        bool granted = false;
+        stdx::condition_variable cv;
+    };
+
+    bool _acquire(AdmissionPriority priority, Date_t until);
+
+    /**
+     * Hands free tickets to the waiters, highest effective priority first.
+     */
+    void _grantTickets_inlock();
+
+    /**
+     * Returns the queue holding the waiter which should be granted the next ticket. Must only be
+     * called when there are waiters.
+     */
+    std::list<Waiter*>& _nextQueue_inlock(Date_t now);
+
+    void _recordQueueTime_inlock(Milliseconds queueTime);
+
+    /**
+     * Accounts for a released ticket and, at the end of each sizing window, adjusts the limit.
+     */
+    void _updateLimit_inlock();
+
+    ClockSource* const _clockSource;
+    const Milliseconds _agingInterval;
+
+    mutable stdx::mutex _mutex;
+
+    int _maxTickets;
+    int _limit;
+    int _used = 0;
+
+    std::array<std::list<Waiter*>, kNumPriorities> _queues;
+    int _queued = 0;
+
+    std::array<long long, kNumQueueTimeBuckets> _queueTimeBuckets{};
+    long long _totalQueueTimeMillis = 0;
+
+    bool _dynamicSizing = false;
+    int _minTickets = 1;
+    Date_t _windowStart;
+    long long _releasedInWindow = 0;
+    bool _saturatedInWindow = false;
+    bool _lastAdjustmentWasDecrease = false;
+    double _lastThroughput = 0;
+};
+
+}  // namespace mongo
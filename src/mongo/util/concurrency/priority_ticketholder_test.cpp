@@ -0,0 +1,242 @@
+/*    Copyright 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+#include "mongo/util/concurrency/priority_ticketholder.h"
+#include "mongo/util/time_support.h"
+
+namespace {
+using namespace mongo;
+
+/**
+ * Blocks until 'holder' has 'numQueued' waiters.
+ */
+void waitForQueued(const PriorityTicketHolder& holder, int numQueued) {
+    while (holder.queued() != numQueued) {
+        sleepmillis(1);
+    }
+}
+
+/**
+ * Starts a thread which waits for a ticket with 'priority', appends 'name' to 'order' once it
+ * has one, and then releases it.
+ */
+stdx::thread startWaiter(PriorityTicketHolder* holder,
+                         AdmissionPriority priority,
+                         std::string name,
+                         stdx::mutex* mutex,
+                         std::vector<std::string>* order) {
+    return stdx::thread([=] {
+        holder->waitForTicket(priority);
+        {
+            stdx::lock_guard<stdx::mutex> lk(*mutex);
+            order->push_back(name);
+        }
+        holder->release();
+    });
+}
+
+TEST(PriorityTicketHolderTest, BasicTimeout) {
+    PriorityTicketHolder holder(1);
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT_EQ(holder.available(), 1);
+    ASSERT_EQ(holder.outof(), 1);
+
+    ASSERT(holder.tryAcquire());
+    ASSERT_EQ(holder.used(), 1);
+    ASSERT_EQ(holder.available(), 0);
+
+    ASSERT_FALSE(holder.tryAcquire());
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now()));
+    ASSERT_FALSE(
+        holder.waitForTicketUntil(Date_t::now() + Milliseconds(5), AdmissionPriority::kHigh));
+    ASSERT_EQ(holder.queued(), 0);
+
+    holder.release();
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT(holder.waitForTicketUntil(Date_t::now() + Milliseconds(20)));
+    ASSERT_EQ(holder.used(), 1);
+    holder.release();
+}
+
+TEST(PriorityTicketHolderTest, HigherPriorityWaitersAreServedFirst) {
+    PriorityTicketHolder holder(1, nullptr, Hours(1));
+    stdx::mutex mutex;
+    std::vector<std::string> order;
+
+    ASSERT(holder.tryAcquire());
+
+    auto low = startWaiter(&holder, AdmissionPriority::kLow, "low", &mutex, &order);
+    waitForQueued(holder, 1);
+    auto normal = startWaiter(&holder, AdmissionPriority::kNormal, "normal", &mutex, &order);
+    waitForQueued(holder, 2);
+    auto high = startWaiter(&holder, AdmissionPriority::kHigh, "high", &mutex, &order);
+    waitForQueued(holder, 3);
+
+    // Nobody can jump the queue while there are waiters.
+    holder.release();
+    low.join();
+    normal.join();
+    high.join();
+
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT((std::vector<std::string>{"high", "normal", "low"}) == order);
+}
+
+TEST(PriorityTicketHolderTest, AgingPreventsStarvation) {
+    ClockSourceMock clock;
+    PriorityTicketHolder holder(1, &clock, Milliseconds(10));
+    stdx::mutex mutex;
+    std::vector<std::string> order;
+
+    ASSERT(holder.tryAcquire());
+
+    auto low = startWaiter(&holder, AdmissionPriority::kLow, "low", &mutex, &order);
+    waitForQueued(holder, 1);
+
+    // Having waited for three aging intervals, the low priority waiter ranks above a high
+    // priority one which has just arrived.
+    clock.advance(Milliseconds(30));
+    auto high = startWaiter(&holder, AdmissionPriority::kHigh, "high", &mutex, &order);
+    waitForQueued(holder, 2);
+
+    holder.release();
+    low.join();
+    high.join();
+
+    ASSERT((std::vector<std::string>{"low", "high"}) == order);
+}
+
+TEST(PriorityTicketHolderTest, ShrinkingBelowUsageDoesNotBlock) {
+    PriorityTicketHolder holder(2);
+    ASSERT(holder.tryAcquire());
+    ASSERT(holder.tryAcquire());
+
+    ASSERT_OK(holder.resize(1));
+    ASSERT_EQ(holder.outof(), 1);
+    ASSERT_EQ(holder.available(), 0);
+
+    holder.release();
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    ASSERT(holder.tryAcquire());
+    holder.release();
+
+    ASSERT_NOT_OK(holder.resize(0));
+}
+
+TEST(PriorityTicketHolderTest, DynamicSizingFollowsThroughput) {
+    ClockSourceMock clock;
+    PriorityTicketHolder holder(10, &clock);
+    holder.setDynamicSizing(true, 2);
+    ASSERT_EQ(holder.outof(), 10);
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    // A first saturated window only establishes the baseline throughput; the limit is already at
+    // its maximum.
+    stdx::thread first([&] { holder.waitForTicket(); });
+    waitForQueued(holder, 1);
+    clock.advance(PriorityTicketHolder::kSizingWindow);
+    holder.release();
+    first.join();
+    ASSERT_EQ(holder.outof(), 10);
+    ASSERT_EQ(holder.used(), 10);
+
+    // Throughput halves: the limit is cut by a quarter and the waiter stays queued.
+    stdx::thread second([&] { holder.waitForTicket(); });
+    waitForQueued(holder, 1);
+    clock.advance(PriorityTicketHolder::kSizingWindow * 2);
+    holder.release();
+    ASSERT_EQ(holder.outof(), 7);
+    ASSERT_EQ(holder.queued(), 1);
+
+    // After a decrease, the limit grows back one ticket per window.
+    clock.advance(PriorityTicketHolder::kSizingWindow);
+    holder.release();
+    ASSERT_EQ(holder.outof(), 8);
+    ASSERT_EQ(holder.used(), 8);
+    ASSERT_EQ(holder.queued(), 1);
+
+    holder.release();
+    second.join();
+    ASSERT_EQ(holder.used(), 8);
+
+    while (holder.used() > 0) {
+        holder.release();
+    }
+
+    BSONObjBuilder builder;
+    holder.appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["totalTickets"].numberInt(), 8);
+    ASSERT_EQ(stats["maxTickets"].numberInt(), 10);
+    ASSERT_EQ(stats["queueTimes"]["totalCount"].numberLong(), 12);
+}
+
+TEST(PriorityTicketHolderTest, QueueTimesAreRecorded) {
+    ClockSourceMock clock;
+    PriorityTicketHolder holder(1, &clock);
+
+    ASSERT(holder.tryAcquire());
+    stdx::thread waiter([&] { holder.waitForTicket(AdmissionPriority::kLow); });
+    waitForQueued(holder, 1);
+
+    clock.advance(Milliseconds(7));
+    holder.release();
+    waiter.join();
+    holder.release();
+
+    BSONObjBuilder builder;
+    holder.appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(stats["queued"]["low"].numberInt(), 0);
+    ASSERT_EQ(stats["queueTimes"]["lt1ms"].numberLong(), 1);
+    ASSERT_EQ(stats["queueTimes"]["lt10ms"].numberLong(), 1);
+    ASSERT_EQ(stats["queueTimes"]["totalCount"].numberLong(), 2);
+    ASSERT_EQ(stats["queueTimes"]["totalQueueTimeMillis"].numberLong(), 7);
+}
+
+TEST(PriorityTicketHolderTest, ParseAdmissionPriority) {
+    ASSERT(AdmissionPriority::kLow == unittest::assertGet(parseAdmissionPriority("low")));
+    ASSERT(AdmissionPriority::kNormal == unittest::assertGet(parseAdmissionPriority("normal")));
+    ASSERT(AdmissionPriority::kHigh == unittest::assertGet(parseAdmissionPriority("high")));
+    ASSERT_EQ(ErrorCodes::BadValue, parseAdmissionPriority("urgent").getStatus());
+}
+}  // namespace
@@ -46,6 +46,9 @@ struct OpMsg {
 
     static constexpr uint32_t kChecksumPresent = 1 << 0;
     static constexpr uint32_t kMoreToCome = 1 << 1;
+    // Set by a client on a getMore to allow the server to stream further batches as replies with
+    // kMoreToCome set, without waiting for another request. Optional, so older servers ignore it.
+    static constexpr uint32_t kExhaustAllowed = 1 << 16;
 
     /**
      * Returns the unvalidated flags for the given message if it is an OP_MSG message.